@@ -0,0 +1,324 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <utility>
+
+#include "config.h"
+
+namespace {
+
+std::atomic<uint64_t> allocation_count(0);
+std::atomic<uint64_t> allocation_bytes(0);
+
+void* counted_malloc(size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+	void* p = malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+} // anonymous namespace
+
+void* operator new(size_t size)
+{
+	return counted_malloc(size);
+}
+
+void* operator new[](size_t size)
+{
+	return counted_malloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+namespace Bench {
+
+namespace {
+
+std::vector<std::pair<std::string, SuiteFunction>>& suites()
+{
+	static std::vector<std::pair<std::string, SuiteFunction>> s;
+	return s;
+}
+
+std::string json_string(const std::string& s)
+{
+	std::string result = "\"";
+	for (const char c : s) {
+		switch (c) {
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char buf[8];
+				snprintf(buf,
+					sizeof(buf),
+					"\\u%04x",
+					static_cast<unsigned int>(c));
+				result += buf;
+			} else {
+				result += c;
+			}
+		}
+	}
+	return result + "\"";
+}
+
+void write_json(std::ostream& out,
+	const Options& opts,
+	const std::vector<Result>& results)
+{
+	char date[32];
+	const time_t now = time(nullptr);
+	struct tm stm;
+	gmtime_r(&now, &stm);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &stm);
+
+	out << "{\n";
+	out << "  \"version\": " << json_string(PROGRAM_VERSION) << ",\n";
+	out << "  \"date\": " << json_string(date) << ",\n";
+	out << "  \"options\": {\"feeds\": " << opts.feeds
+		<< ", \"items\": " << opts.items
+		<< ", \"content_size\": " << opts.content_size
+		<< ", \"iterations\": " << opts.iterations
+		<< ", \"seed\": " << opts.seed << "},\n";
+	out << "  \"results\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result& r = results[i];
+		std::vector<int64_t> samples = r.samples;
+		std::sort(samples.begin(), samples.end());
+		const int64_t total = std::accumulate(
+				samples.begin(), samples.end(), int64_t(0));
+		const int64_t mean = total / samples.size();
+		const int64_t median = samples[samples.size() / 2];
+
+		out << (i == 0 ? "\n" : ",\n");
+		out << "    {\"name\": " << json_string(r.name)
+			<< ", \"units\": " << r.units
+			<< ", \"iterations\": " << samples.size()
+			<< ", \"min_ns\": " << samples.front()
+			<< ", \"median_ns\": " << median
+			<< ", \"mean_ns\": " << mean
+			<< ", \"max_ns\": " << samples.back()
+			<< ", \"allocations\": " << r.allocations
+			<< ", \"allocated_bytes\": " << r.allocated_bytes
+			<< "}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+void print_usage(const char* argv0)
+{
+	std::cerr << "usage: " << argv0
+		<< " [-f feeds] [-i items] [-c content-size] [-n iterations]"
+		<< " [-s seed] [-o file] [suite...]\n"
+		<< "\n"
+		<< "Runs the benchmark suites whose names start with one of the\n"
+		<< "given prefixes (all of them if none are given) on synthetic\n"
+		<< "data and writes the timings as JSON to stdout or `file`.\n"
+		<< "`items` is the number of items per feed; `content-size` the\n"
+		<< "size of each item's HTML in bytes.\n"
+		<< "\n"
+		<< "Suites:";
+	for (const auto& suite : suites()) {
+		std::cerr << " " << suite.first;
+	}
+	std::cerr << std::endl;
+}
+
+bool parse_number(const char* arg, unsigned int& value)
+{
+	if (arg == nullptr) {
+		return false;
+	}
+	char* end = nullptr;
+	const long v = strtol(arg, &end, 10);
+	if (*arg == '\0' || *end != '\0' || v <= 0) {
+		return false;
+	}
+	value = v;
+	return true;
+}
+
+} // anonymous namespace
+
+Allocations allocations()
+{
+	return Allocations{
+		allocation_count.load(std::memory_order_relaxed),
+		allocation_bytes.load(std::memory_order_relaxed)};
+}
+
+Context::Context(const Options& options, const std::string& suite)
+	: opts(options)
+	, suite(suite)
+{
+}
+
+void Context::measure(const std::string& name,
+	uint64_t units,
+	const std::function<void()>& run)
+{
+	measure(name, units, [] {}, run);
+}
+
+void Context::measure(const std::string& name,
+	uint64_t units,
+	const std::function<void()>& setup,
+	const std::function<void()>& run)
+{
+	Result result;
+	result.name = suite + "/" + name;
+	result.units = units;
+
+	std::cerr << result.name << "..." << std::flush;
+	setup();
+	run();
+	for (unsigned int i = 0; i < opts.iterations; ++i) {
+		setup();
+		const Allocations before = allocations();
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		const auto end = std::chrono::steady_clock::now();
+		const Allocations after = allocations();
+		result.samples.push_back(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				end - start)
+			.count());
+		result.allocations += after.count - before.count;
+		result.allocated_bytes += after.bytes - before.bytes;
+	}
+	result.allocations /= opts.iterations;
+	result.allocated_bytes /= opts.iterations;
+	std::cerr << " "
+		<< *std::min_element(
+			result.samples.begin(), result.samples.end()) /
+		1000000.0
+		<< " ms" << std::endl;
+
+	res.push_back(std::move(result));
+}
+
+Registrar::Registrar(const char* name, SuiteFunction suite)
+{
+	suites().emplace_back(name, suite);
+}
+
+} // namespace Bench
+
+int main(int argc, char* argv[])
+{
+	using namespace Bench;
+
+	setlocale(LC_CTYPE, "");
+
+	Options opts;
+	std::string output;
+	std::vector<std::string> prefixes;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = true;
+		if (arg == "-f") {
+			ok = parse_number(value, opts.feeds);
+			++i;
+		} else if (arg == "-i") {
+			ok = parse_number(value, opts.items);
+			++i;
+		} else if (arg == "-c") {
+			ok = parse_number(value, opts.content_size);
+			++i;
+		} else if (arg == "-n") {
+			ok = parse_number(value, opts.iterations);
+			++i;
+		} else if (arg == "-s") {
+			ok = parse_number(value, opts.seed);
+			++i;
+		} else if (arg == "-o") {
+			ok = value != nullptr;
+			output = ok ? value : "";
+			++i;
+		} else if (arg == "-h" || arg == "--help") {
+			print_usage(argv[0]);
+			return EXIT_SUCCESS;
+		} else if (!arg.empty() && arg[0] == '-') {
+			ok = false;
+		} else {
+			prefixes.push_back(arg);
+		}
+
+		if (!ok) {
+			print_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// registration order depends on the linker, so make it predictable
+	std::sort(suites().begin(),
+		suites().end(),
+		[](const std::pair<std::string, SuiteFunction>& a,
+			const std::pair<std::string, SuiteFunction>& b) {
+			return a.first < b.first;
+		});
+
+	std::vector<Result> results;
+	for (const auto& suite : suites()) {
+		const bool selected = prefixes.empty() ||
+			std::any_of(prefixes.begin(),
+				prefixes.end(),
+				[&](const std::string& prefix) {
+					return suite.first.compare(
+						0, prefix.size(), prefix) == 0;
+				});
+		if (!selected) {
+			continue;
+		}
+
+		Context ctx(opts, suite.first);
+		suite.second(ctx);
+		results.insert(results.end(),
+			ctx.results().begin(),
+			ctx.results().end());
+	}
+
+	if (output.empty()) {
+		write_json(std::cout, opts, results);
+	} else {
+		std::ofstream out(output);
+		write_json(out, opts, results);
+		if (!out) {
+			std::cerr << "failed to write " << output << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+#ifndef NEWSBOAT_BENCH_H_
+#define NEWSBOAT_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+/// \brief Size of the synthetic data and number of runs, as set on the command
+/// line.
+struct Options {
+	unsigned int feeds = 20;
+	/// \brief Number of items in each feed.
+	unsigned int items = 500;
+	/// \brief Approximate size of each item's HTML content, in bytes.
+	unsigned int content_size = 2000;
+	/// \brief Number of timed runs of every benchmark (after a warm-up run).
+	unsigned int iterations = 10;
+	unsigned int seed = 1;
+};
+
+/// \brief Timings of a single benchmark, in nanoseconds.
+struct Result {
+	std::string name;
+	/// \brief Number of things (items, feeds, lines) processed in each run.
+	uint64_t units = 0;
+	std::vector<int64_t> samples;
+	/// \brief Calls to operator new in each run, averaged over the timed
+	/// runs.
+	uint64_t allocations = 0;
+	/// \brief Bytes asked for by those calls.
+	uint64_t allocated_bytes = 0;
+};
+
+/// \brief Calls to operator new and the bytes they asked for, counted since
+/// the program started. The bench binary replaces the global operator new
+/// to count them.
+struct Allocations {
+	uint64_t count;
+	uint64_t bytes;
+};
+
+Allocations allocations();
+
+/// \brief Handed to every suite; runs and times the benchmarks it defines.
+class Context {
+public:
+	Context(const Options& options, const std::string& suite);
+
+	const Options& options() const
+	{
+		return opts;
+	}
+
+	/// \brief Times \a run, which processes \a units things.
+	///
+	/// \a run is called once without being timed to warm caches up, then
+	/// options().iterations times. The result, including the number of
+	/// allocations \a run makes, is stored as "<suite>/<name>".
+	void measure(const std::string& name,
+		uint64_t units,
+		const std::function<void()>& run);
+
+	/// \brief Same as above, but calls \a setup before every run of \a run
+	/// without timing it.
+	void measure(const std::string& name,
+		uint64_t units,
+		const std::function<void()>& setup,
+		const std::function<void()>& run);
+
+	const std::vector<Result>& results() const
+	{
+		return res;
+	}
+
+private:
+	const Options& opts;
+	const std::string suite;
+	std::vector<Result> res;
+};
+
+using SuiteFunction = void (*)(Context&);
+
+/// \brief Adds a suite to the list that main() runs. Use BENCHMARK_SUITE
+/// rather than creating these directly.
+struct Registrar {
+	Registrar(const char* name, SuiteFunction suite);
+};
+
+} // namespace Bench
+
+#define BENCHMARK_SUITE_NAME2(prefix, line) prefix##line
+#define BENCHMARK_SUITE_NAME(prefix, line) BENCHMARK_SUITE_NAME2(prefix, line)
+
+/// Defines a suite of benchmarks. The body gets a Bench::Context called `ctx`.
+#define BENCHMARK_SUITE(name) \
+	static void BENCHMARK_SUITE_NAME(bench_suite_, __LINE__)( \
+		Bench::Context&); \
+	static const Bench::Registrar BENCHMARK_SUITE_NAME( \
+		bench_registrar_, __LINE__)( \
+		name, BENCHMARK_SUITE_NAME(bench_suite_, __LINE__)); \
+	static void BENCHMARK_SUITE_NAME(bench_suite_, __LINE__)( \
+		Bench::Context & ctx)
+
+#endif /* NEWSBOAT_BENCH_H_ */
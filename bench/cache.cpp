@@ -0,0 +1,68 @@
+#include "cache.h"
+
+#include <memory>
+
+#include "bench.h"
+#include "configcontainer.h"
+#include "datagen.h"
+#include "rss.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("cache")
+{
+	ConfigContainer cfg;
+	Cache datacache(":memory:", &cfg);
+	Bench::DataGenerator gen(ctx.options());
+	const auto feeds = gen.feeds(&datacache);
+	const uint64_t item_count =
+		uint64_t(ctx.options().feeds) * ctx.options().items;
+
+	std::unique_ptr<Cache> rsscache;
+	ctx.measure("externalize_rssfeed",
+		item_count,
+		[&] {
+			rsscache.reset();
+			rsscache.reset(new Cache(":memory:", &cfg));
+		},
+		[&] {
+			for (const auto& feed : feeds) {
+				rsscache->externalize_rssfeed(feed, false);
+			}
+		});
+
+	ctx.measure("externalize_rssfeed (unchanged)", item_count, [&] {
+		for (const auto& feed : feeds) {
+			rsscache->externalize_rssfeed(feed, false);
+		}
+	});
+
+	ctx.measure("internalize_rssfeed", item_count, [&] {
+		for (unsigned int i = 0; i < ctx.options().feeds; ++i) {
+			rsscache->internalize_rssfeed(
+				Bench::DataGenerator::feed_url(i), nullptr);
+		}
+	});
+
+	RssIgnores ignores;
+	ignores.handle_action("ignore-article", {"*", "title =~ \"kernel\""});
+	ignores.handle_action("ignore-article", {"*", "flags # \"a\""});
+	ctx.measure("internalize_rssfeed (with ignore-article)",
+		item_count,
+		[&] {
+			for (unsigned int i = 0; i < ctx.options().feeds; ++i) {
+				rsscache->internalize_rssfeed(
+					Bench::DataGenerator::feed_url(i), &ignores);
+			}
+		});
+
+	ctx.measure("search_for_items", item_count, [&] {
+		rsscache->search_for_items("security", "");
+	});
+
+	// what a search shows before the rest of the results come in
+	ctx.measure("search_for_items (first page)", item_count, [&] {
+		SearchPosition position;
+		rsscache->search_for_items("security", "", position, 100);
+	});
+}
@@ -0,0 +1,289 @@
+#include "datagen.h"
+
+#include <ctime>
+
+#include "dateparser.h"
+
+using namespace newsboat;
+
+namespace Bench {
+
+namespace {
+
+const std::vector<std::string> dictionary = {"the",
+		"of",
+		"and",
+		"feed",
+		"newsboat",
+		"article",
+		"release",
+		"kernel",
+		"update",
+		"security",
+		"performance",
+		"reader",
+		"terminal",
+		"podcast",
+		"weekly",
+		"review",
+		"announcement",
+		"database",
+		"compiler",
+		"network",
+		"caf\xc3\xa9",
+		"na\xc3\xafve",
+		"\xd0\xbd\xd0\xbe\xd0\xb2\xd0\xbe\xd1\x81\xd1\x82\xd0\xb8",
+		"\xe6\x96\xb0\xe8\x81\x9e",
+		"a",
+		"is",
+		"in",
+		"to",
+		"with",
+		"for"
+	};
+
+const std::vector<std::string> tags = {
+	"news", "tech", "linux", "podcasts", "blogs", "science", "music"
+};
+
+std::string xml_escape(const std::string& s)
+{
+	std::string result;
+	result.reserve(s.size());
+	for (const char c : s) {
+		switch (c) {
+		case '&':
+			result += "&amp;";
+			break;
+		case '<':
+			result += "&lt;";
+			break;
+		case '>':
+			result += "&gt;";
+			break;
+		case '"':
+			result += "&quot;";
+			break;
+		default:
+			result += c;
+		}
+	}
+	return result;
+}
+
+std::string w3cdtf_date(time_t t)
+{
+	char buf[32];
+	struct tm stm;
+	gmtime_r(&t, &stm);
+	strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &stm);
+	return buf;
+}
+
+} // anonymous namespace
+
+DataGenerator::DataGenerator(const Options& options)
+	: opts(options)
+	, rng(options.seed)
+{
+}
+
+unsigned int DataGenerator::random(unsigned int max)
+{
+	return std::uniform_int_distribution<unsigned int>(0, max - 1)(rng);
+}
+
+const std::string& DataGenerator::word()
+{
+	return dictionary[random(dictionary.size())];
+}
+
+std::string DataGenerator::words(unsigned int count)
+{
+	std::string result;
+	for (unsigned int i = 0; i < count; ++i) {
+		if (i > 0) {
+			result += ' ';
+		}
+		result += word();
+	}
+	return result;
+}
+
+std::string DataGenerator::html(unsigned int size)
+{
+	std::string result;
+	unsigned int n = 0;
+	while (result.size() < size) {
+		switch (n++ % 8) {
+		case 2:
+			result += "<ul><li>" + words(4) + "</li><li>" + words(6) +
+				"</li><li><b>" + words(2) + "</b></li></ul>";
+			break;
+		case 4:
+			result += "<pre>" + words(5) + "\n  " + words(5) + "\n  " +
+				words(3) + "</pre>";
+			break;
+		case 6:
+			result += "<table><tr><th>" + words(1) + "</th><th>" +
+				words(1) + "</th></tr><tr><td>" + words(3) +
+				"</td><td>" + words(2) + "</td></tr></table>";
+			break;
+		default:
+			result += "<p>" + words(12) + " <a href=\"http://example.com/" +
+				std::to_string(random(100000)) + "\">" +
+				words(3) + "</a> " + words(10) + ", <em>" +
+				words(2) + "</em>&amp;" + words(14) + ".</p>";
+		}
+		result += "\n";
+	}
+	return result;
+}
+
+std::string DataGenerator::feed_xml(rsspp::Version format)
+{
+	const time_t now = time(nullptr);
+	std::string xml;
+
+	switch (format) {
+	case rsspp::RSS_0_91:
+	case rsspp::RSS_0_92:
+	case rsspp::RSS_2_0:
+		xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<rss version=\"" +
+			std::string(format == rsspp::RSS_0_91
+				? "0.91"
+				: format == rsspp::RSS_0_92 ? "0.92" : "2.0") +
+			"\" xmlns:content=\"http://purl.org/rss/1.0/modules/"
+			"content/\">\n<channel>\n"
+			"<title>" + xml_escape(words(3)) + "</title>\n"
+			"<link>http://example.com/</link>\n"
+			"<description>" + xml_escape(words(8)) + "</description>\n";
+		break;
+	case rsspp::RSS_1_0:
+		xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<rdf:RDF "
+			"xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\" "
+			"xmlns:dc=\"http://purl.org/dc/elements/1.1/\" "
+			"xmlns=\"http://purl.org/rss/1.0/\">\n<channel>\n"
+			"<title>" + xml_escape(words(3)) + "</title>\n"
+			"<link>http://example.com/</link>\n"
+			"<description>" + xml_escape(words(8)) + "</description>\n"
+			"</channel>\n";
+		break;
+	case rsspp::ATOM_1_0:
+		xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<feed xmlns=\"http://www.w3.org/2005/Atom\">\n"
+			"<title type=\"text\">" + xml_escape(words(3)) + "</title>\n"
+			"<id>http://example.com/</id>\n"
+			"<updated>" + w3cdtf_date(now) + "</updated>\n"
+			"<link rel=\"alternate\" type=\"text/html\" "
+			"href=\"http://example.com/\" />\n";
+		break;
+	default:
+		return "";
+	}
+
+	for (unsigned int i = 0; i < opts.items; ++i) {
+		const std::string link =
+			"http://example.com/" + std::to_string(i) + ".html";
+		const std::string title = xml_escape(words(3 + random(6)));
+		const std::string content = xml_escape(html(opts.content_size));
+		const time_t date = now - random(60 * 86400);
+
+		switch (format) {
+		case rsspp::RSS_0_91:
+		case rsspp::RSS_0_92:
+		case rsspp::RSS_2_0:
+			xml += "<item>\n<title>" + title + "</title>\n"
+				"<link>" + link + "</link>\n"
+				"<guid>" + link + "</guid>\n"
+				"<author>" + xml_escape(words(2)) + "</author>\n"
+				"<pubDate>" + rsspp::format_rfc822_date(date) +
+				"</pubDate>\n"
+				"<description>" + content + "</description>\n";
+			if (format == rsspp::RSS_2_0) {
+				xml += "<content:encoded>" + content +
+					"</content:encoded>\n";
+			}
+			xml += "</item>\n";
+			break;
+		case rsspp::RSS_1_0:
+			xml += "<item rdf:about=\"" + link + "\">\n"
+				"<title>" + title + "</title>\n"
+				"<link>" + link + "</link>\n"
+				"<dc:creator>" + xml_escape(words(2)) +
+				"</dc:creator>\n"
+				"<dc:date>" + w3cdtf_date(date) + "</dc:date>\n"
+				"<description>" + content + "</description>\n"
+				"</item>\n";
+			break;
+		default:
+			xml += "<entry>\n<title type=\"html\">" + title +
+				"</title>\n"
+				"<link rel=\"alternate\" type=\"text/html\" href=\"" +
+				link + "\" />\n"
+				"<id>" + link + "</id>\n"
+				"<author><name>" + xml_escape(words(2)) +
+				"</name></author>\n"
+				"<updated>" + w3cdtf_date(date) + "</updated>\n"
+				"<content type=\"html\">" + content + "</content>\n"
+				"</entry>\n";
+		}
+	}
+
+	switch (format) {
+	case rsspp::RSS_1_0:
+		xml += "</rdf:RDF>\n";
+		break;
+	case rsspp::ATOM_1_0:
+		xml += "</feed>\n";
+		break;
+	default:
+		xml += "</channel>\n</rss>\n";
+	}
+	return xml;
+}
+
+std::vector<std::shared_ptr<RssFeed>> DataGenerator::feeds(Cache* cache)
+{
+	const time_t now = time(nullptr);
+	std::vector<std::shared_ptr<RssFeed>> result;
+
+	for (unsigned int f = 0; f < opts.feeds; ++f) {
+		auto feed = std::make_shared<RssFeed>(cache);
+		feed->set_rssurl(feed_url(f));
+		feed->set_link("http://example.com/" + std::to_string(f) + "/");
+		feed->set_title(words(2 + random(4)));
+		feed->set_tags({tags[random(tags.size())], tags[random(tags.size())]});
+
+		for (unsigned int i = 0; i < opts.items; ++i) {
+			auto item = std::make_shared<RssItem>(cache);
+			const std::string link = "http://example.com/" +
+				std::to_string(f) + "/" + std::to_string(i) +
+				".html";
+			item->set_title(words(3 + random(6)));
+			item->set_link(link);
+			item->set_guid(link);
+			item->set_author(words(2));
+			item->set_description(html(opts.content_size));
+			item->set_pubDate(now - random(60 * 86400));
+			item->set_unread_nowrite(random(4) == 0);
+			if (random(10) == 0) {
+				item->set_flags(std::string(1, 'a' + random(3)));
+			}
+			item->set_feedurl(feed->rssurl());
+			item->set_feedptr(feed);
+			feed->add_item(item);
+		}
+		result.push_back(feed);
+	}
+	return result;
+}
+
+std::string DataGenerator::feed_url(unsigned int n)
+{
+	return "http://example.com/" + std::to_string(n) + "/feed.xml";
+}
+
+} // namespace Bench
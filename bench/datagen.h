@@ -0,0 +1,55 @@
+#ifndef NEWSBOAT_BENCH_DATAGEN_H_
+#define NEWSBOAT_BENCH_DATAGEN_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "rss.h"
+#include "rsspp.h"
+
+namespace Bench {
+
+/// \brief Produces feeds, items and documents for benchmarks.
+///
+/// Everything is derived from Options::seed, so the same options always give
+/// the same data.
+class DataGenerator {
+public:
+	explicit DataGenerator(const Options& options);
+
+	/// \brief \a count words separated by single spaces.
+	std::string words(unsigned int count);
+
+	/// \brief An HTML document of about \a size bytes, with paragraphs,
+	/// links, emphasis, lists, preformatted text and a table.
+	std::string html(unsigned int size);
+
+	/// \brief A feed with Options::items items, in the given \a format
+	/// (RSS 0.91, 0.92, 1.0, 2.0 or Atom 1.0).
+	std::string feed_xml(rsspp::Version format);
+
+	/// \brief Options::feeds feeds with Options::items items each.
+	///
+	/// Feeds have URLs, titles and a few tags; items have a title, link,
+	/// author, GUID, HTML description of about Options::content_size bytes,
+	/// a date within the last 60 days, and random unread status and flags.
+	std::vector<std::shared_ptr<newsboat::RssFeed>> feeds(
+		newsboat::Cache* cache);
+
+	/// \brief The URL of the \a n-th feed returned by feeds().
+	static std::string feed_url(unsigned int n);
+
+private:
+	unsigned int random(unsigned int max);
+	const std::string& word();
+
+	const Options& opts;
+	std::mt19937 rng;
+};
+
+} // namespace Bench
+
+#endif /* NEWSBOAT_BENCH_DATAGEN_H_ */
@@ -0,0 +1,37 @@
+#include "feedcontainer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "cache.h"
+#include "configcontainer.h"
+#include "datagen.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("feedcontainer")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	Bench::DataGenerator gen(ctx.options());
+	const auto feeds = gen.feeds(&rsscache);
+
+	const std::vector<std::pair<std::string, FeedSortMethod>> methods = {
+		{"firsttag", FeedSortMethod::FIRST_TAG},
+		{"title", FeedSortMethod::TITLE},
+		{"articlecount", FeedSortMethod::ARTICLE_COUNT},
+		{"unreadarticlecount", FeedSortMethod::UNREAD_ARTICLE_COUNT},
+		{"lastupdated", FeedSortMethod::LAST_UPDATED},
+	};
+
+	FeedContainer container;
+	for (const auto& method : methods) {
+		const FeedSortStrategy strategy{method.second, SortDirection::DESC};
+		ctx.measure("sort_feeds: " + method.first,
+			feeds.size(),
+			[&] { container.set_feeds(feeds); },
+			[&] { container.sort_feeds(strategy); });
+	}
+}
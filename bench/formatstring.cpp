@@ -0,0 +1,70 @@
+#include "formatstring.h"
+
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "datagen.h"
+
+using namespace newsboat;
+
+namespace {
+
+struct Line {
+	std::string index;
+	std::string flags;
+	std::string date;
+	std::string length;
+	std::string feedtitle;
+	std::string title;
+};
+
+} // anonymous namespace
+
+BENCHMARK_SUITE("formatstring")
+{
+	Bench::DataGenerator gen(ctx.options());
+	std::vector<Line> lines;
+	const unsigned int count = ctx.options().feeds * ctx.options().items;
+	for (unsigned int i = 0; i < count; ++i) {
+		Line line;
+		line.index = std::to_string(i + 1);
+		line.flags = i % 3 == 0 ? "N " : "  ";
+		line.date = "Jan " + std::to_string(1 + i % 28);
+		line.length = std::to_string(i % 5000) + "K";
+		line.feedtitle = i % 2 == 0 ? gen.words(3) : "";
+		line.title = gen.words(8);
+		lines.push_back(line);
+	}
+
+	// the default `articlelist-format`
+	const std::string format = "%4i %f %D %6L  %?T?|%-17T|  &?%t";
+	const unsigned int width = 120;
+
+	ctx.measure("FmtStrFormatter::do_format", lines.size(), [&] {
+		for (const auto& line : lines) {
+			FmtStrFormatter fmt;
+			fmt.register_fmt('i', line.index);
+			fmt.register_fmt('f', line.flags);
+			fmt.register_fmt('D', line.date);
+			fmt.register_fmt('L', line.length);
+			fmt.register_fmt('T', line.feedtitle);
+			fmt.register_fmt('t', line.title);
+			fmt.do_format(format, width);
+		}
+	});
+
+	ctx.measure("FmtStrTemplate::format", lines.size(), [&] {
+		const FmtStrTemplate tmpl(format);
+		FmtStrTemplate::Values values;
+		for (const auto& line : lines) {
+			values['i'] = line.index;
+			values['f'] = line.flags;
+			values['D'] = line.date;
+			values['L'] = line.length;
+			values['T'] = line.feedtitle;
+			values['t'] = line.title;
+			tmpl.format(values, width);
+		}
+	});
+}
@@ -0,0 +1,90 @@
+#include "htmlrenderer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "datagen.h"
+#include "rsspp.h"
+
+using namespace newsboat;
+
+namespace {
+
+void render_all(const std::vector<std::string>& documents, bool raw)
+{
+	for (const auto& document : documents) {
+		// a new renderer per document, like RssParser does for titles
+		HtmlRenderer r(raw);
+		std::vector<std::pair<LineType, std::string>> lines;
+		std::vector<LinkPair> links;
+		r.render(document, lines, links, "http://example.com/");
+	}
+}
+
+} // anonymous namespace
+
+BENCHMARK_SUITE("htmlrenderer")
+{
+	Bench::DataGenerator gen(ctx.options());
+	std::vector<std::string> documents;
+	for (unsigned int i = 0; i < ctx.options().items; ++i) {
+		documents.push_back(gen.html(ctx.options().content_size));
+	}
+
+	ctx.measure("render", documents.size(), [&] {
+		HtmlRenderer r;
+		for (const auto& document : documents) {
+			std::vector<std::pair<LineType, std::string>> lines;
+			std::vector<LinkPair> links;
+			r.render(document, lines, links, "http://example.com/");
+		}
+	});
+
+	// The feeds the tests use: small, real-world documents, where setting
+	// up the renderer and looking up tags matter as much as the text.
+	const std::vector<std::string> corpus_files = {
+		"rss.xml",
+		"rss091_1.xml",
+		"rss092_1.xml",
+		"rss10_1.xml",
+		"rss20_1.xml",
+		"atom10_1.xml",
+		"items_without_titles.xml",
+		"rss20_without_guids.xml",
+	};
+	std::vector<std::string> descriptions;
+	std::vector<std::string> titles;
+	for (const auto& file : corpus_files) {
+		try {
+			rsspp::Parser p;
+			const auto feed = p.parse_file("test/data/" + file);
+			for (const auto& item : feed.items) {
+				descriptions.push_back(item.description);
+				titles.push_back(item.title);
+			}
+		} catch (const rsspp::Exception&) {
+			// not run from the source tree
+		}
+	}
+	if (descriptions.empty()) {
+		return;
+	}
+
+	const unsigned int rounds = 1000;
+
+	ctx.measure("render test/data descriptions",
+		rounds * descriptions.size(),
+		[&] {
+			for (unsigned int i = 0; i < rounds; ++i) {
+				render_all(descriptions, false);
+			}
+		});
+
+	ctx.measure("render test/data titles", rounds * titles.size(), [&] {
+		for (unsigned int i = 0; i < rounds; ++i) {
+			render_all(titles, true);
+		}
+	});
+}
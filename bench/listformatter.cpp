@@ -0,0 +1,46 @@
+#include "listformatter.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "datagen.h"
+#include "regexmanager.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("listformatter")
+{
+	Bench::DataGenerator gen(ctx.options());
+	std::vector<std::string> lines;
+	const unsigned int count = ctx.options().feeds * ctx.options().items;
+	for (unsigned int i = 0; i < count; ++i) {
+		char prefix[32];
+		snprintf(prefix, sizeof(prefix), "%5u N  Jan %02u   ", i, i % 28);
+		lines.push_back(prefix + gen.words(6));
+	}
+
+	ctx.measure("format_list", lines.size(), [&] {
+		ListFormatter fmt;
+		fmt.add_lines(lines);
+		fmt.format_list();
+	});
+
+	RegexManager rxman;
+	rxman.handle_action("highlight", {"articlelist", "kernel", "red"});
+	rxman.handle_action(
+		"highlight", {"articlelist", "security|release", "green"});
+	rxman.handle_action("highlight", {"articlelist", "^ *[0-9]+ N", "blue"});
+	ctx.measure("format_list (with highlight)", lines.size(), [&] {
+		ListFormatter fmt;
+		fmt.add_lines(lines);
+		fmt.format_list(&rxman, "articlelist");
+	});
+
+	const std::string long_line = gen.words(20000).substr(0, 100 * 1024);
+	ctx.measure("add_line (100 KB line)", 1, [&] {
+		ListFormatter fmt;
+		fmt.add_line(long_line, UINT_MAX, 80);
+	});
+}
@@ -0,0 +1,465 @@
+#!/usr/bin/env python3
+"""Reload load test for newsboat.
+
+Starts a local HTTP server that serves thousands of generated RSS and Atom
+feeds, points a throwaway newsboat configuration at it and runs
+`newsboat -x reload` a few times. Reports wall and CPU time, peak memory, cache
+growth, what the server saw, and the time spent in each stage of the reload
+(as logged by ScopeMeasure).
+
+The server can be told to be slow (latency, limited bandwidth) and unreliable
+(errors, 503 with Retry-After), and to serve some feeds gzipped, behind
+redirects, or without support for conditional requests. Feeds change between
+runs at a configurable rate; unchanged feeds answer conditional requests with
+304 Not Modified.
+
+Everything is derived from --seed, so runs with the same options are
+comparable. See `loadtest.py --help` for the knobs, and `make loadtest`.
+"""
+
+import argparse
+import email.utils
+import gzip
+import hashlib
+import http.server
+import json
+import os
+import random
+import re
+import shutil
+import socketserver
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+WORDS = (
+    "the of and feed newsboat article release kernel update security "
+    "performance reader terminal podcast weekly review announcement database "
+    "compiler network café naïve новости 新聞 a is in to with for"
+).split()
+
+FORMATS = ("rss20", "atom10", "rss10", "rss091")
+
+BASE_DATE = 1500000000
+
+
+def fraction(value):
+    """argparse type for rates between 0 and 1."""
+    f = float(value)
+    if not 0.0 <= f <= 1.0:
+        raise argparse.ArgumentTypeError("must be between 0 and 1")
+    return f
+
+
+def chance(seed, *key):
+    """A number in [0, 1) that only depends on the seed and the key."""
+    digest = hashlib.sha1(repr((seed,) + key).encode()).digest()
+    return int.from_bytes(digest[:8], "big") / 2.0**64
+
+
+def xml_escape(text):
+    return (text.replace("&", "&amp;").replace("<", "&lt;")
+            .replace(">", "&gt;").replace('"', "&quot;"))
+
+
+class FeedFarm:
+    """Generates the feeds and decides how the server treats each of them."""
+
+    def __init__(self, opts):
+        self.opts = opts
+        self.run = 0
+        rng = random.Random(opts.seed)
+        self.paragraphs = [
+            "<p>" + " ".join(rng.choice(WORDS) for _ in range(40)) +
+            ' <a href="http://example.com/%d">link</a></p>' % i
+            for i in range(64)
+        ]
+        self.cache = {}
+        self.lock = threading.Lock()
+
+    def is_(self, what, feed, rate):
+        return chance(self.opts.seed, what, feed) < rate
+
+    def version(self, feed):
+        """How many times the feed changed up to the current run."""
+        return sum(1 for run in range(1, self.run + 1)
+                   if chance(self.opts.seed, "change", feed, run) <
+                   self.opts.change_rate)
+
+    def url(self, base, feed):
+        if self.is_("redirect", feed, self.opts.redirect_rate):
+            return "%s/redirect/%d" % (base, feed)
+        return "%s/feed/%d" % (base, feed)
+
+    def body(self, feed, version):
+        key = (feed, version)
+        with self.lock:
+            if key in self.cache:
+                return self.cache[key]
+
+        rng = random.Random("%d-%d-%d" % (self.opts.seed, feed, version))
+        fmt = FORMATS[feed % len(FORMATS)]
+        # every change adds a few items at the top
+        first = version * 3
+        items = []
+        for n in range(first + self.opts.items - 1, first - 1, -1):
+            content = ""
+            while len(content) < self.opts.content_size:
+                content += rng.choice(self.paragraphs)
+            items.append({
+                "title": " ".join(rng.choice(WORDS)
+                                  for _ in range(rng.randint(3, 8))),
+                "link": "http://example.com/%d/%d.html" % (feed, n),
+                "date": BASE_DATE + n * 3600,
+                "content": xml_escape(content),
+            })
+        body = render_feed(fmt, feed, items).encode("utf-8")
+
+        with self.lock:
+            if len(self.cache) > 4 * self.opts.feeds:
+                self.cache.clear()
+            self.cache[key] = body
+        return body
+
+
+def rfc822(timestamp):
+    return email.utils.formatdate(timestamp, usegmt=True)
+
+
+def w3cdtf(timestamp):
+    return time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime(timestamp))
+
+
+def render_feed(fmt, feed, items):
+    title = "Feed number %d" % feed
+    out = ['<?xml version="1.0" encoding="UTF-8"?>\n']
+    if fmt == "atom10":
+        out.append('<feed xmlns="http://www.w3.org/2005/Atom">\n'
+                   '<title>%s</title>\n<id>urn:feed:%d</id>\n'
+                   '<updated>%s</updated>\n' %
+                   (title, feed, w3cdtf(items[0]["date"])))
+        for item in items:
+            out.append('<entry><title>%(title)s</title>'
+                       '<link rel="alternate" href="%(link)s"/>'
+                       '<id>%(link)s</id><updated>%(date)s</updated>'
+                       '<author><name>Someone</name></author>'
+                       '<content type="html">%(content)s</content>'
+                       '</entry>\n' % dict(item, date=w3cdtf(item["date"])))
+        out.append("</feed>\n")
+    elif fmt == "rss10":
+        out.append('<rdf:RDF '
+                   'xmlns:rdf="http://www.w3.org/1999/02/22-rdf-syntax-ns#" '
+                   'xmlns:dc="http://purl.org/dc/elements/1.1/" '
+                   'xmlns="http://purl.org/rss/1.0/">\n'
+                   '<channel><title>%s</title>'
+                   '<link>http://example.com/%d/</link>'
+                   '<description>test</description></channel>\n' %
+                   (title, feed))
+        for item in items:
+            out.append('<item rdf:about="%(link)s"><title>%(title)s</title>'
+                       '<link>%(link)s</link><dc:date>%(date)s</dc:date>'
+                       '<description>%(content)s</description></item>\n' %
+                       dict(item, date=w3cdtf(item["date"])))
+        out.append("</rdf:RDF>\n")
+    else:
+        version = "2.0" if fmt == "rss20" else "0.91"
+        out.append('<rss version="%s"><channel><title>%s</title>'
+                   '<link>http://example.com/%d/</link>'
+                   '<description>test</description>\n' %
+                   (version, title, feed))
+        for item in items:
+            out.append('<item><title>%(title)s</title><link>%(link)s</link>'
+                       '<guid>%(link)s</guid><pubDate>%(date)s</pubDate>'
+                       '<description>%(content)s</description></item>\n' %
+                       dict(item, date=rfc822(item["date"])))
+        out.append("</channel></rss>\n")
+    return "".join(out)
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.reset()
+
+    def reset(self):
+        self.requests = 0
+        self.bytes = 0
+        self.statuses = {}
+        self.gzipped = 0
+
+    def add(self, status, sent, gzipped):
+        with self.lock:
+            self.requests += 1
+            self.bytes += sent
+            self.statuses[str(status)] = self.statuses.get(str(status), 0) + 1
+            self.gzipped += 1 if gzipped else 0
+
+    def snapshot(self):
+        with self.lock:
+            return {
+                "requests": self.requests,
+                "bytes_sent": self.bytes,
+                "statuses": dict(sorted(self.statuses.items())),
+                "gzipped": self.gzipped,
+            }
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, *args):
+        pass
+
+    def send(self, status, headers=(), body=b"", gzipped=False):
+        opts = self.server.opts
+        if opts.latency > 0:
+            jitter = random.uniform(-0.5, 0.5) * opts.latency
+            time.sleep((opts.latency + jitter) / 1000.0)
+
+        self.send_response(status)
+        for name, value in headers:
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+
+        if body and self.command != "HEAD":
+            if opts.bandwidth > 0:
+                chunk = max(1, opts.bandwidth * 1024 // 20)
+                for start in range(0, len(body), chunk):
+                    self.wfile.write(body[start:start + chunk])
+                    time.sleep(0.05)
+            else:
+                self.wfile.write(body)
+        self.server.stats.add(status, len(body), gzipped)
+
+    def do_GET(self):
+        farm = self.server.farm
+        opts = self.server.opts
+        match = re.match(r"^/(feed|redirect)/(\d+)$", self.path)
+        if not match or int(match.group(2)) >= opts.feeds:
+            self.send(404)
+            return
+        feed = int(match.group(2))
+        if match.group(1) == "redirect":
+            self.send(301, [("Location", "/feed/%d" % feed)])
+            return
+
+        with self.server.attempts_lock:
+            key = (farm.run, feed)
+            attempt = self.server.attempts.get(key, 0)
+            self.server.attempts[key] = attempt + 1
+        if chance(opts.seed, "retry-after", feed, farm.run, attempt) < \
+                opts.retry_after_rate:
+            self.send(503, [("Retry-After", str(opts.retry_after))])
+            return
+        if chance(opts.seed, "fail", feed, farm.run, attempt) < \
+                opts.failure_rate:
+            self.send(500)
+            return
+
+        version = farm.version(feed)
+        etag = '"%d-%d"' % (feed, version)
+        last_modified = rfc822(BASE_DATE + feed + version * 86400)
+        headers = [("Content-Type", "application/xml; charset=utf-8")]
+        if not farm.is_("unconditional", feed, opts.unconditional_rate):
+            headers += [("ETag", etag), ("Last-Modified", last_modified)]
+            if_none_match = self.headers.get("If-None-Match")
+            if_modified_since = self.headers.get("If-Modified-Since")
+            if (if_none_match == etag or
+                    (if_none_match is None and
+                     if_modified_since == last_modified)):
+                self.send(304, headers)
+                return
+
+        body = farm.body(feed, version)
+        gzipped = False
+        if (farm.is_("gzip", feed, opts.gzip_rate) and
+                "gzip" in self.headers.get("Accept-Encoding", "")):
+            body = gzip.compress(body, 6)
+            headers.append(("Content-Encoding", "gzip"))
+            gzipped = True
+        self.send(200, headers, body, gzipped)
+
+    do_HEAD = do_GET
+
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+    request_queue_size = 128
+
+
+def database_size(path):
+    return sum(os.path.getsize(p) for p in (path, path + "-wal")
+               if os.path.exists(p))
+
+
+def stage_timings(logfile):
+    """Sums up the ScopeMeasure lines of a newsboat log."""
+    pattern = re.compile(r"ScopeMeasure: function `([^']+)' took (\d+\.\d+) s")
+    stages = {}
+    with open(logfile, encoding="utf-8", errors="replace") as log:
+        for line in log:
+            match = pattern.search(line)
+            if not match:
+                continue
+            seconds = float(match.group(2))
+            stage = stages.setdefault(match.group(1),
+                                      {"count": 0, "total_s": 0.0,
+                                       "max_s": 0.0})
+            stage["count"] += 1
+            stage["total_s"] += seconds
+            stage["max_s"] = max(stage["max_s"], seconds)
+    return dict(sorted(stages.items(), key=lambda s: -s[1]["total_s"]))
+
+
+def run_newsboat(opts, workdir, run):
+    cache = os.path.join(workdir, "cache.db")
+    logfile = os.path.join(workdir, "run%d.log" % run)
+    env = dict(os.environ, HOME=workdir, XDG_CONFIG_HOME=workdir,
+               XDG_DATA_HOME=workdir)
+    command = [opts.newsboat,
+               "-u", os.path.join(workdir, "urls"),
+               "-C", os.path.join(workdir, "config"),
+               "-c", cache,
+               "-x", "reload",
+               "-d", logfile, "-l", "5"]
+
+    size_before = database_size(cache)
+    start = time.monotonic()
+    with open(os.path.join(workdir, "run%d.out" % run), "w") as out:
+        process = subprocess.Popen(command, stdout=out, stderr=out, env=env)
+        # wait4() rather than wait() to get the child's resource usage;
+        # tell Popen that the child is gone so it doesn't wait again
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = status
+    wall = time.monotonic() - start
+
+    exit_status = (os.WEXITSTATUS(status) if os.WIFEXITED(status)
+                   else -os.WTERMSIG(status))
+    return {
+        "run": run,
+        "exit_status": exit_status,
+        "wall_s": round(wall, 3),
+        "user_s": round(usage.ru_utime, 3),
+        "system_s": round(usage.ru_stime, 3),
+        "peak_rss_kib": usage.ru_maxrss,
+        "db_size_before": size_before,
+        "db_size_after": database_size(cache),
+        "stages": stage_timings(logfile) if os.path.exists(logfile) else {},
+    }
+
+
+def print_report(result, out):
+    for run in result["runs"]:
+        server = run["server"]
+        print("run %d: %.2f s wall, %.2f s user, %.2f s system, "
+              "peak RSS %.1f MiB, exit status %d" %
+              (run["run"], run["wall_s"], run["user_s"], run["system_s"],
+               run["peak_rss_kib"] / 1024.0, run["exit_status"]), file=out)
+        print("  cache: %d -> %d bytes" %
+              (run["db_size_before"], run["db_size_after"]), file=out)
+        print("  server: %d requests, %d bytes, %d gzipped, statuses %s" %
+              (server["requests"], server["bytes_sent"], server["gzipped"],
+               " ".join("%s:%d" % s for s in server["statuses"].items())),
+              file=out)
+        for name, stage in run["stages"].items():
+            print("  %-40s %6d x %9.3f s total %8.3f s max" %
+                  (name, stage["count"], stage["total_s"], stage["max_s"]),
+                  file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Runs `newsboat -x reload` against a local feed farm.")
+    parser.add_argument("--newsboat", default="./newsboat",
+                        help="newsboat binary (default: %(default)s)")
+    parser.add_argument("--feeds", type=int, default=2000)
+    parser.add_argument("--items", type=int, default=30,
+                        help="items per feed")
+    parser.add_argument("--content-size", type=int, default=2000,
+                        help="bytes of HTML per item")
+    parser.add_argument("--runs", type=int, default=3,
+                        help="reloads to run; the first one fills the cache")
+    parser.add_argument("--reload-threads", type=int, default=8)
+    parser.add_argument("--change-rate", type=fraction, default=0.2,
+                        help="share of feeds that get new items between runs")
+    parser.add_argument("--latency", type=int, default=50,
+                        help="mean response latency in ms")
+    parser.add_argument("--bandwidth", type=int, default=0,
+                        help="per-response bandwidth in KiB/s (0: no limit)")
+    parser.add_argument("--failure-rate", type=fraction, default=0.02,
+                        help="share of requests answered with 500")
+    parser.add_argument("--retry-after-rate", type=fraction, default=0.01,
+                        help="share of requests answered with 503 and "
+                        "Retry-After")
+    parser.add_argument("--retry-after", type=int, default=120,
+                        help="seconds sent in Retry-After")
+    parser.add_argument("--unconditional-rate", type=fraction, default=0.1,
+                        help="share of feeds without ETag and Last-Modified")
+    parser.add_argument("--gzip-rate", type=fraction, default=0.5,
+                        help="share of feeds served gzipped")
+    parser.add_argument("--redirect-rate", type=fraction, default=0.05,
+                        help="share of feeds behind a 301 redirect")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--workdir",
+                        help="keep config, cache and logs here instead of a "
+                        "temporary directory")
+    parser.add_argument("--json", metavar="FILE",
+                        help="also write the results to FILE as JSON")
+    opts = parser.parse_args()
+
+    if not os.access(opts.newsboat, os.X_OK):
+        parser.error("can't execute %s; build it first" % opts.newsboat)
+    opts.newsboat = os.path.abspath(opts.newsboat)
+
+    farm = FeedFarm(opts)
+    server = Server(("127.0.0.1", 0), Handler)
+    server.opts = opts
+    server.farm = farm
+    server.stats = Stats()
+    server.attempts = {}
+    server.attempts_lock = threading.Lock()
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    base = "http://127.0.0.1:%d" % server.server_address[1]
+
+    workdir = opts.workdir or tempfile.mkdtemp(prefix="newsboat-loadtest-")
+    os.makedirs(workdir, exist_ok=True)
+    with open(os.path.join(workdir, "urls"), "w") as urls:
+        for feed in range(opts.feeds):
+            urls.write(farm.url(base, feed) + "\n")
+    with open(os.path.join(workdir, "config"), "w") as config:
+        config.write("reload-threads %d\n" % opts.reload_threads)
+        config.write("download-timeout 30\n")
+
+    result = {
+        "options": {k: v for k, v in vars(opts).items()
+                    if k not in ("newsboat", "workdir", "json")},
+        "runs": [],
+    }
+    failed = False
+    try:
+        for run in range(opts.runs):
+            farm.run = run
+            server.stats.reset()
+            print("run %d..." % run, file=sys.stderr)
+            outcome = run_newsboat(opts, workdir, run)
+            outcome["server"] = server.stats.snapshot()
+            result["runs"].append(outcome)
+            failed = failed or outcome["exit_status"] != 0
+    finally:
+        server.shutdown()
+        if not opts.workdir:
+            shutil.rmtree(workdir, ignore_errors=True)
+
+    print_report(result, sys.stdout)
+    if opts.json:
+        with open(opts.json, "w") as out:
+            json.dump(result, out, indent=2)
+            out.write("\n")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,49 @@
+#include "matcher.h"
+
+#include <vector>
+
+#include "bench.h"
+#include "cache.h"
+#include "configcontainer.h"
+#include "datagen.h"
+#include "rss.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("matcher")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	Bench::DataGenerator gen(ctx.options());
+	const auto feeds = gen.feeds(&rsscache);
+
+	std::vector<Matchable*> items;
+	for (const auto& feed : feeds) {
+		for (const auto& item : feed->items()) {
+			items.push_back(item.get());
+		}
+	}
+
+	const std::vector<std::string> expressions = {
+		"unread = \"yes\"",
+		"title =~ \"(kernel|security) update\"",
+		"title # \"release\" or author = \"the reader\"",
+		"age between 0:7 and flags # \"a\"",
+		"tags # \"linux\" and unread = \"yes\"",
+		"content =~ \"performance\"",
+	};
+
+	for (const auto& expression : expressions) {
+		ctx.measure("matches_all: " + expression, items.size(), [&] {
+			Matcher m(expression);
+			m.matches_all(items);
+		});
+	}
+
+	for (const auto& expression : expressions) {
+		Matcher m(expression);
+		ctx.measure("matches_all again: " + expression,
+			items.size(),
+			[&] { m.matches_all(items); });
+	}
+}
@@ -0,0 +1,45 @@
+#include "rss.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "cache.h"
+#include "configcontainer.h"
+#include "datagen.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("rss")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	Bench::DataGenerator gen(ctx.options());
+
+	// all generated items in one feed, like a query feed over everything
+	RssFeed feed(&rsscache);
+	for (const auto& f : gen.feeds(&rsscache)) {
+		feed.add_items(f->items());
+	}
+	const auto unsorted = feed.items();
+
+	const std::vector<std::pair<std::string, ArtSortMethod>> methods = {
+		{"title", ArtSortMethod::TITLE},
+		{"flags", ArtSortMethod::FLAGS},
+		{"author", ArtSortMethod::AUTHOR},
+		{"link", ArtSortMethod::LINK},
+		{"guid", ArtSortMethod::GUID},
+		{"date", ArtSortMethod::DATE},
+	};
+
+	for (const auto& method : methods) {
+		const ArticleSortStrategy strategy{
+			method.second, SortDirection::DESC};
+		ctx.measure("sort: " + method.first,
+			unsorted.size(),
+			[&] { feed.items() = unsorted; },
+			[&] { feed.sort(strategy); });
+	}
+}
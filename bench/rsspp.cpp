@@ -0,0 +1,65 @@
+#include "rsspp.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "cache.h"
+#include "configcontainer.h"
+#include "datagen.h"
+#include "rssparser.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("rsspp")
+{
+	const std::vector<std::pair<std::string, rsspp::Version>> formats = {
+		{"RSS 0.91", rsspp::RSS_0_91},
+		{"RSS 0.92", rsspp::RSS_0_92},
+		{"RSS 1.0", rsspp::RSS_1_0},
+		{"RSS 2.0", rsspp::RSS_2_0},
+		{"Atom 1.0", rsspp::ATOM_1_0},
+	};
+
+	for (const auto& format : formats) {
+		Bench::DataGenerator gen(ctx.options());
+		const std::string xml = gen.feed_xml(format.second);
+
+		ctx.measure("parse_buffer: " + format.first,
+			ctx.options().items,
+			[&] {
+				rsspp::Parser p;
+				p.parse_buffer(xml, "http://example.com/");
+			});
+	}
+
+	// the whole path a reload takes: parsing, then turning rsspp::Items
+	// into RssItems in RssParser::fill_feed_items(); the "allocations"
+	// in the output show how much copying that does
+	Bench::DataGenerator gen(ctx.options());
+	char path[] = "/tmp/newsboat-bench.XXXXXX";
+	const int fd = mkstemp(path);
+	if (fd == -1) {
+		perror("mkstemp");
+		return;
+	}
+	close(fd);
+	{
+		std::ofstream out(path);
+		out << gen.feed_xml(rsspp::RSS_2_0);
+	}
+
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const std::string url = std::string("file://") + path;
+	ctx.measure("RssParser::parse: RSS 2.0", ctx.options().items, [&] {
+		RssParser parser(url, &rsscache, &cfg, nullptr);
+		parser.parse();
+	});
+
+	unlink(path);
+}
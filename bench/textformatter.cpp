@@ -0,0 +1,54 @@
+#include "textformatter.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "datagen.h"
+#include "htmlrenderer.h"
+
+using namespace newsboat;
+
+BENCHMARK_SUITE("textformatter")
+{
+	Bench::DataGenerator gen(ctx.options());
+	std::vector<std::vector<std::pair<LineType, std::string>>> documents;
+	uint64_t line_count = 0;
+	HtmlRenderer r;
+	for (unsigned int i = 0; i < ctx.options().items; ++i) {
+		std::vector<std::pair<LineType, std::string>> lines;
+		std::vector<LinkPair> links;
+		r.render(gen.html(ctx.options().content_size),
+			lines,
+			links,
+			"http://example.com/");
+		line_count += lines.size();
+		documents.push_back(std::move(lines));
+	}
+
+	ctx.measure("format_text_to_list", line_count, [&] {
+		for (const auto& lines : documents) {
+			TextFormatter fmt;
+			fmt.add_lines(lines);
+			fmt.format_text_to_list(nullptr, "article", 72, 80);
+		}
+	});
+
+	ctx.measure("format_text_plain", line_count, [&] {
+		for (const auto& lines : documents) {
+			TextFormatter fmt;
+			fmt.add_lines(lines);
+			fmt.format_text_plain(72, 80);
+		}
+	});
+
+	// a pasted log or a long `<pre>` line
+	const std::string long_line = gen.words(20000).substr(0, 100 * 1024);
+	ctx.measure("format_text_plain (100 KB line)", 1, [&] {
+		TextFormatter fmt;
+		fmt.add_line(LineType::wrappable, long_line);
+		fmt.add_line(LineType::softwrappable, long_line);
+		fmt.format_text_plain(72, 80);
+	});
+}
@@ -35,6 +35,19 @@ const SchemaVersion unknown_version = {0, 0};
 
 using schema_patches = std::map<SchemaVersion, std::vector<std::string>>;
 
+/// \brief Where a search through the cache left off.
+///
+/// Matches are found newest first; a page of them ends with the match that
+/// has the given pubDate and row id, and the next page starts right after
+/// it. A default-constructed position is at the start of the results.
+struct SearchPosition {
+	bool started = false;
+	/// \brief Set once the last match was returned.
+	bool done = false;
+	time_t pubDate = 0;
+	sqlite3_int64 id = 0;
+};
+
 class Cache {
 public:
 	Cache(const std::string& cachefile, ConfigContainer* c);
@@ -52,6 +65,16 @@ public:
 	std::vector<std::shared_ptr<RssItem>> search_for_items(
 		const std::string& querystr,
 		const std::string& feedurl);
+	/// \brief Returns up to \a limit matches (all of them if \a limit is
+	/// zero) that come after \a position, and moves \a position past them.
+	///
+	/// The cache is only locked while a page is read, so that it can be
+	/// used in between.
+	std::vector<std::shared_ptr<RssItem>> search_for_items(
+		const std::string& querystr,
+		const std::string& feedurl,
+		SearchPosition& position,
+		unsigned int limit);
 	std::unordered_set<std::string> search_in_items(
 		const std::string& querystr,
 		const std::unordered_set<std::string>& guids);
@@ -64,6 +87,9 @@ public:
 	void update_lastmodified(const std::string& uri,
 		time_t t,
 		const std::string& etag);
+	void fetch_content_hash(const std::string& uri, std::string& hash);
+	void update_content_hash(const std::string& uri,
+		const std::string& hash);
 	unsigned int get_unread_count();
 	void mark_item_deleted(const std::string& guid, bool b);
 	void mark_feed_items_deleted(const std::string& feedurl);
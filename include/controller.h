@@ -15,6 +15,7 @@
 #include "reloader.h"
 #include "remoteapi.h"
 #include "rss.h"
+#include "searchresultloader.h"
 #include "urlreader.h"
 
 namespace newsboat {
@@ -34,7 +35,19 @@ public:
 	}
 	int run(const CliArgsParser& args);
 
+	/// \brief Returns up to \a limit articles in \a feed (or all feeds, if
+	/// it's nullptr) that match \a query and come after \a position.
+	///
+	/// Query feeds are searched in memory, so all of their matches are
+	/// returned at once, regardless of \a limit.
 	std::vector<std::shared_ptr<RssItem>> search_for_items(
+		const std::string& query,
+		std::shared_ptr<RssFeed> feed,
+		SearchPosition& position,
+		unsigned int limit);
+	/// \brief Returns a loader for the articles matching \a query, which
+	/// stops at "max-search-results" of them. Call its start() to begin.
+	std::shared_ptr<SearchResultLoader> search_in_pages(
 		const std::string& query,
 		std::shared_ptr<RssFeed> feed);
 
@@ -1,6 +1,9 @@
 #ifndef NEWSBOAT_FEEDLISTFORMACTION_H_
 #define NEWSBOAT_FEEDLISTFORMACTION_H_
 
+#include <chrono>
+
+#include "formatstring.h"
 #include "history.h"
 #include "listformaction.h"
 #include "matcher.h"
@@ -23,6 +26,17 @@ public:
 	void init() override;
 	void set_feedlist(std::vector<std::shared_ptr<RssFeed>>& feeds);
 	void update_visible_feeds(std::vector<std::shared_ptr<RssFeed>>& feeds);
+
+	/// \brief Shows the feed at \a pos, which has just replaced \a oldfeed.
+	///
+	/// Only that feed's line is formatted and replaced. If the feed has to
+	/// appear in or disappear from the list, the whole list is rebuilt,
+	/// but not more often than every few frames; the rebuild is otherwise
+	/// left to a later update or to prepare(). \a oldfeed still has to
+	/// hold its items.
+	void update_feed(std::vector<std::shared_ptr<RssFeed>>& feeds,
+		unsigned int pos,
+		const std::shared_ptr<RssFeed>& oldfeed);
 	void set_tags(const std::vector<std::string>& t);
 	KeyMapHintEntry* get_keymap_hint() override;
 	std::shared_ptr<RssFeed> get_feed();
@@ -71,9 +85,12 @@ private:
 
 	void set_pos();
 
+	bool is_visible(const std::shared_ptr<RssFeed>& feed);
+	void set_head(unsigned int width);
+
 	std::string get_title(std::shared_ptr<RssFeed> feed);
 
-	std::string format_line(const std::string& feedlist_format,
+	std::string format_line(const FmtStrTemplate& feedlist_format,
 		std::shared_ptr<RssFeed> feed,
 		unsigned int pos,
 		unsigned int width);
@@ -99,6 +116,9 @@ private:
 
 	unsigned int old_width;
 
+	FmtStrTemplate feedlist_template;
+	FmtStrTemplate::Values feedlist_values;
+
 	unsigned int unread_feeds;
 	unsigned int total_feeds;
 
@@ -106,6 +126,11 @@ private:
 	ConfigContainer* cfg;
 
 	std::string old_sort_order;
+
+	/* set if update_feed() needed the whole list rebuilt, but it was
+	 * rebuilt too recently to do it right away */
+	bool rebuild_pending;
+	std::chrono::steady_clock::time_point last_rebuild;
 };
 
 } // namespace newsboat
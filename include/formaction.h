@@ -34,6 +34,14 @@ public:
 
 	virtual KeyMapHintEntry* get_keymap_hint() = 0;
 
+	/// \brief Whether content for this dialog is still coming in from a
+	/// background thread. While it is, the main loop calls prepare() and
+	/// redraws every frame, rather than only when a key is pressed.
+	virtual bool is_loading()
+	{
+		return false;
+	}
+
 	virtual std::string id() const = 0;
 
 	virtual std::string get_value(const std::string& value);
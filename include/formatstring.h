@@ -1,21 +1,86 @@
 #ifndef NEWSBOAT_FORMATSTRING_H_
 #define NEWSBOAT_FORMATSTRING_H_
 
-#include <map>
+#include <array>
+#include <bitset>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace newsboat {
 
+/// \brief A format string like `articlelist-format`, parsed once so that it
+/// can be used to format many lines.
+///
+/// `%x` is replaced with the value of x, `%-5x` and `%5x` align it to the left
+/// or right of five characters (cutting it if it's longer), `%%` is a percent
+/// sign, `%?x?yes&no?` is "yes" if x isn't empty and "no" otherwise, and `%>c`
+/// fills the line up to the given width with the character c, pushing what
+/// follows to the right edge.
+class FmtStrTemplate {
+public:
+	/// \brief Values of the format characters, indexed by the character.
+	///
+	/// Only ASCII characters can be used; references to other characters
+	/// read the entry for NUL, which should be left empty.
+	typedef std::array<std::string, 128> Values;
+
+	FmtStrTemplate();
+	explicit FmtStrTemplate(const std::string& fmt);
+
+	/// \brief The format string this template was made from.
+	const std::string& source() const
+	{
+		return src;
+	}
+
+	/// \brief Whether the format string refers to the character \a f, so
+	/// that its value has to be set.
+	bool uses(char f) const;
+
+	/// \brief Formats \a values into a line that is \a width columns wide
+	/// if the format string has a filler, or of any length if \a width is
+	/// 0.
+	std::string format(const Values& values, unsigned int width = 0) const;
+
+private:
+	struct Instruction {
+		enum class Type {
+			TEXT,
+			FIELD,
+			ALIGNED_FIELD,
+			FILLER,
+			CONDITIONAL
+		};
+
+		Type type = Type::TEXT;
+		/* TEXT: the text itself; FILLER: the fill character */
+		std::string text;
+		unsigned char field = 0;
+		int align = 0;
+		std::shared_ptr<const FmtStrTemplate> if_set;
+		std::shared_ptr<const FmtStrTemplate> if_unset;
+	};
+
+	void compile(const std::wstring& wfmt);
+	void format_from(size_t first,
+		const Values& values,
+		unsigned int width,
+		std::string& result) const;
+
+	std::string src;
+	std::vector<Instruction> instructions;
+	std::bitset<128> used;
+};
+
 class FmtStrFormatter {
 public:
 	FmtStrFormatter() {}
 	void register_fmt(char f, const std::string& value);
 	std::string do_format(const std::string& fmt, unsigned int width = 0);
-	std::wstring do_wformat(const std::wstring& fmt,
-		unsigned int width = 0);
 
 private:
-	std::map<char, std::wstring> fmts;
+	FmtStrTemplate::Values fmts;
 };
 
 } // namespace newsboat
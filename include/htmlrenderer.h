@@ -2,7 +2,6 @@
 #define NEWSBOAT_HTMLRENDERER_H_
 
 #include <istream>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -114,7 +113,6 @@ private:
 	std::string absolute_url(const std::string& url,
 		const std::string& link);
 	std::string type2str(LinkType type);
-	std::map<std::string, HtmlTag> tags;
 	void render_table(const Table& table,
 		std::vector<std::pair<LineType, std::string>>& lines);
 	void add_nonempty_line(const std::string& curline,
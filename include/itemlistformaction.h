@@ -3,10 +3,12 @@
 
 #include <assert.h>
 
+#include "formatstring.h"
 #include "history.h"
 #include "listformaction.h"
 #include "listformatter.h"
 #include "regexmanager.h"
+#include "searchresultloader.h"
 #include "view.h"
 
 namespace newsboat {
@@ -59,6 +61,15 @@ public:
 	bool jump_to_previous_item(bool start_with_last);
 	bool jump_to_random_unread_item();
 
+	/// \brief Returns the item that \a op (OP_NEXT, OP_PREV, OP_NEXTUNREAD
+	/// or OP_PREVUNREAD) would open from the article view, without moving
+	/// there.
+	///
+	/// The current item doesn't count as unread, since the article view
+	/// marks it read first. Returns nullptr if there's no such item in this
+	/// list, or \a op is some other operation.
+	std::shared_ptr<RssItem> peek_item(Operation op);
+
 	void handle_cmdline(const std::string& cmd) override;
 
 	void do_update_visible_items();
@@ -73,6 +84,17 @@ public:
 	{
 		searchphrase = s;
 	}
+	/// \brief Adds the results that \a loader finds to the list as they
+	/// come in.
+	void set_search_loader(std::shared_ptr<SearchResultLoader> loader)
+	{
+		search_loader = loader;
+	}
+
+	bool is_loading() override
+	{
+		return search_loader != nullptr;
+	}
 
 	void recalculate_form() override;
 
@@ -96,6 +118,9 @@ private:
 	void qna_end_setfilter();
 	void qna_end_editflags();
 	void qna_start_search();
+	/* moves the results found since the last call into the feed; returns
+	 * true if there were any */
+	bool take_search_results();
 
 	void handle_cmdline_num(unsigned int idx);
 
@@ -125,7 +150,11 @@ private:
 
 	std::string item2formatted_line(const ItemPtrPosPair& item,
 		const unsigned int width,
-		const std::string& itemlist_format,
+		const FmtStrTemplate& itemlist_format,
+		const std::string& datetime_format);
+	std::vector<unsigned int> format_lines_on_screen(
+		const unsigned int width,
+		const FmtStrTemplate& itemlist_format,
 		const std::string& datetime_format);
 
 	unsigned int pos;
@@ -139,6 +168,7 @@ private:
 	History filterhistory;
 
 	std::shared_ptr<RssFeed> search_dummy_feed;
+	std::shared_ptr<SearchResultLoader> search_loader;
 
 	std::mutex redraw_mtx;
 
@@ -155,7 +185,13 @@ private:
 	InvalidationMode invalidation_mode;
 	std::vector<unsigned int> invalidated_itempos;
 
+	FmtStrTemplate itemlist_template;
+	FmtStrTemplate::Values itemlist_values;
+
 	ListFormatter listfmt;
+	/* for each of visible_items, whether listfmt holds its formatted line
+	 * or just an empty placeholder */
+	std::vector<bool> line_formatted;
 	Cache* rsscache;
 	FilterContainer* filters;
 	ConfigContainer* cfg;
@@ -0,0 +1,88 @@
+#ifndef NEWSBOAT_ITEMPRERENDERER_H_
+#define NEWSBOAT_ITEMPRERENDERER_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "configcontainer.h"
+#include "itemrendercache.h"
+
+namespace newsboat {
+
+class RegexManager;
+class RssItem;
+
+/// \brief Renders the article the user is likely to open next in a
+/// background thread.
+///
+/// The article view hands it the article that "next" would open while the
+/// current one is being read. Once the user gets there, the finished render
+/// is moved into an ItemRenderCache, so that the article is shown without
+/// rendering it again. Only one article is rendered ahead at a time; asking
+/// for another one replaces it.
+class ItemPrerenderer {
+public:
+	ItemPrerenderer(ConfigContainer* cfg, RegexManager* rxman);
+	~ItemPrerenderer();
+
+	/// \brief Renders \a item with the settings given by \a key in the
+	/// background.
+	///
+	/// The item and the settings are copied, so they can be changed in the
+	/// meantime; the render is simply not used then, since its revision or
+	/// renderer won't match any more.
+	void prerender(const std::shared_ptr<RssItem>& item,
+		const ItemRenderCache::Key& key);
+
+	/// \brief Throws away the article that is waiting to be rendered or is
+	/// being rendered.
+	void cancel();
+
+	/// \brief Moves finished renders into \a cache.
+	///
+	/// If the article \a guid is being rendered right now, waits for it to
+	/// finish first. Renders made with other highlight rules than \a
+	/// highlight_revision are thrown away.
+	void collect(ItemRenderCache& cache,
+		const std::string& guid,
+		unsigned long highlight_revision);
+
+private:
+	struct Job {
+		Job(const std::shared_ptr<RssItem>& item,
+			const ItemRenderCache::Key& key,
+			const ConfigContainer& cfg);
+
+		std::shared_ptr<RssItem> item;
+		ItemRenderCache::Key key;
+		/* taken on the UI thread, since ConfigContainer isn't safe to
+		 * read while the user changes settings */
+		ConfigContainer cfg;
+	};
+
+	void run();
+
+	ConfigContainer* cfg;
+	RegexManager* rxman;
+
+	std::thread worker;
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::unique_ptr<Job> pending;
+	/* guid of the article being rendered, empty if there's none */
+	std::string rendering;
+	std::vector<std::pair<ItemRenderCache::Key, ItemRenderCache::Entry>>
+		finished;
+	/* bumped by cancel(), so that the render in progress can tell it's
+	 * no longer wanted */
+	unsigned long generation;
+	bool stop;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_ITEMPRERENDERER_H_ */
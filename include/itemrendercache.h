@@ -0,0 +1,102 @@
+#ifndef NEWSBOAT_ITEMRENDERCACHE_H_
+#define NEWSBOAT_ITEMRENDERCACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "htmlrenderer.h"
+
+namespace newsboat {
+
+/// \brief Keeps articles rendered by item_renderer, so that they don't have to
+/// be rendered again when the user comes back to them.
+///
+/// There is at most one entry per article and view (rendered or source). An
+/// entry is only returned if it was rendered from the same revision of the
+/// item, with the same widths, `html-renderer`, feed title and highlight
+/// rules. Least
+/// recently used entries are dropped once the cache grows over its budget.
+class ItemRenderCache {
+public:
+	/// \brief Everything the rendered article depends on.
+	struct Key {
+		std::string guid;
+		/// \brief Whether this is the article's source rather than its
+		/// rendered HTML.
+		bool source = false;
+		/// \brief RssItem::revision() at the time of rendering.
+		unsigned long revision = 0;
+		unsigned int text_width = 0;
+		unsigned int window_width = 0;
+		/// \brief Value of the `html-renderer` setting.
+		std::string renderer;
+		/// \brief Feed title shown in the article's header, which
+		/// changes without the item's revision (e.g. `rename-feed`).
+		std::string feed_title;
+		/// \brief RegexManager::revision() at the time of rendering.
+		unsigned long highlight_revision = 0;
+	};
+
+	struct Entry {
+		/// \brief The article as an STFL list.
+		std::string text;
+		size_t num_lines = 0;
+		std::vector<LinkPair> links;
+	};
+
+	/// \brief Creates a cache that holds at most \a budget bytes.
+	explicit ItemRenderCache(size_t budget);
+
+	/// \brief Returns the entry stored for \a key, or nullptr if there is
+	/// none.
+	///
+	/// The pointer stays valid until the cache is changed.
+	const Entry* get(const Key& key);
+
+	/// \brief Stores \a entry for \a key, replacing whatever was stored for
+	/// the same article and view.
+	void put(const Key& key, Entry entry);
+
+	/// \brief Lets entries rendered from revision \a from of the item \a guid
+	/// be used for its revision \a to.
+	///
+	/// Meant for changes that don't show up in the article, like the
+	/// unread flag.
+	void update_revision(const std::string& guid,
+		unsigned long from,
+		unsigned long to);
+
+	void clear();
+
+	/// \brief Approximate number of bytes held by the cache.
+	size_t size() const
+	{
+		return used;
+	}
+
+private:
+	struct Slot {
+		Key key;
+		Entry entry;
+		size_t bytes;
+	};
+	typedef std::pair<std::string, bool> SlotId;
+
+	void remove(std::map<SlotId, std::list<Slot>::iterator>::iterator it);
+	void check_highlight_revision(unsigned long revision);
+
+	/* most recently used first */
+	std::list<Slot> slots;
+	std::map<SlotId, std::list<Slot>::iterator> index;
+	const size_t budget;
+	size_t used;
+	unsigned long highlight_revision;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_ITEMRENDERCACHE_H_ */
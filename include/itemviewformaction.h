@@ -3,6 +3,8 @@
 
 #include "formaction.h"
 #include "htmlrenderer.h"
+#include "itemprerenderer.h"
+#include "itemrendercache.h"
 #include "regexmanager.h"
 #include "rss.h"
 #include "textformatter.h"
@@ -49,6 +51,22 @@ public:
 
 	void set_regexmanager(RegexManager* r);
 
+	/// \brief Makes prepare() look for the article in \a cache before
+	/// rendering it, and store it there afterwards.
+	void set_render_cache(ItemRenderCache* cache)
+	{
+		render_cache = cache;
+	}
+
+	/// \brief Makes prepare() render the article the user is likely to
+	/// read next in the background, using \a p.
+	///
+	/// Has no effect unless a render cache is set as well.
+	void set_prerenderer(ItemPrerenderer* p)
+	{
+		prerenderer = p;
+	}
+
 	void update_percent();
 
 private:
@@ -67,12 +85,20 @@ private:
 
 	void do_search();
 
+	void prerender_next(ItemRenderCache::Key key);
+	void note_move(Operation op);
+
 	std::string guid;
 	std::shared_ptr<RssFeed> feed;
 	bool show_source;
 	std::vector<LinkPair> links;
 	bool quit;
 	RegexManager* rxman;
+	ItemRenderCache* render_cache;
+	ItemPrerenderer* prerenderer;
+	/* the last operation used to move to another article, which tells
+	 * where the user is likely to go next */
+	Operation last_move;
 	unsigned int num_lines;
 	std::shared_ptr<ItemListFormAction> itemlist;
 	bool in_search;
@@ -0,0 +1,112 @@
+#ifndef NEWSBOAT_KEYEDSORT_H_
+#define NEWSBOAT_KEYEDSORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace newsboat {
+
+/// \brief Number of elements from which keyed_stable_sort() spreads the work
+/// over several threads.
+const size_t parallel_sort_threshold = 20000;
+
+/// \brief Sorts \a v stably by keys that \a make_key computes from its
+/// elements, comparing the keys with \a less.
+///
+/// Each key is computed exactly once, so expensive keys (converted titles,
+/// unread counts) aren't computed again for every comparison. With at least
+/// parallel_sort_threshold elements, computing the keys and sorting is split
+/// over the available cores; \a make_key and \a less have to be safe to call
+/// from several threads at once then.
+///
+/// The result is the same as that of std::stable_sort() with a comparator
+/// that computes the keys itself.
+template<typename T, typename MakeKey, typename Less>
+void keyed_stable_sort(std::vector<T>& v, MakeKey make_key, Less less)
+{
+	typedef typename std::decay<decltype(make_key(v.front()))>::type Key;
+	typedef std::pair<Key, size_t> Decorated;
+	typedef typename std::vector<Decorated>::iterator Iterator;
+
+	const auto decorated_less = [&less](const Decorated& a,
+		const Decorated& b) {
+		return less(a.first, b.first);
+	};
+
+	std::vector<Decorated> decorated(v.size());
+	const auto sort_range = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			decorated[i].first = make_key(v[i]);
+			decorated[i].second = i;
+		}
+		std::stable_sort(decorated.begin() + begin,
+			decorated.begin() + end,
+			decorated_less);
+	};
+
+	size_t parts = 1;
+	if (v.size() >= parallel_sort_threshold) {
+		parts = std::max(1u, std::thread::hardware_concurrency());
+		parts = std::min(parts, v.size() / (parallel_sort_threshold / 4));
+	}
+
+	if (parts <= 1) {
+		sort_range(0, v.size());
+	} else {
+		// sort `parts` runs side by side, then merge neighbouring runs
+		// until only one is left; merging keeps the sort stable since
+		// the runs are in their original order
+		std::vector<size_t> bounds;
+		for (size_t i = 0; i <= parts; ++i) {
+			bounds.push_back(v.size() * i / parts);
+		}
+
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+			threads.emplace_back(sort_range, bounds[i], bounds[i + 1]);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		while (bounds.size() > 2) {
+			threads.clear();
+			std::vector<size_t> merged_bounds;
+			size_t i = 0;
+			for (; i + 2 < bounds.size(); i += 2) {
+				const Iterator first = decorated.begin() + bounds[i];
+				const Iterator middle =
+					decorated.begin() + bounds[i + 1];
+				const Iterator last =
+					decorated.begin() + bounds[i + 2];
+				threads.emplace_back([=]() {
+					std::inplace_merge(
+						first, middle, last, decorated_less);
+				});
+				merged_bounds.push_back(bounds[i]);
+			}
+			for (; i < bounds.size(); ++i) {
+				merged_bounds.push_back(bounds[i]);
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			bounds.swap(merged_bounds);
+		}
+	}
+
+	std::vector<T> sorted;
+	sorted.reserve(v.size());
+	for (auto& d : decorated) {
+		sorted.push_back(std::move(v[d.second]));
+	}
+	v.swap(sorted);
+}
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_KEYEDSORT_H_ */
@@ -85,6 +85,7 @@ enum Operation {
 	OP_RANDOMUNREAD,
 	OP_SORT,
 	OP_REVSORT,
+	OP_CANCEL_SEARCH,
 	OP_NB_MAX,
 
 	// podboat-specific operations:
@@ -0,0 +1,48 @@
+#ifndef NEWSBOAT_LATENCYRECORDER_H_
+#define NEWSBOAT_LATENCYRECORDER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace newsboat {
+
+/// \brief Keeps the most recent samples of a latency and computes
+/// percentiles over them.
+///
+/// The View records the time from reading a key press to drawing the next
+/// frame with it, and writes a summary to the log.
+class LatencyRecorder {
+public:
+	/// \brief Creates a recorder that keeps the last \a capacity samples.
+	explicit LatencyRecorder(size_t capacity = 1024);
+
+	void add(std::chrono::microseconds sample);
+
+	/// \brief Number of samples added so far, including those that were
+	/// dropped since.
+	unsigned long count() const
+	{
+		return total;
+	}
+
+	/// \brief The \a p-th percentile (0 to 100) of the samples that are
+	/// kept, or zero if there are none.
+	std::chrono::microseconds percentile(double p) const;
+
+	/// \brief A line like "p50 1.2 ms, p90 3.4 ms, p99 8.0 ms, max 9.1 ms
+	/// (42 samples)".
+	std::string summary() const;
+
+private:
+	const size_t capacity;
+	std::vector<std::chrono::microseconds> samples;
+	/* where the next sample goes once `samples` is full */
+	size_t next;
+	unsigned long total;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_LATENCYRECORDER_H_ */
@@ -31,6 +31,15 @@ public:
 	}
 	std::string format_list(RegexManager* r = nullptr,
 		const std::string& location = "");
+	/// \brief The STFL `listitem` for the line at \a itempos, the same as
+	/// format_list() would produce for it.
+	///
+	/// Lines that were added with an id get that id as their widget name,
+	/// so this can be used to replace a single line of a list that is
+	/// already on screen.
+	std::string format_line(const unsigned int itempos,
+		RegexManager* r = nullptr,
+		const std::string& location = "");
 	unsigned int get_lines_count()
 	{
 		return lines.size();
@@ -1,16 +1,95 @@
 #ifndef NEWSBOAT_MATCHER_H_
 #define NEWSBOAT_MATCHER_H_
 
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <regex.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "FilterParser.h"
 
 namespace newsboat {
 
+/// \brief Attributes of items and feeds that filter expressions know by name.
+///
+/// Matcher resolves attribute names to these IDs once, when the expression is
+/// parsed, so that evaluating it doesn't involve string comparisons. Names that
+/// aren't listed here resolve to UNKNOWN and are looked up by name.
+enum class AttributeId {
+	UNKNOWN,
+	TITLE,
+	LINK,
+	AUTHOR,
+	CONTENT,
+	DATE,
+	GUID,
+	UNREAD,
+	ENCLOSURE_URL,
+	ENCLOSURE_TYPE,
+	FLAGS,
+	AGE,
+	ARTICLEINDEX,
+	FEEDTITLE,
+	DESCRIPTION,
+	FEEDLINK,
+	FEEDDATE,
+	RSSURL,
+	UNREAD_COUNT,
+	TOTAL_COUNT,
+	TAGS,
+	FEEDINDEX
+};
+
+AttributeId attribute_id(const std::string& attribname);
+const char* attribute_name(AttributeId id);
+
 class Matchable {
 public:
 	Matchable();
 	virtual ~Matchable();
 	virtual bool has_attribute(const std::string& attribname) = 0;
 	virtual std::string get_attribute(const std::string& attribname) = 0;
+
+	/// \brief Same as has_attribute(), but takes a resolved attribute.
+	///
+	/// Default implementation looks the attribute up by name.
+	virtual bool has_attribute_id(AttributeId id);
+
+	/// \brief Same as get_attribute(), but takes a resolved attribute.
+	///
+	/// Default implementation looks the attribute up by name.
+	virtual std::string get_attribute_id(AttributeId id);
+
+	/// \brief Stores the value of a numeric attribute in \a value without
+	/// going through its string representation.
+	///
+	/// Returns false if the attribute isn't numeric (or the Matchable
+	/// doesn't provide it this way), in which case the string returned by
+	/// get_attribute_id() is used. Default implementation returns false.
+	virtual bool get_numeric_attribute_id(AttributeId id, long& value);
+
+	/// \brief Checks if \a token is one of the space-separated words of
+	/// attribute \a id, and stores the answer in \a contains.
+	///
+	/// Meant for attributes that are sets anyway (like feed tags), so that
+	/// the `#` operator doesn't have to build and scan their string
+	/// representation. Returns false if the attribute isn't provided this
+	/// way, in which case the string returned by get_attribute_id() is
+	/// searched. Default implementation returns false.
+	virtual bool attribute_contains(AttributeId id,
+		const std::string& token,
+		bool& contains);
+
+	/// \brief Stores a number in \a revision that changes whenever any of
+	/// the Matchable's own attributes (those of an item, not of its feed)
+	/// changes, and that no other Matchable ever had.
+	///
+	/// Matcher uses it to remember results. Returns false if there is no
+	/// such number, which is what the default implementation does.
+	virtual bool get_revision(unsigned long& revision);
 };
 
 class Matcher {
@@ -18,21 +97,91 @@ public:
 	Matcher();
 	explicit Matcher(const std::string& expr);
 	bool parse(const std::string& expr);
+	/// \brief Checks if \a item matches the expression.
+	///
+	/// If the expression only refers to items' own attributes (not `age`,
+	/// `articleindex` or anything of the feed) and \a item provides a
+	/// revision, the result is remembered until the item's revision
+	/// changes.
 	bool matches(Matchable* item);
+
+	/// \brief Checks which of \a items match, spreading the work over
+	/// several threads if there are enough items.
+	///
+	/// Element `i` of the result tells if `items[i]` matched. The items must
+	/// not be modified until this returns. If matching throws for some
+	/// items, the exception thrown for the first of them is rethrown once
+	/// all threads are done, just like matches() would have in a loop.
+	std::vector<bool> matches_all(const std::vector<Matchable*>& items);
 	const std::string& get_parse_error();
 	const std::string& get_expression();
 
+	/// \brief Checks if the expression refers to attribute \a id.
+	bool uses_attribute(AttributeId id) const;
+
+	/// \brief Translates the expression into an SQL condition on the columns
+	/// of the `rss_item` table.
+	///
+	/// Only item attributes that are stored in that table are supported, and
+	/// only for equality and token comparisons (plus numeric ones for
+	/// `age`). Returns false for anything else (regular expressions,
+	/// content, dates, feed attributes), in which case the expression has to
+	/// be evaluated with matches().
+	bool to_sql(std::string& condition);
+
 private:
-	bool matches_r(expression* e, Matchable* item);
+	enum class OpCode {
+		/* evaluate a comparison and put the result into the accumulator */
+		TEST,
+		/* skip to `target` if the accumulator is false (for `and`) */
+		JUMP_IF_FALSE,
+		/* skip to `target` if the accumulator is true (for `or`) */
+		JUMP_IF_TRUE
+	};
+
+	/* One step of the compiled expression. Comparisons store everything
+	 * that doesn't depend on the item: the resolved attribute, literals
+	 * already converted to numbers, and the compiled regex. */
+	struct Instruction {
+		OpCode code = OpCode::TEST;
+		int matchop = LOGOP_INVALID;
+		bool negate = false;
+		AttributeId attrib = AttributeId::UNKNOWN;
+		std::string name;
+		std::string literal;
+		int number = 0;
+		int range_lower = 0;
+		int range_upper = 0;
+		bool range_valid = false;
+		std::shared_ptr<regex_t> regex;
+		std::string regex_error;
+		size_t target = 0;
+	};
+
+	struct CachedResult {
+		unsigned long revision;
+		bool matched;
+	};
 
-	bool matchop_lt(expression* e, Matchable* item);
-	bool matchop_gt(expression* e, Matchable* item);
-	bool matchop_rxeq(expression* e, Matchable* item);
-	bool matchop_cont(expression* e, Matchable* item);
-	bool matchop_eq(expression* e, Matchable* item);
-	bool matchop_between(expression* e, Matchable* item);
+	bool evaluate(Matchable* item);
+	std::vector<char> evaluate_all(const std::vector<Matchable*>& items,
+		const std::vector<size_t>& indexes);
+	void remember(const Matchable* item,
+		unsigned long revision,
+		bool matched);
+	void compile(expression* e);
+	Instruction compile_test(expression* e);
+	bool test(const Instruction& ins, Matchable* item);
+	bool has_attribute(const Instruction& ins, Matchable* item);
+	std::string get_attribute(const Instruction& ins, Matchable* item);
+	int get_numeric_attribute(const Instruction& ins, Matchable* item);
+	bool to_sql(expression* e, time_t now, std::string& condition);
 
 	FilterParser p;
+	std::vector<Instruction> program;
+	bool cacheable = false;
+	std::unordered_map<const Matchable*, CachedResult> results;
+	std::mutex results_mtx;
 	std::string errmsg;
 	std::string exp;
 };
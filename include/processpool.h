@@ -0,0 +1,113 @@
+#ifndef NEWSBOAT_PROCESSPOOL_H_
+#define NEWSBOAT_PROCESSPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace newsboat {
+
+struct ProcessResult {
+	/// Everything the process wrote to its standard output.
+	std::string output;
+	/// Exit status of the process, or -1 if it didn't exit normally.
+	int exit_status = -1;
+	/// True if the process was killed because it ran out of time, or
+	/// because the pool was shut down.
+	bool timed_out = false;
+};
+
+/// \brief Runs external commands with bounded parallelism and timeouts.
+///
+/// Commands are started with posix_spawn() in their own process group,
+/// their input and output are pumped through non-blocking pipes with
+/// poll(), and they're sent SIGTERM (then SIGKILL) once they exceed the
+/// configured timeout. At most `max-subprocesses` children run at once;
+/// further requests are queued.
+class ProcessPool {
+public:
+	static ProcessPool& getInstance();
+
+	/// \brief Sets the number of children that may run simultaneously.
+	///
+	/// Zero is treated as one.
+	void set_max_processes(unsigned int n);
+
+	/// \brief Sets the time (in seconds) a child may run before it's
+	/// killed. Zero disables the timeout.
+	void set_timeout(unsigned int seconds);
+
+	/// \brief Runs \a argv (looked up in PATH), feeding it \a input, and
+	/// waits for it to finish.
+	ProcessResult run(const std::vector<std::string>& argv,
+		const std::string& input = "");
+
+	/// \brief Queues \a argv to be run like run() does, but returns
+	/// without waiting for it; its output is thrown away.
+	void run_in_background(const std::vector<std::string>& argv);
+
+	/// \brief Same as run(), but passes \a cmdline to /bin/sh -c.
+	///
+	/// If the same command line was handed to prefetch_shell() earlier,
+	/// the prefetched result is returned instead of starting it again.
+	ProcessResult run_shell(const std::string& cmdline,
+		const std::string& input = "");
+
+	/// \brief Queues \a cmdline to be run in the background, so that a
+	/// later run_shell() with the same command line can pick up the result.
+	void prefetch_shell(const std::string& cmdline);
+
+	/// \brief Drops prefetched results that nobody asked for.
+	void discard_prefetched();
+
+	/// \brief Kills the children that are still running, drops the queued
+	/// commands and waits for the worker threads to exit.
+	///
+	/// Commands submitted meanwhile return an empty result right away;
+	/// afterwards the pool can be used again. Called by the destructor, so
+	/// that no worker outlives the pool.
+	void shutdown();
+
+private:
+	struct Job {
+		std::vector<std::string> argv;
+		std::string input;
+		std::promise<ProcessResult> result;
+	};
+
+	ProcessPool() = default;
+	~ProcessPool();
+	ProcessPool(const ProcessPool&) = delete;
+	ProcessPool& operator=(const ProcessPool&) = delete;
+
+	std::shared_future<ProcessResult> submit(
+		const std::vector<std::string>& argv,
+		const std::string& input);
+	void worker();
+	ProcessResult execute(const std::vector<std::string>& argv,
+		const std::string& input,
+		unsigned int seconds);
+
+	std::mutex mtx;
+	/* signalled when a job is queued or the pool is shut down */
+	std::condition_variable queue_cv;
+	std::vector<std::thread> workers;
+	std::deque<Job> queue;
+	std::map<std::string, std::shared_future<ProcessResult>> prefetched;
+	unsigned int max_processes = 1;
+	unsigned int running_workers = 0;
+	unsigned int timeout = 0;
+	/* read by execute() without the lock, so that running children are
+	 * killed on shutdown */
+	std::atomic<bool> stopping{false};
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_PROCESSPOOL_H_ */
@@ -1,9 +1,12 @@
 #ifndef NEWSBOAT_REGEXMANAGER_H_
 #define NEWSBOAT_REGEXMANAGER_H_
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <regex.h>
 #include <sys/types.h>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -23,6 +26,16 @@ public:
 	void remove_last_regex(const std::string& location);
 	int article_matches(Matchable* item);
 
+	/// \brief Returns a number that grows whenever highlight rules are
+	/// added or removed.
+	///
+	/// Lets the users of highlighted text tell whether it's still
+	/// up to date.
+	unsigned long revision() const
+	{
+		return revision_;
+	}
+
 private:
 	typedef std::pair<std::vector<regex_t*>, std::vector<std::string>>
 		RcPair;
@@ -31,6 +44,35 @@ private:
 	std::vector<std::pair<std::shared_ptr<Matcher>, int>> matchers;
 	std::string extract_initial_marker(const std::string& str);
 
+	/* Consecutive highlight patterns of a location, combined into a single
+	 * regex. As long as a line hasn't been highlighted yet, one regexec()
+	 * of the combined regex tells whether any of the group's patterns
+	 * matches it at all. */
+	struct PatternGroup {
+		size_t begin;
+		size_t end;
+		/* marker number of the group's first regex */
+		unsigned int first_marker;
+		/* null if the patterns couldn't be combined */
+		std::shared_ptr<regex_t> combined;
+	};
+	struct Prefilter {
+		/* source of each of the location's regexes; empty for
+		 * highlight-article placeholders */
+		std::vector<std::string> patterns;
+		std::vector<PatternGroup> groups;
+		bool valid = false;
+	};
+	std::map<std::string, Prefilter> prefilters;
+	unsigned long revision_ = 0;
+	/* articles are highlighted in the background by ItemPrerenderer, so
+	 * changes to the rules have to wait for it */
+	std::mutex mtx;
+	void add_pattern(const std::string& location,
+		const std::string& pattern);
+	const std::vector<PatternGroup>& get_pattern_groups(
+		const std::string& location);
+
 public:
 	std::vector<std::string>& get_attrs(const std::string& loc)
 	{
@@ -38,6 +80,8 @@ public:
 	}
 	std::vector<regex_t*>& get_regexes(const std::string& loc)
 	{
+		prefilters[loc].valid = false;
+		revision_++;
 		return locations[loc].first;
 	}
 };
@@ -1,10 +1,13 @@
 #ifndef NEWSBOAT_RSS_H_
 #define NEWSBOAT_RSS_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "configcontainer.h"
@@ -23,34 +26,37 @@ class RssFeed;
 class RssItem : public Matchable {
 public:
 	explicit RssItem(Cache* c);
+	/// \brief Makes a copy with the same revision, e.g. to render it on
+	/// another thread.
+	RssItem(const RssItem& other);
 	~RssItem() override;
 
 	std::string title() const;
-	std::string title_raw() const
+	const std::string& title_raw() const
 	{
 		return title_;
 	}
-	void set_title(const std::string& t);
+	void set_title(std::string t);
 
 	const std::string& link() const
 	{
 		return link_;
 	}
-	void set_link(const std::string& l);
+	void set_link(std::string l);
 
 	std::string author() const;
-	std::string author_raw() const
+	const std::string& author_raw() const
 	{
 		return author_;
 	}
-	void set_author(const std::string& a);
+	void set_author(std::string a);
 
 	std::string description() const;
-	std::string description_raw() const
+	const std::string& description_raw() const
 	{
 		return description_;
 	}
-	void set_description(const std::string& d);
+	void set_description(std::string d);
 
 	unsigned int size() const
 	{
@@ -76,7 +82,7 @@ public:
 	{
 		return guid_;
 	}
-	void set_guid(const std::string& g);
+	void set_guid(std::string g);
 
 	bool unread() const
 	{
@@ -90,9 +96,9 @@ public:
 	{
 		ch = c;
 	}
-	void set_feedurl(const std::string& f)
+	void set_feedurl(std::string f)
 	{
-		feedurl_ = f;
+		feedurl_ = std::move(f);
 	}
 
 	const std::string& feedurl() const
@@ -109,8 +115,8 @@ public:
 		return enclosure_type_;
 	}
 
-	void set_enclosure_url(const std::string& url);
-	void set_enclosure_type(const std::string& type);
+	void set_enclosure_url(std::string url);
+	void set_enclosure_type(std::string type);
 
 	bool enqueued()
 	{
@@ -135,6 +141,13 @@ public:
 
 	bool has_attribute(const std::string& attribname) override;
 	std::string get_attribute(const std::string& attribname) override;
+	bool has_attribute_id(AttributeId id) override;
+	std::string get_attribute_id(AttributeId id) override;
+	bool get_numeric_attribute_id(AttributeId id, long& value) override;
+	bool attribute_contains(AttributeId id,
+		const std::string& token,
+		bool& contains) override;
+	bool get_revision(unsigned long& revision) override;
 
 	void set_feedptr(std::shared_ptr<RssFeed> ptr);
 	std::shared_ptr<RssFeed> get_feedptr()
@@ -149,6 +162,7 @@ public:
 	void set_deleted(bool b)
 	{
 		deleted_ = b;
+		touch();
 	}
 
 	void set_index(unsigned int i)
@@ -160,9 +174,9 @@ public:
 		return idx;
 	}
 
-	void set_base(const std::string& b)
+	void set_base(std::string b)
 	{
-		base = b;
+		base = std::move(b);
 	}
 	const std::string& get_base()
 	{
@@ -181,9 +195,22 @@ public:
 	void unload()
 	{
 		description_.clear();
+		touch();
+	}
+
+	/// \brief Returns a number that grows whenever one of the item's
+	/// attributes (unread status, flags, content, title etc.) changes.
+	///
+	/// Query feeds use it to find the items they have to match again, and
+	/// Matcher to remember results.
+	unsigned long revision() const
+	{
+		return revision_;
 	}
 
 private:
+	void touch();
+
 	std::string title_;
 	std::string link_;
 	std::string author_;
@@ -204,6 +231,9 @@ private:
 	bool enqueued_;
 	bool deleted_;
 	bool override_unread_;
+	/* bumped by setters on the UI and reload threads, and read without a
+	 * lock by the matcher and the render caches */
+	std::atomic<unsigned long> revision_;
 };
 
 class RssFeed : public Matchable {
@@ -211,34 +241,34 @@ public:
 	explicit RssFeed(Cache* c);
 	RssFeed();
 	~RssFeed() override;
-	std::string title_raw() const
+	const std::string& title_raw() const
 	{
 		return title_;
 	}
 	std::string title() const;
-	void set_title(const std::string& t)
+	void set_title(std::string t)
 	{
-		title_ = t;
+		title_ = std::move(t);
 		utils::trim(title_);
 	}
 
-	std::string description_raw() const
+	const std::string& description_raw() const
 	{
 		return description_;
 	}
 	std::string description() const;
-	void set_description(const std::string& d)
+	void set_description(std::string d)
 	{
-		description_ = d;
+		description_ = std::move(d);
 	}
 
 	const std::string& link() const
 	{
 		return link_;
 	}
-	void set_link(const std::string& l)
+	void set_link(std::string l)
 	{
-		link_ = l;
+		link_ = std::move(l);
 	}
 
 	std::string pubDate() const
@@ -260,6 +290,8 @@ public:
 	{
 		items_.push_back(item);
 		items_guid_map[item->guid()] = item;
+		items_sorted = false;
+		items_changed();
 	}
 	void add_items(const std::vector<std::shared_ptr<RssItem>>& items)
 	{
@@ -267,6 +299,8 @@ public:
 			items_.push_back(item);
 			items_guid_map[item->guid()] = item;
 		}
+		items_sorted = false;
+		items_changed();
 	}
 	void set_items(std::vector<std::shared_ptr<RssItem>>& items)
 	{
@@ -279,6 +313,7 @@ public:
 		LOG(Level::DEBUG, "RssFeed: clearing items");
 		items_.clear();
 		items_guid_map.clear();
+		items_changed();
 	}
 
 	void erase_items(std::vector<std::shared_ptr<RssItem>>::iterator begin,
@@ -288,11 +323,13 @@ public:
 			items_guid_map.erase((*it)->guid());
 		}
 		items_.erase(begin, end);
+		items_changed();
 	}
 	void erase_item(std::vector<std::shared_ptr<RssItem>>::iterator pos)
 	{
 		items_guid_map.erase((*pos)->guid());
 		items_.erase(pos);
+		items_changed();
 	}
 
 	std::shared_ptr<RssItem> get_item_by_guid(const std::string& guid);
@@ -318,12 +355,26 @@ public:
 
 	bool has_attribute(const std::string& attribname) override;
 	std::string get_attribute(const std::string& attribname) override;
-
+	bool has_attribute_id(AttributeId id) override;
+	std::string get_attribute_id(AttributeId id) override;
+	bool get_numeric_attribute_id(AttributeId id, long& value) override;
+	bool attribute_contains(AttributeId id,
+		const std::string& token,
+		bool& contains) override;
+
+	/// \brief Brings the items of a query feed up to date with \a feeds.
+	///
+	/// Only the items of feeds that were added, replaced or changed since
+	/// the previous call are matched against the query; the others keep
+	/// their membership. If the feed was sorted before, new items are
+	/// merged in at their place.
 	void update_items(std::vector<std::shared_ptr<RssFeed>> feeds);
 
 	void set_query(const std::string& s)
 	{
 		query = s;
+		query_matcher.reset();
+		query_sources.clear();
 	}
 
 	bool is_empty()
@@ -347,6 +398,11 @@ public:
 
 	void purge_deleted_items();
 
+	/// \brief Returns the articles that aren't deleted and whose title or
+	/// content contains \a query, in the feed's order.
+	std::vector<std::shared_ptr<RssItem>> search_items(
+		const std::string& query);
+
 	void set_rtl(bool b)
 	{
 		is_rtl_ = b;
@@ -392,6 +448,25 @@ public:
 
 	void mark_all_items_read();
 
+	/// \brief Returns a number that grows whenever the feed's items, its
+	/// tags, or the unread status or flags of one of its items change.
+	unsigned long revision() const
+	{
+		return revision_;
+	}
+
+	/// \brief Like revision(), but ignores changes to individual items.
+	unsigned long items_revision() const
+	{
+		return items_revision_;
+	}
+
+	/// \brief Called by the feed's items when they change.
+	void item_changed(unsigned long item_revision)
+	{
+		revision_ = item_revision;
+	}
+
 	std::mutex item_mutex; // this is ugly, but makes it possible to lock
 			       // items use e.g. from the Cache class
 private:
@@ -404,6 +479,8 @@ private:
 	std::unordered_map<std::string, std::shared_ptr<RssItem>>
 		items_guid_map;
 	std::vector<std::string> tags_;
+	/* words of the tags returned by get_tags(), for the `#` operator */
+	std::unordered_set<std::string> tag_words;
 	std::string query;
 
 	Cache* ch;
@@ -414,6 +491,23 @@ private:
 	unsigned int order;
 	DlStatus status_;
 	std::mutex items_guid_map_mutex;
+
+	void items_changed();
+
+	std::atomic<unsigned long> revision_;
+	std::atomic<unsigned long> items_revision_;
+
+	/* State of a query feed between calls to update_items(): the compiled
+	 * query, the revision of each feed as of the last update, and the sort
+	 * order items_ is known to be in. */
+	struct QuerySource {
+		std::weak_ptr<RssFeed> feed;
+		unsigned long revision;
+	};
+	std::unique_ptr<Matcher> query_matcher;
+	std::unordered_map<const RssFeed*, QuerySource> query_sources;
+	bool items_sorted;
+	ArticleSortStrategy items_sort_strategy;
 };
 
 class RssIgnores : public ConfigActionHandler {
@@ -424,13 +518,29 @@ public:
 		const std::vector<std::string>& params) override;
 	void dump_config(std::vector<std::string>& config_output) override;
 	bool matches(RssItem* item);
+
+	/// \brief Returns the ignore rules that apply to items of the feed at
+	/// \a url, in the order they were defined.
+	const std::vector<Matcher*>& rules_for(const std::string& url) const;
+
+	/// \brief Checks if any of the ignore rules for the feed at \a url
+	/// refers to attribute \a id.
+	bool uses_attribute(const std::string& url, AttributeId id) const;
+
 	bool matches_lastmodified(const std::string& url);
 	bool matches_resetunread(const std::string& url);
 
 private:
+	/* all rules in the order they were defined, for dump_config() */
 	std::vector<FeedUrlExprPair> ignores;
+	/* rules for "*" */
+	std::vector<Matcher*> wildcard_ignores;
+	/* rules for a particular feed, merged with the wildcard ones */
+	std::unordered_map<std::string, std::vector<Matcher*>> feed_ignores;
 	std::vector<std::string> ignores_lastmodified;
+	std::unordered_set<std::string> ignores_lastmodified_set;
 	std::vector<std::string> resetflag;
+	std::unordered_set<std::string> resetflag_set;
 };
 
 } // namespace newsboat
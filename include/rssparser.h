@@ -41,28 +41,30 @@ private:
 	void download_filterplugin(const std::string& filter,
 		const std::string& uri);
 	void parse_file(const std::string& file);
+	bool is_content_changed(const std::string& hash);
 
 	void fill_feed_fields(std::shared_ptr<RssFeed> feed);
 	void fill_feed_items(std::shared_ptr<RssFeed> feed);
 
 	void set_item_title(std::shared_ptr<RssFeed> feed,
 		std::shared_ptr<RssItem> x,
-		const rsspp::Item& item);
+		rsspp::Item& item);
 	void set_item_author(std::shared_ptr<RssItem> x,
-		const rsspp::Item& item);
+		rsspp::Item& item);
 	void set_item_content(std::shared_ptr<RssItem> x,
-		const rsspp::Item& item);
+		rsspp::Item& item);
 	void set_item_enclosure(std::shared_ptr<RssItem> x,
-		const rsspp::Item& item);
+		rsspp::Item& item);
 	std::string get_guid(const rsspp::Item& item) const;
 
+	bool is_ignored(std::shared_ptr<RssItem> item);
 	void add_item_to_feed(std::shared_ptr<RssFeed> feed,
 		std::shared_ptr<RssItem> item);
 
 	void handle_content_encoded(std::shared_ptr<RssItem> x,
-		const rsspp::Item& item) const;
+		rsspp::Item& item) const;
 	void handle_itunes_summary(std::shared_ptr<RssItem> x,
-		const rsspp::Item& item);
+		rsspp::Item& item);
 	bool is_html_type(const std::string& type);
 	void fetch_ttrss(const std::string& feed_id);
 	void fetch_newsblur(const std::string& feed_id);
@@ -0,0 +1,96 @@
+#ifndef NEWSBOAT_SEARCHRESULTLOADER_H_
+#define NEWSBOAT_SEARCHRESULTLOADER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache.h"
+
+namespace newsboat {
+
+class RssItem;
+
+/// \brief Reads the results of a search in pages, so that they can be shown
+/// while the rest are still being looked for.
+///
+/// The first page is read on the calling thread, the rest in a background
+/// thread; the search result list takes them over as they come in. The
+/// search stops once \a max_items results were found, or when it's
+/// cancelled.
+class SearchResultLoader {
+public:
+	/// \brief Returns up to the given number of results that come after a
+	/// position, and moves the position past them. A limit of zero means
+	/// all of them. Returning more than the limit is fine if they're all
+	/// the results there are, i.e. the position is done.
+	typedef std::function<std::vector<std::shared_ptr<RssItem>>(
+		SearchPosition&,
+		unsigned int)>
+		Fetch;
+
+	/// \brief Creates a loader that stops after \a max_items results, or
+	/// never if it's zero.
+	SearchResultLoader(Fetch fetch,
+		unsigned int max_items,
+		unsigned int first_page_size = 100,
+		unsigned int page_size = 500);
+	/// \brief Cancels the search and waits for the page that is being read.
+	~SearchResultLoader();
+
+	/// \brief Reads the first page and returns it, then starts reading the
+	/// rest in the background.
+	///
+	/// Throws whatever \a fetch throws for the first page; errors on the
+	/// later pages end the search and are returned by error().
+	std::vector<std::shared_ptr<RssItem>> start();
+
+	/// \brief Appends the results found since the last call to \a items.
+	void take(std::vector<std::shared_ptr<RssItem>>& items);
+
+	/// \brief Stops the search after the page that is being read.
+	void cancel();
+
+	/// \brief Whether the background thread is still looking for results.
+	bool running() const;
+
+	/// \brief Number of results found so far, including those that
+	/// weren't taken yet.
+	unsigned int count() const;
+
+	/// \brief Whether the search stopped because it found \a max_items
+	/// results.
+	bool truncated() const;
+
+	bool cancelled() const;
+
+	/// \brief Why the search stopped early, or an empty string.
+	std::string error() const;
+
+private:
+	void run();
+	/* how many results the next page may hold without exceeding the cap;
+	 * must be called with `mtx` locked once the worker runs */
+	unsigned int next_page_size(unsigned int page) const;
+
+	const Fetch fetch;
+	const unsigned int max_items;
+	const unsigned int first_page_size;
+	const unsigned int page_size;
+
+	std::thread worker;
+	mutable std::mutex mtx;
+	SearchPosition position;
+	std::vector<std::shared_ptr<RssItem>> found;
+	unsigned int total;
+	bool is_running;
+	bool is_cancelled;
+	std::string error_message;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_SEARCHRESULTLOADER_H_ */
@@ -1,6 +1,8 @@
 #ifndef NEWSBOAT_TAGSOUPPULLPARSER_H_
 #define NEWSBOAT_TAGSOUPPULLPARSER_H_
 
+#include <cstddef>
+#include <istream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,17 +21,34 @@ public:
 
 	TagSoupPullParser();
 	virtual ~TagSoupPullParser();
+
+	/// \brief Reads the whole of \a is and parses that.
 	void set_input(std::istream& is);
+
+	/// \brief Parses \a s in place.
+	///
+	/// \a s is not copied, so it has to stay alive and unchanged for as
+	/// long as next() is called.
+	void set_input(const std::string& s);
+	/* a temporary would be gone before next() reads it */
+	void set_input(std::string&&) = delete;
+
 	std::string get_attribute_value(const std::string& name) const;
 	Event get_event_type() const;
-	std::string get_text() const;
+	const std::string& get_text() const;
 	Event next();
 
 private:
 	typedef std::pair<std::string, std::string> Attribute;
 	std::vector<Attribute> attributes;
 	std::string text;
-	std::istream* inputstream;
+	/* holds the contents of the stream passed to set_input() */
+	std::string buffer;
+	const char* input;
+	size_t input_size;
+	size_t input_pos;
+	/* set once the parser tried to read past the end of the input */
+	bool eof;
 	Event current_event;
 
 	void skip_whitespace();
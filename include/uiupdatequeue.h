@@ -0,0 +1,74 @@
+#ifndef NEWSBOAT_UIUPDATEQUEUE_H_
+#define NEWSBOAT_UIUPDATEQUEUE_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace newsboat {
+
+/// \brief Collects the screen updates that background threads (mostly the
+/// reload threads) ask for, so that they are drawn at a bounded frame rate.
+///
+/// Updates are coalesced: of several status messages posted within a frame,
+/// only the last one is shown, and any number of changes to the dialogs
+/// makes for a single redraw. All methods can be called from any thread.
+class UiUpdateQueue {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/// \brief What was posted since the last take().
+	struct Updates {
+		bool has_status = false;
+		std::string status;
+		/// \brief Number of posts that were coalesced into these
+		/// updates.
+		unsigned int posts = 0;
+	};
+
+	/// \brief Creates a queue that lets a frame be drawn at most every
+	/// \a frame_interval.
+	explicit UiUpdateQueue(std::chrono::milliseconds frame_interval);
+
+	/// \brief Asks for \a msg to be shown in the status line.
+	void post_status(const std::string& msg);
+
+	/// \brief Asks for the screen to be redrawn, e.g. because a list was
+	/// changed.
+	void post_redraw();
+
+	/// \brief Moves everything that was posted into \a updates.
+	///
+	/// Returns false if nothing was posted since the last call.
+	bool take(Updates& updates);
+
+	/// \brief Whether something was posted and the last frame was drawn at
+	/// least a frame interval before \a now.
+	bool frame_due(Clock::time_point now) const;
+
+	/// \brief Records that the screen was drawn at \a now.
+	void frame_drawn(Clock::time_point now);
+
+	/// \brief Whether updates are being posted right now, i.e. something
+	/// was posted during the last second before \a now.
+	///
+	/// The main loop wakes up every frame interval while this is the case.
+	bool busy(Clock::time_point now) const;
+
+	std::chrono::milliseconds frame_interval() const
+	{
+		return interval;
+	}
+
+private:
+	mutable std::mutex mtx;
+	const std::chrono::milliseconds interval;
+	bool pending;
+	Updates updates;
+	Clock::time_point last_post;
+	Clock::time_point last_frame;
+};
+
+} // namespace newsboat
+
+#endif /* NEWSBOAT_UIUPDATEQUEUE_H_ */
@@ -94,6 +94,7 @@ namespace utils {
 	std::string wstr2str(const std::wstring& wstr);
 
 	std::wstring clean_nonprintable_characters(std::wstring text);
+	std::string clean_nonprintable_characters(const std::string& text);
 
 	std::wstring utf8str2wstr(const std::string& utf8str);
 
@@ -108,6 +109,12 @@ namespace utils {
 
 	std::string substr_with_width(const std::string& str,
 		const size_t max_width);
+	// number of bytes of `str`, starting at `pos`, that fit into
+	// `max_width` columns; their width is added to `width`
+	size_t fit_width(const std::string& str,
+		size_t pos,
+		const size_t max_width,
+		size_t& width);
 
 	unsigned int to_u(const std::string& str,
 		const unsigned int default_value = 0);
@@ -175,6 +182,8 @@ namespace utils {
 
 	std::string get_default_browser();
 
+	std::string content_digest(const std::string& data);
+
 }
 
 } // namespace newsboat
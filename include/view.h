@@ -1,9 +1,12 @@
 #ifndef NEWSBOAT_VIEW_H_
 #define NEWSBOAT_VIEW_H_
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "colormanager.h"
@@ -11,10 +14,14 @@
 #include "controller.h"
 #include "filebrowserformaction.h"
 #include "htmlrenderer.h"
+#include "itemprerenderer.h"
+#include "itemrendercache.h"
 #include "keymap.h"
+#include "latencyrecorder.h"
 #include "regexmanager.h"
 #include "rss.h"
 #include "stflpp.h"
+#include "uiupdatequeue.h"
 
 namespace newsboat {
 
@@ -31,11 +38,26 @@ public:
 
 	void set_feedlist(std::vector<std::shared_ptr<RssFeed>> feeds);
 	void update_visible_feeds(std::vector<std::shared_ptr<RssFeed>> feeds);
+	/// \brief Updates the feed list after the feed at \a pos has replaced
+	/// \a oldfeed, without rebuilding all of it if possible.
+	void update_feed(std::vector<std::shared_ptr<RssFeed>>& feeds,
+		unsigned int pos,
+		std::shared_ptr<RssFeed> oldfeed);
 	void set_keymap(KeyMap* k);
 	void set_config_container(ConfigContainer* cfgcontainer);
 	void show_error(const std::string& msg);
+	/// \brief Shows \a msg in the status line.
+	///
+	/// Called from another thread than the one running the main loop,
+	/// the message is only queued; it is drawn with the next frame.
 	void set_status(const std::string& msg);
 	void set_status_unlocked(const std::string& msg);
+	/// \brief Draws whatever other threads have queued, without waiting
+	/// for the next frame.
+	///
+	/// Meant for the end of a reload, so that its last status message
+	/// doesn't wait for a key press.
+	void flush_updates();
 	Controller* get_ctrl()
 	{
 		return ctrl;
@@ -59,6 +81,9 @@ public:
 	}
 	char confirm(const std::string& prompt, const std::string& charset);
 
+	/// \brief Creates the feed list, which stays at the bottom of the
+	/// formaction stack.
+	void push_feedlist();
 	void push_itemlist(unsigned int pos);
 	void push_itemlist(std::shared_ptr<RssFeed> feed);
 	void push_itemview(std::shared_ptr<RssFeed> f,
@@ -67,8 +92,12 @@ public:
 	void push_help();
 	void push_urlview(const std::vector<LinkPair>& links,
 		std::shared_ptr<RssFeed>& feed);
+	/// \brief Shows the articles in \a feed as the results of searching
+	/// for \a phrase. If there is a \a loader, the results it finds later
+	/// are added while the list is shown.
 	void push_searchresult(std::shared_ptr<RssFeed> feed,
-		const std::string& phrase = "");
+		const std::string& phrase = "",
+		std::shared_ptr<SearchResultLoader> loader = nullptr);
 	void view_dialogs();
 
 	std::string run_filebrowser(const std::string& default_filename = "",
@@ -148,6 +177,9 @@ protected:
 	void cancel_input(std::shared_ptr<FormAction> fa);
 	void delete_word(std::shared_ptr<FormAction> fa);
 
+	bool on_ui_thread() const;
+	void draw_updates_unlocked(bool force);
+
 	Controller* ctrl;
 
 	ConfigContainer* cfg;
@@ -162,6 +194,11 @@ protected:
 	std::vector<std::string> tags;
 
 	RegexManager* rxman;
+	/* shared by all article views, so that articles rendered in one of
+	 * them can be shown again in the next */
+	ItemRenderCache item_render_cache;
+	/* created with the first article view */
+	std::unique_ptr<ItemPrerenderer> item_prerenderer;
 
 	std::map<std::string, std::string> fg_colors;
 	std::map<std::string, std::string> bg_colors;
@@ -175,6 +212,15 @@ protected:
 	Cache* rsscache;
 	FilterContainer* filters;
 	std::vector<std::string> suggestions;
+
+	/* updates posted by other threads, and when they may be drawn */
+	UiUpdateQueue ui_updates;
+	/* the thread running the main loop */
+	std::thread::id ui_thread;
+	/* set while the main loop wakes up every frame to draw posted
+	 * updates itself */
+	std::atomic<bool> ui_polling;
+	LatencyRecorder input_latency;
 };
 
 } // namespace newsboat
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "config.h"
+#include "dateparser.h"
 #include "utils.h"
 
 namespace rsspp {
@@ -58,7 +59,8 @@ Item AtomParser::parse_entry(xmlNode* entryNode)
 	Item it;
 	std::string summary;
 	std::string summary_type;
-	std::string updated;
+	time_t published = -1;
+	time_t updated = -1;
 
 	std::string base = get_prop(entryNode, "base", XML_URI);
 	if (base == "")
@@ -101,9 +103,9 @@ Item AtomParser::parse_entry(xmlNode* entryNode)
 			it.guid = get_content(node);
 			it.guid_isPermaLink = false;
 		} else if (node_is(node, "published", ns)) {
-			it.pubDate = w3cdtf_to_rfc822(get_content(node));
+			published = parse_date(get_content(node));
 		} else if (node_is(node, "updated", ns)) {
-			updated = w3cdtf_to_rfc822(get_content(node));
+			updated = parse_date(get_content(node));
 		} else if (node_is(node, "link", ns)) {
 			std::string rel = get_prop(node, "rel");
 			if (rel == "" || rel == "alternate") {
@@ -145,9 +147,7 @@ Item AtomParser::parse_entry(xmlNode* entryNode)
 		it.description_type = summary_type;
 	}
 
-	if (it.pubDate == "") {
-		it.pubDate = updated;
-	}
+	set_item_date(it, published != -1 ? published : updated);
 
 	return it;
 }
@@ -0,0 +1,540 @@
+#include "dateparser.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+namespace rsspp {
+
+/*
+ * The RFC 822 part of this file deliberately follows the rules of curl's
+ * parsedate.c, which is what newsboat used to hand all dates to: the same
+ * words are recognized, numbers are assigned to fields in the same order,
+ * and parsing stops after six parts. This way, dates that used to work keep
+ * resolving to the same timestamps.
+ */
+
+struct TimezoneName {
+	const char* name;
+	/* minutes *west* of UTC, so that it can be added to the local time */
+	int offset;
+};
+
+static const int daylight = -60;
+
+static const TimezoneName timezones[] = {
+	{"GMT", 0},
+	{"UT", 0},
+	{"UTC", 0},
+	{"WET", 0},
+	{"BST", 0 + daylight},
+	{"WAT", 60},
+	{"AST", 240},
+	{"ADT", 240 + daylight},
+	{"EST", 300},
+	{"EDT", 300 + daylight},
+	{"CST", 360},
+	{"CDT", 360 + daylight},
+	{"MST", 420},
+	{"MDT", 420 + daylight},
+	{"PST", 480},
+	{"PDT", 480 + daylight},
+	{"YST", 540},
+	{"YDT", 540 + daylight},
+	{"HST", 600},
+	{"HDT", 600 + daylight},
+	{"CAT", 600},
+	{"AHST", 600},
+	{"NT", 660},
+	{"IDLW", 720},
+	{"CET", -60},
+	{"MET", -60},
+	{"MEWT", -60},
+	{"MEST", -60 + daylight},
+	{"CEST", -60 + daylight},
+	{"MESZ", -60 + daylight},
+	{"FWT", -60},
+	{"FST", -60 + daylight},
+	{"EET", -120},
+	{"WAST", -420},
+	{"WADT", -420 + daylight},
+	{"CCT", -480},
+	{"JST", -540},
+	{"EAST", -600},
+	{"EADT", -600 + daylight},
+	{"GST", -600},
+	{"NZT", -720},
+	{"NZST", -720},
+	{"NZDT", -720 + daylight},
+	{"IDLE", -720},
+	/* military zones, with the signs curl uses */
+	{"A", 1 * 60},
+	{"B", 2 * 60},
+	{"C", 3 * 60},
+	{"D", 4 * 60},
+	{"E", 5 * 60},
+	{"F", 6 * 60},
+	{"G", 7 * 60},
+	{"H", 8 * 60},
+	{"I", 9 * 60},
+	{"K", 10 * 60},
+	{"L", 11 * 60},
+	{"M", 12 * 60},
+	{"N", -1 * 60},
+	{"O", -2 * 60},
+	{"P", -3 * 60},
+	{"Q", -4 * 60},
+	{"R", -5 * 60},
+	{"S", -6 * 60},
+	{"T", -7 * 60},
+	{"U", -8 * 60},
+	{"V", -9 * 60},
+	{"W", -10 * 60},
+	{"X", -11 * 60},
+	{"Y", -12 * 60},
+	{"Z", 0},
+};
+
+static const char* const short_weekdays[] = {
+	"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+static const char* const long_weekdays[] = {"Monday",
+	"Tuesday",
+	"Wednesday",
+	"Thursday",
+	"Friday",
+	"Saturday",
+	"Sunday"};
+static const char* const short_months[] = {"Jan",
+	"Feb",
+	"Mar",
+	"Apr",
+	"May",
+	"Jun",
+	"Jul",
+	"Aug",
+	"Sep",
+	"Oct",
+	"Nov",
+	"Dec"};
+static const char* const long_months[] = {"January",
+	"February",
+	"March",
+	"April",
+	"May",
+	"June",
+	"July",
+	"August",
+	"September",
+	"October",
+	"November",
+	"December"};
+
+static bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool is_alpha(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+		c == '\v';
+}
+
+static bool word_is(const char* word, size_t length, const char* name)
+{
+	for (size_t i = 0; i < length; ++i) {
+		char c = word[i];
+		if (c >= 'A' && c <= 'Z') {
+			c += 'a' - 'A';
+		}
+		char n = name[i];
+		if (n >= 'A' && n <= 'Z') {
+			n += 'a' - 'A';
+		}
+		if (n == '\0' || c != n) {
+			return false;
+		}
+	}
+	return name[length] == '\0';
+}
+
+static int find_word(const char* word,
+	size_t length,
+	const char* const* names,
+	size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		if (word_is(word, length, names[i])) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Reads between one and \a max_digits digits. */
+static bool read_number(const char*& p,
+	const char* end,
+	size_t max_digits,
+	int& value)
+{
+	const char* q = p;
+	int result = 0;
+	while (q < end && is_digit(*q) && size_t(q - p) < max_digits) {
+		result = result * 10 + (*q - '0');
+		++q;
+	}
+	if (q == p) {
+		return false;
+	}
+	value = result;
+	p = q;
+	return true;
+}
+
+/* Same calculation as curl's time2epoch(), so that out-of-range days of the
+ * month ("31 Feb") roll over into the next month the same way. */
+static time_t to_timestamp(int year, int month, int mday, int hour, int min,
+	int sec)
+{
+	static const int days_before_month[12] = {
+		0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+	int leap_days = year - (month <= 1);
+	leap_days = leap_days / 4 - leap_days / 100 + leap_days / 400 -
+		1969 / 4 + 1969 / 100 - 1969 / 400;
+	const time_t days = static_cast<time_t>(year - 1970) * 365 +
+		leap_days + days_before_month[month] + mday - 1;
+	return ((days * 24 + hour) * 60 + min) * 60 + sec;
+}
+
+/* "hh:mm[:ss[.fraction]]", with one or two digits per field. */
+static bool read_clock(const char*& p,
+	const char* end,
+	int& hour,
+	int& min,
+	int& sec)
+{
+	const char* q = p;
+	if (!read_number(q, end, 2, hour) || q == end || *q != ':') {
+		return false;
+	}
+	++q;
+	if (!read_number(q, end, 2, min)) {
+		return false;
+	}
+	sec = 0;
+	if (end - q >= 2 && q[0] == ':' && is_digit(q[1])) {
+		++q;
+		read_number(q, end, 2, sec);
+		if (end - q >= 2 && q[0] == '.' && is_digit(q[1])) {
+			++q;
+			while (q < end && is_digit(*q)) {
+				++q;
+			}
+		}
+	}
+	p = q;
+	return true;
+}
+
+static time_t parse_rfc822(const char* begin, const char* end)
+{
+	int wday = -1;
+	int month = -1;
+	int mday = -1;
+	int year = -1;
+	int hour = -1;
+	int min = -1;
+	int sec = -1;
+	bool have_zone = false;
+	time_t zone_offset = 0;
+	enum { DAY_NEXT, YEAR_NEXT } next_number = DAY_NEXT;
+
+	const char* p = begin;
+	for (int part = 0; part < 6; ++part) {
+		while (p < end && !is_alpha(*p) && !is_digit(*p)) {
+			++p;
+		}
+		if (p == end) {
+			break;
+		}
+
+		if (is_alpha(*p)) {
+			const char* word = p;
+			while (p < end && is_alpha(*p)) {
+				++p;
+			}
+			const size_t length = p - word;
+
+			bool found = false;
+			if (wday == -1) {
+				wday = find_word(word,
+					length,
+					length == 3 ? short_weekdays : long_weekdays,
+					7);
+				found = wday != -1;
+			}
+			if (!found && month == -1) {
+				month = find_word(word,
+					length,
+					length == 3 ? short_months : long_months,
+					12);
+				found = month != -1;
+			}
+			if (!found && !have_zone) {
+				for (const auto& tz : timezones) {
+					if (word_is(word, length, tz.name)) {
+						zone_offset = tz.offset * 60;
+						have_zone = found = true;
+						break;
+					}
+				}
+			}
+			if (!found) {
+				return -1;
+			}
+			continue;
+		}
+
+		if (sec == -1 && read_clock(p, end, hour, min, sec)) {
+			continue;
+		}
+
+		const bool has_sign =
+			p > begin && (p[-1] == '+' || p[-1] == '-');
+
+		/* "+01:00" isn't RFC 822, but it's common enough */
+		if (!have_zone && has_sign && sec != -1 && end - p >= 5 &&
+			is_digit(p[0]) && is_digit(p[1]) && p[2] == ':' &&
+			is_digit(p[3]) && is_digit(p[4])) {
+			const int minutes = ((p[0] - '0') * 10 + (p[1] - '0')) * 60 +
+				(p[3] - '0') * 10 + (p[4] - '0');
+			zone_offset = (p[-1] == '+' ? -minutes : minutes) * 60;
+			have_zone = true;
+			p += 5;
+			continue;
+		}
+
+		const char* digits = p;
+		long long value = 0;
+		while (p < end && is_digit(*p)) {
+			value = value * 10 + (*p - '0');
+			if (value > INT_MAX) {
+				return -1;
+			}
+			++p;
+		}
+		const int val = value;
+		const size_t length = p - digits;
+
+		bool found = false;
+		if (!have_zone && length == 4 && val <= 1400 && has_sign) {
+			const int minutes = val / 100 * 60 + val % 100;
+			zone_offset = (digits[-1] == '+' ? -minutes : minutes) * 60;
+			have_zone = found = true;
+		}
+
+		if (length == 8 && year == -1 && month == -1 && mday == -1) {
+			/* YYYYMMDD */
+			year = val / 10000;
+			month = (val % 10000) / 100 - 1;
+			mday = val % 100;
+			found = true;
+		}
+
+		if (!found && next_number == DAY_NEXT && mday == -1) {
+			if (val > 0 && val < 32) {
+				mday = val;
+				found = true;
+			}
+			next_number = YEAR_NEXT;
+		}
+
+		if (!found && next_number == YEAR_NEXT && year == -1) {
+			year = val;
+			if (year < 100) {
+				year += (year > 70) ? 1900 : 2000;
+			}
+			if (mday == -1) {
+				next_number = DAY_NEXT;
+			}
+			found = true;
+		}
+
+		if (!found) {
+			return -1;
+		}
+	}
+
+	if (sec == -1) {
+		hour = min = sec = 0;
+	}
+
+	if (mday == -1 || month == -1 || year == -1) {
+		return -1;
+	}
+
+	/* the Gregorian calendar was introduced in 1582 */
+	if (year < 1583 || mday > 31 || month > 11 || hour > 23 || min > 59 ||
+		sec > 60) {
+		return -1;
+	}
+
+	return to_timestamp(year, month, mday, hour, min, sec) + zone_offset;
+}
+
+/* Reads a separator that is one of \a separators, followed by a one- or
+ * two-digit number between \a min and \a max. */
+static bool read_field(const char*& p,
+	const char* end,
+	const char* separators,
+	int min,
+	int max,
+	int& value)
+{
+	if (p == end || std::strchr(separators, *p) == nullptr) {
+		return false;
+	}
+	const char* q = p + 1;
+	int result;
+	if (!read_number(q, end, 2, result) || result < min || result > max) {
+		return false;
+	}
+	value = result;
+	p = q;
+	return true;
+}
+
+/*
+ * Fields are read left to right until one doesn't fit; everything after it
+ * keeps its default value, just like the strptime()-based parser this
+ * replaces. \a complete tells whether the whole string was consumed.
+ */
+static time_t parse_w3cdtf(const char* p, const char* end, bool& complete)
+{
+	complete = false;
+
+	if (end - p < 4 || !is_digit(p[0]) || !is_digit(p[1]) ||
+		!is_digit(p[2]) || !is_digit(p[3]) ||
+		(end - p > 4 && is_digit(p[4]))) {
+		return -1;
+	}
+	int year = 0;
+	read_number(p, end, 4, year);
+
+	int month = 1;
+	int mday = 1;
+	int hour = 0;
+	int min = 0;
+	int sec = 0;
+	time_t zone_offset = 0;
+
+	if (read_field(p, end, "-", 1, 12, month) &&
+		read_field(p, end, "-", 1, 31, mday) &&
+		read_field(p, end, "Tt ", 0, 23, hour) &&
+		read_field(p, end, ":", 0, 59, min)) {
+		if (read_field(p, end, ":", 0, 60, sec) && end - p >= 2 &&
+			p[0] == '.' && is_digit(p[1])) {
+			++p;
+			while (p < end && is_digit(*p)) {
+				++p;
+			}
+		}
+
+		if (p < end && (*p == 'Z' || *p == 'z')) {
+			++p;
+		} else if (p < end && (*p == '+' || *p == '-')) {
+			const char sign = *p;
+			const char* q = p + 1;
+			int hours;
+			int minutes = 0;
+			if (read_number(q, end, 2, hours)) {
+				if (q < end && *q == ':') {
+					++q;
+				}
+				if (end - q >= 2 && is_digit(q[0]) &&
+					is_digit(q[1])) {
+					read_number(q, end, 2, minutes);
+				}
+				zone_offset = (hours * 60 + minutes) * 60;
+				if (sign == '+') {
+					zone_offset = -zone_offset;
+				}
+				p = q;
+			}
+		}
+	}
+
+	complete = (p == end);
+	return to_timestamp(year, month - 1, mday, hour, min, sec) +
+		zone_offset;
+}
+
+static void trim(const char*& begin, const char*& end)
+{
+	while (begin < end && is_space(*begin)) {
+		++begin;
+	}
+	while (end > begin && is_space(end[-1])) {
+		--end;
+	}
+}
+
+time_t parse_date(const std::string& date)
+{
+	const char* begin = date.data();
+	const char* end = begin + date.length();
+	trim(begin, end);
+
+	bool complete;
+	const time_t w3cdtf = parse_w3cdtf(begin, end, complete);
+	if (complete) {
+		return w3cdtf;
+	}
+
+	const time_t rfc822 = parse_rfc822(begin, end);
+	if (rfc822 != -1) {
+		return rfc822;
+	}
+
+	// whatever could be made of the beginning of a W3CDTF date
+	return w3cdtf;
+}
+
+time_t parse_w3cdtf_date(const std::string& date)
+{
+	const char* begin = date.data();
+	const char* end = begin + date.length();
+	trim(begin, end);
+
+	bool complete;
+	return parse_w3cdtf(begin, end, complete);
+}
+
+std::string format_rfc822_date(time_t t)
+{
+	struct tm stm;
+	if (gmtime_r(&t, &stm) == nullptr) {
+		return "";
+	}
+
+	// tm_wday counts from Sunday
+	char buf[64];
+	snprintf(buf,
+		sizeof(buf),
+		"%s, %02d %s %04d %02d:%02d:%02d +0000",
+		short_weekdays[(stm.tm_wday + 6) % 7],
+		stm.tm_mday,
+		short_months[stm.tm_mon],
+		stm.tm_year + 1900,
+		stm.tm_hour,
+		stm.tm_min,
+		stm.tm_sec);
+	return buf;
+}
+
+} // namespace rsspp
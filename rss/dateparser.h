@@ -0,0 +1,34 @@
+#ifndef NEWSBOAT_DATEPARSER_H_
+#define NEWSBOAT_DATEPARSER_H_
+
+#include <ctime>
+#include <string>
+
+namespace rsspp {
+
+/// \brief Converts a date found in a feed into a UNIX timestamp.
+///
+/// Understands RFC 822 dates and their RFC 850, RFC 1123 and asctime()
+/// relatives (the same set curl_getdate() accepts), as well as RFC 3339 and
+/// W3CDTF dates. On top of that, a few common mistakes are tolerated:
+/// fractional seconds in RFC 822 dates, "+hh:mm" zones, full month names,
+/// and a space instead of "T" between date and time in W3CDTF.
+///
+/// Dates without a timezone are taken to be in UTC. Returns -1 if \a date
+/// couldn't be parsed.
+time_t parse_date(const std::string& date);
+
+/// \brief Parses an RFC 3339/W3CDTF date ("2008-12-30T10:03:15-08:00").
+///
+/// Every part after the year is optional; missing parts default to the
+/// beginning of the period. Returns -1 if \a date doesn't start with a
+/// four-digit year.
+time_t parse_w3cdtf_date(const std::string& date);
+
+/// \brief Formats \a t as an RFC 822 date in UTC, e.g.
+/// "Tue, 30 Dec 2008 18:03:15 +0000".
+std::string format_rfc822_date(time_t t);
+
+} // namespace rsspp
+
+#endif /* NEWSBOAT_DATEPARSER_H_ */
@@ -6,6 +6,7 @@
 #include <libxml/tree.h>
 
 #include "config.h"
+#include "dateparser.h"
 #include "logger.h"
 #include "remoteapi.h"
 #include "rssppinternal.h"
@@ -66,16 +67,15 @@ static size_t handle_headers(void* ptr, size_t size, size_t nmemb, void* data)
 	header[size * nmemb] = '\0';
 
 	if (!strncasecmp("Last-Modified:", header, 14)) {
-		time_t r = curl_getdate(header + 14, nullptr);
+		time_t r = parse_date(header + 14);
 		if (r == -1) {
 			LOG(Level::DEBUG,
 				"handle_headers: last-modified %s "
-				"(curl_getdate "
+				"(parse_date "
 				"FAILED)",
 				header + 14);
 		} else {
-			values->lastmodified =
-				curl_getdate(header + 14, nullptr);
+			values->lastmodified = r;
 			LOG(Level::DEBUG,
 				"handle_headers: got last-modified %s (%d)",
 				header + 14,
@@ -99,6 +99,28 @@ Feed Parser::parse_url(const std::string& url,
 	const std::string& cookie_cache,
 	CURL* ehandle)
 {
+	const std::string buf = fetch_url(
+		url, lastmodified, etag, api, cookie_cache, ehandle);
+
+	if (buf.length() > 0) {
+		LOG(Level::DEBUG,
+			"Parser::parse_url: handing over data to "
+			"parse_buffer()");
+		return parse_buffer(buf, url);
+	}
+
+	return Feed();
+}
+
+std::string Parser::fetch_url(const std::string& url,
+	time_t lastmodified,
+	const std::string& etag,
+	newsboat::RemoteApi* api,
+	const std::string& cookie_cache,
+	CURL* ehandle)
+{
+	ScopeMeasure m1("rsspp::Parser::fetch_url");
+
 	std::string buf;
 	CURLcode ret;
 	curl_slist* custom_headers{};
@@ -190,7 +212,7 @@ Feed Parser::parse_url(const std::string& url,
 	}
 
 	LOG(Level::DEBUG,
-		"rsspp::Parser::parse_url: ret = %d (%s)",
+		"rsspp::Parser::fetch_url: ret = %d (%s)",
 		ret,
 		curl_easy_strerror(ret));
 
@@ -209,7 +231,7 @@ Feed Parser::parse_url(const std::string& url,
 
 	if (ret != 0) {
 		LOG(Level::ERROR,
-			"rsspp::Parser::parse_url: curl_easy_perform returned "
+			"rsspp::Parser::fetch_url: curl_easy_perform returned "
 			"err "
 			"%d: %s",
 			ret,
@@ -225,22 +247,17 @@ Feed Parser::parse_url(const std::string& url,
 	}
 
 	LOG(Level::INFO,
-		"Parser::parse_url: retrieved data for %s: %s",
+		"Parser::fetch_url: retrieved data for %s: %s",
 		url,
 		buf);
 
-	if (buf.length() > 0) {
-		LOG(Level::DEBUG,
-			"Parser::parse_url: handing over data to "
-			"parse_buffer()");
-		return parse_buffer(buf, url);
-	}
-
-	return Feed();
+	return buf;
 }
 
 Feed Parser::parse_buffer(const std::string& buffer, const std::string& url)
 {
+	ScopeMeasure m1("rsspp::Parser::parse_buffer");
+
 	doc = xmlReadMemory(buffer.c_str(),
 		buffer.length(),
 		url.c_str(),
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "config.h"
+#include "dateparser.h"
 #include "utils.h"
 
 using namespace newsboat;
@@ -62,7 +63,7 @@ Item Rss09xParser::parse_item(xmlNode* itemNode)
 {
 	Item it;
 	std::string author;
-	std::string dc_date;
+	time_t dc_date = -1;
 
 	std::string base = get_prop(itemNode, "base", XML_URI);
 	if (base.empty())
@@ -95,7 +96,7 @@ Item Rss09xParser::parse_item(xmlNode* itemNode)
 		} else if (node_is(node, "pubDate", ns)) {
 			it.pubDate = get_content(node);
 		} else if (node_is(node, "date", DC_URI)) {
-			dc_date = w3cdtf_to_rfc822(get_content(node));
+			dc_date = parse_date(get_content(node));
 		} else if (node_is(node, "author", ns)) {
 			std::string authorfield = get_content(node);
 			if (authorfield[authorfield.length() - 1] == ')') {
@@ -150,7 +151,12 @@ Item Rss09xParser::parse_item(xmlNode* itemNode)
 	}
 
 	if (it.pubDate == "") {
-		it.pubDate = dc_date;
+		set_item_date(it, dc_date);
+	} else {
+		const time_t date = parse_date(it.pubDate);
+		if (date != -1) {
+			it.pubDate_ts = date;
+		}
 	}
 
 	return it;
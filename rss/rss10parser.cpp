@@ -1,8 +1,10 @@
 #include "rssppinternal.h"
 
 #include <cstring>
+#include <utility>
 
 #include "config.h"
+#include "dateparser.h"
 
 #define RSS_1_0_NS "http://purl.org/rss/1.0/"
 
@@ -52,8 +54,8 @@ void Rss10Parser::parse_feed(Feed& f, xmlNode* rootNode)
 						   RSS_1_0_NS)) {
 					it.description = get_content(itnode);
 				} else if (node_is(itnode, "date", DC_URI)) {
-					it.pubDate = w3cdtf_to_rfc822(
-						get_content(itnode));
+					set_item_date(it,
+						parse_date(get_content(itnode)));
 				} else if (node_is(itnode,
 						   "encoded",
 						   CONTENT_URI)) {
@@ -67,7 +69,7 @@ void Rss10Parser::parse_feed(Feed& f, xmlNode* rootNode)
 					it.author = get_content(itnode);
 				}
 			}
-			f.items.push_back(it);
+			f.items.push_back(std::move(it));
 		}
 	}
 }
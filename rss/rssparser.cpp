@@ -3,6 +3,8 @@
 #include <cstring>
 #include <libxml/tree.h>
 
+#include "dateparser.h"
+
 namespace rsspp {
 
 std::string RssParser::get_content(xmlNode* node)
@@ -82,61 +84,22 @@ std::string RssParser::w3cdtf_to_rfc822(const std::string& w3cdtf)
 
 std::string RssParser::__w3cdtf_to_rfc822(const std::string& w3cdtf)
 {
-	if (w3cdtf.empty()) {
+	const time_t t = parse_w3cdtf_date(w3cdtf);
+	if (t == -1) {
 		return "";
 	}
+	return format_rfc822_date(t);
+}
 
-	struct tm stm;
-	memset(&stm, 0, sizeof(stm));
-	stm.tm_mday = 1;
-
-	char* ptr = strptime(w3cdtf.c_str(), "%Y", &stm);
-
-	if (ptr != nullptr) {
-		ptr = strptime(ptr, "-%m", &stm);
+void RssParser::set_item_date(Item& it, time_t date)
+{
+	if (date == -1) {
+		it.pubDate.clear();
+		it.pubDate_ts = 0;
 	} else {
-		return "";
-	}
-
-	if (ptr != nullptr) {
-		ptr = strptime(ptr, "-%d", &stm);
+		it.pubDate = format_rfc822_date(date);
+		it.pubDate_ts = date;
 	}
-	if (ptr != nullptr) {
-		ptr = strptime(ptr, "T%H", &stm);
-	}
-	if (ptr != nullptr) {
-		ptr = strptime(ptr, ":%M", &stm);
-	}
-	if (ptr != nullptr) {
-		ptr = strptime(ptr, ":%S", &stm);
-	}
-
-	int offs = 0;
-	if (ptr != nullptr) {
-		if (ptr[0] == '+' || ptr[0] == '-') {
-			unsigned int hour, min;
-			if (sscanf(ptr + 1, "%02u:%02u", &hour, &min) == 2) {
-				offs = 60 * 60 * hour + 60 * min;
-				if (ptr[0] == '+')
-					offs = -offs;
-				stm.tm_gmtoff = offs;
-			}
-		} else if (ptr[0] == 'Z') {
-			stm.tm_gmtoff = 0;
-		}
-	}
-
-	// tm_isdst will force mktime to consider DST, like localtime(), but
-	// then the offset will be zeroed out, since that was manually added
-	// https://github.com/akrennmair/newsbeuter/issues/369
-	stm.tm_isdst = -1;
-	time_t gmttime = mktime(&stm) + offs;
-	char datebuf[256];
-	strftime(datebuf,
-		sizeof(datebuf),
-		"%a, %d %b %Y %H:%M:%S +0000",
-		localtime(&gmttime));
-	return datebuf;
 }
 
 bool RssParser::node_is(xmlNode* node, const char* name, const char* ns_uri)
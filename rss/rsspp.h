@@ -58,7 +58,8 @@ public:
 	std::string base;
 	std::vector<std::string> labels;
 
-	// only required for ttrss support:
+	// pubDate as a timestamp, or 0 if the format parser didn't manage to
+	// make sense of it:
 	time_t pubDate_ts;
 };
 
@@ -109,6 +110,18 @@ public:
 		newsboat::RemoteApi* api = 0,
 		const std::string& cookie_cache = "",
 		CURL* ehandle = 0);
+	/// \brief Downloads \a url without parsing it.
+	///
+	/// Makes a conditional request if \a lastmodified or \a etag are set;
+	/// an empty string is returned if the server answered "304 Not
+	/// Modified". New header values are available through
+	/// get_last_modified() and get_etag() afterwards.
+	std::string fetch_url(const std::string& url,
+		time_t lastmodified = 0,
+		const std::string& etag = "",
+		newsboat::RemoteApi* api = 0,
+		const std::string& cookie_cache = "",
+		CURL* ehandle = 0);
 	Feed parse_buffer(const std::string& buffer,
 		const std::string& url = "");
 	Feed parse_file(const std::string& filename);
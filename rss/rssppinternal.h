@@ -34,6 +34,7 @@ protected:
 		const std::string& prop,
 		const std::string& ns = "");
 	std::string w3cdtf_to_rfc822(const std::string& w3cdtf);
+	void set_item_date(Item& it, time_t date);
 	bool
 	node_is(xmlNode* node, const char* name, const char* ns_uri = nullptr);
 	xmlDocPtr doc;
@@ -1,5 +1,6 @@
 #include "cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
@@ -209,14 +210,18 @@ static int fill_content_callback(void* myfeed,
 	return 0;
 }
 
-static int search_item_callback(void* myfeed,
+struct SearchPage {
+	std::vector<std::shared_ptr<RssItem>> items;
+	SearchPosition* position;
+};
+
+static int search_item_callback(void* mypage,
 	int argc,
 	char** argv,
 	char** /* azColName */)
 {
-	std::vector<std::shared_ptr<RssItem>>* items =
-		static_cast<std::vector<std::shared_ptr<RssItem>>*>(myfeed);
-	assert(argc == 13);
+	SearchPage* page = static_cast<SearchPage*>(mypage);
+	assert(argc == 14);
 	std::shared_ptr<RssItem> item(new RssItem(nullptr));
 	item->set_guid(argv[0]);
 	item->set_title(argv[1]);
@@ -238,7 +243,11 @@ static int search_item_callback(void* myfeed,
 	item->set_flags(argv[11] ? argv[11] : "");
 	item->set_base(argv[12] ? argv[12] : "");
 
-	items->push_back(item);
+	page->position->started = true;
+	page->position->pubDate = t;
+	page->position->id = std::strtoll(argv[13], nullptr, 10);
+
+	page->items.push_back(item);
 	return 0;
 }
 
@@ -369,7 +378,22 @@ static const schema_patches schemaPatches{
 		 " db_schema_version_major INTEGER NOT NULL, "
 		 " db_schema_version_minor INTEGER NOT NULL );"
 
-		 "INSERT INTO metadata VALUES ( 2, 11 );"}}};
+		 "INSERT INTO metadata VALUES ( 2, 11 );"}},
+	{{2, 14},
+		{
+			/* fingerprint of the last output of exec: and filter:
+			 * feeds, used in place of Last-Modified/ETag */
+			"ALTER TABLE rss_feed ADD content_hash VARCHAR(128) "
+			"NOT NULL DEFAULT \"\";",
+
+			/* lets searches read matches newest first without
+			 * sorting them */
+			"CREATE INDEX IF NOT EXISTS idx_deleted_pubdate ON "
+			"rss_item(deleted, pubDate);",
+
+			"UPDATE metadata SET db_schema_version_major = 2, "
+			"db_schema_version_minor = 14;",
+		}}};
 
 void Cache::populate_tables()
 {
@@ -449,6 +473,28 @@ void Cache::update_lastmodified(const std::string& feedurl,
 	run_sql_nothrow(query);
 }
 
+void Cache::fetch_content_hash(const std::string& feedurl, std::string& hash)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::string query = prepare_query(
+		"SELECT content_hash FROM rss_feed WHERE rssurl = '%q';",
+		feedurl);
+	hash.clear();
+	run_sql(query, single_string_callback, &hash);
+	LOG(Level::DEBUG, "Cache::fetch_content_hash: hash = %s", hash);
+}
+
+void Cache::update_content_hash(const std::string& feedurl,
+	const std::string& hash)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::string query = prepare_query(
+		"UPDATE rss_feed SET content_hash = '%q' WHERE rssurl = '%q';",
+		hash,
+		feedurl);
+	run_sql_nothrow(query);
+}
+
 void Cache::mark_item_deleted(const std::string& guid, bool b)
 {
 	std::lock_guard<std::mutex> lock(mtx);
@@ -575,6 +621,27 @@ std::shared_ptr<RssFeed> Cache::internalize_rssfeed(std::string rssurl,
 		rssurl);
 	run_sql(query, rssfeed_callback, &feed);
 
+	/* Ignore rules that can be expressed in SQL are applied right in the
+	 * query, so that ignored items aren't even loaded. The rest is checked
+	 * in memory below. */
+	std::string ignore_condition;
+	std::vector<Matcher*> ignore_matchers;
+	if (ign) {
+		for (Matcher* m : ign->rules_for(rssurl)) {
+			std::string condition;
+			if (m->to_sql(condition)) {
+				ignore_condition.append(" AND NOT " + condition);
+			} else {
+				ignore_matchers.push_back(m);
+			}
+		}
+		LOG(Level::DEBUG,
+			"Cache::internalize_rssfeed: ignore condition `%s', %u "
+			"rules left to check in memory",
+			ignore_condition,
+			ignore_matchers.size());
+	}
+
 	/* ...and then the associated items */
 	query = prepare_query(
 		"SELECT guid, title, author, url, pubDate, length(content), "
@@ -582,15 +649,21 @@ std::shared_ptr<RssFeed> Cache::internalize_rssfeed(std::string rssurl,
 		"feedurl, enclosure_url, enclosure_type, enqueued, flags, base "
 		"FROM rss_item "
 		"WHERE feedurl = '%q' "
-		"AND deleted = 0 "
+		"AND deleted = 0%s "
 		"ORDER BY pubDate DESC, id DESC;",
-		rssurl);
+		rssurl,
+		ignore_condition);
 	run_sql(query, rssitem_callback, &feed);
 
 	std::vector<std::shared_ptr<RssItem>> filtered_items;
 	for (const auto& item : feed->items()) {
 		try {
-			if (!ign || !ign->matches(item.get())) {
+			const bool ignored = std::any_of(ignore_matchers.begin(),
+					ignore_matchers.end(),
+					[&](Matcher* m) {
+						return m->matches(item.get());
+					});
+			if (!ignored) {
 				item->set_cache(this);
 				item->set_feedptr(feed);
 				item->set_feedurl(feed->rssurl());
@@ -630,46 +703,68 @@ std::shared_ptr<RssFeed> Cache::internalize_rssfeed(std::string rssurl,
 
 std::vector<std::shared_ptr<RssItem>>
 Cache::search_for_items(const std::string& querystr, const std::string& feedurl)
+{
+	SearchPosition position;
+	return search_for_items(querystr, feedurl, position, 0);
+}
+
+std::vector<std::shared_ptr<RssItem>> Cache::search_for_items(
+	const std::string& querystr,
+	const std::string& feedurl,
+	SearchPosition& position,
+	unsigned int limit)
 {
 	assert(!utils::is_query_url(feedurl));
-	std::string query;
-	std::vector<std::shared_ptr<RssItem>> items;
+	SearchPage page;
+	page.position = &position;
+	if (position.done) {
+		return page.items;
+	}
 
-	std::lock_guard<std::mutex> lock(mtx);
-	if (feedurl.length() > 0) {
-		query = prepare_query(
-			"SELECT guid, title, author, url, pubDate, "
-			"length(content), "
-			"unread, feedurl, enclosure_url, enclosure_type, "
-			"enqueued, flags, base "
-			"FROM rss_item "
-			"WHERE (title LIKE '%%%q%%' OR content LIKE '%%%q%%') "
-			"AND feedurl = '%q' "
-			"AND deleted = 0 "
-			"ORDER BY pubDate DESC, id DESC;",
-			querystr,
-			querystr,
-			feedurl);
-	} else {
-		query = prepare_query(
-			"SELECT guid, title, author, url, pubDate, "
-			"length(content), "
-			"unread, feedurl, enclosure_url, enclosure_type, "
-			"enqueued, flags, base "
-			"FROM rss_item "
-			"WHERE (title LIKE '%%%q%%' OR content LIKE '%%%q%%') "
-			"AND deleted = 0 "
-			"ORDER BY pubDate DESC,  id DESC;",
-			querystr,
-			querystr);
+	// Across all feeds, idx_deleted_pubdate yields the matches in the
+	// order they are shown, so a page is read as soon as it's found rather
+	// than after sorting all matches. A single feed is small enough to
+	// sort, and looking it up by URL is much quicker.
+	std::string query = prepare_query(
+		"SELECT guid, title, author, url, pubDate, "
+		"length(content), "
+		"unread, feedurl, enclosure_url, enclosure_type, "
+		"enqueued, flags, base, id "
+		"FROM rss_item %s"
+		"WHERE (title LIKE '%%%q%%' OR content LIKE '%%%q%%') "
+		"AND deleted = 0 ",
+		feedurl.empty() ? "" : "INDEXED BY idx_feedurl ",
+		querystr,
+		querystr);
+	if (!feedurl.empty()) {
+		query.append(prepare_query("AND feedurl = '%q' ", feedurl));
 	}
+	if (position.started) {
+		query.append(prepare_query(
+			"AND pubDate <= %ld "
+			"AND (pubDate < %ld OR id < %lld) ",
+			static_cast<long>(position.pubDate),
+			static_cast<long>(position.pubDate),
+			static_cast<long long>(position.id)));
+	}
+	query.append("ORDER BY pubDate DESC, id DESC");
+	if (limit > 0) {
+		query.append(prepare_query(" LIMIT %u", limit));
+	}
+	query.append(";");
 
-	run_sql(query, search_item_callback, &items);
-	for (const auto& item : items) {
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		run_sql(query, search_item_callback, &page);
+	}
+	if (limit == 0 || page.items.size() < limit) {
+		position.done = true;
+	}
+	for (const auto& item : page.items) {
 		item->set_cache(this);
 	}
 
-	return items;
+	return page.items;
 }
 
 std::unordered_set<std::string> Cache::search_in_items(
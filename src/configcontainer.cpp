@@ -106,6 +106,9 @@ ConfigContainer::ConfigContainer()
 		  {"max-download-speed", ConfigData("0", ConfigDataType::INT)},
 		  {"max-downloads", ConfigData("1", ConfigDataType::INT)},
 		  {"max-items", ConfigData("0", ConfigDataType::INT)},
+		  {"max-search-results",
+			  ConfigData("10000", ConfigDataType::INT)},
+		  {"max-subprocesses", ConfigData("4", ConfigDataType::INT)},
 		  {"newsblur-login", ConfigData("", ConfigDataType::STR)},
 		  {"newsblur-min-items", ConfigData("20", ConfigDataType::INT)},
 		  {"newsblur-password", ConfigData("", ConfigDataType::STR)},
@@ -177,6 +180,8 @@ ConfigContainer::ConfigContainer()
 		  {"show-keymap-hint", ConfigData("yes", ConfigDataType::BOOL)},
 		  {"show-read-articles", ConfigData("yes", ConfigDataType::BOOL)},
 		  {"show-read-feeds", ConfigData("yes", ConfigDataType::BOOL)},
+		  {"subprocess-timeout",
+			  ConfigData("120", ConfigDataType::INT)},
 		  {"suppress-first-reload",
 			  ConfigData("no", ConfigDataType::BOOL)},
 		  {"swap-title-and-hints",
@@ -43,6 +43,7 @@
 #include "ocnewsapi.h"
 #include "oldreaderapi.h"
 #include "opmlurlreader.h"
+#include "processpool.h"
 #include "regexmanager.h"
 #include "remoteapi.h"
 #include "rssparser.h"
@@ -86,6 +87,10 @@ Controller::Controller()
 
 Controller::~Controller()
 {
+	// notify-program may still be running; stop it while the logger is
+	// still around
+	ProcessPool::getInstance().shutdown();
+
 	delete rsscache;
 	delete urlcfg;
 	delete api;
@@ -604,12 +609,13 @@ void Controller::replace_feed(std::shared_ptr<RssFeed> oldfeed,
 	feedcontainer.feeds[pos] = feed;
 	enqueue_items(feed);
 
-	oldfeed->clear_items();
-
 	v->notify_itemlist_change(feedcontainer.feeds[pos]);
 	if (!unattended) {
-		v->set_feedlist(feedcontainer.feeds);
+		// needs the old feed's items to tell if it had unread ones
+		v->update_feed(feedcontainer.feeds, pos, oldfeed);
 	}
+
+	oldfeed->clear_items();
 }
 
 void Controller::import_opml(const std::string& filename)
@@ -640,25 +646,25 @@ void Controller::export_opml()
 
 std::vector<std::shared_ptr<RssItem>> Controller::search_for_items(
 	const std::string& query,
-	std::shared_ptr<RssFeed> feed)
+	std::shared_ptr<RssFeed> feed,
+	SearchPosition& position,
+	unsigned int limit)
 {
 	std::vector<std::shared_ptr<RssItem>> items;
 	if (feed && feed->is_query_feed()) {
-		std::unordered_set<std::string> guids;
-		for (const auto& item : feed->items()) {
-			if (!item->deleted()) {
-				guids.insert(item->guid());
-			}
-		}
-		guids = rsscache->search_in_items(query, guids);
-		for (const auto& item : feed->items()) {
-			if (guids.find(item->guid()) != guids.end()) {
-				items.push_back(item);
-			}
-		}
+		// the articles are in memory already, so all matches make a
+		// single page; cutting it at `limit` would lose the rest, since
+		// there is no next page to find them on
+		items = feed->search_items(query);
+		position.done = true;
 	} else {
-		items = rsscache->search_for_items(
-			query, (feed != nullptr ? feed->rssurl() : ""));
+		items = rsscache->search_for_items(query,
+			(feed != nullptr ? feed->rssurl() : ""),
+			position,
+			limit);
+		// pages are also read by a background thread, while reloads
+		// might be replacing feeds
+		std::lock_guard<std::mutex> feedslock(feeds_mutex);
 		for (const auto& item : items) {
 			item->set_feedptr(
 				feedcontainer.get_feed_by_url(item->feedurl()));
@@ -667,6 +673,20 @@ std::vector<std::shared_ptr<RssItem>> Controller::search_for_items(
 	return items;
 }
 
+std::shared_ptr<SearchResultLoader> Controller::search_in_pages(
+	const std::string& query,
+	std::shared_ptr<RssFeed> feed)
+{
+	const int max_results =
+		cfg.get_configvalue_as_int("max-search-results");
+	return std::make_shared<SearchResultLoader>(
+		[this, query, feed](SearchPosition& position,
+			unsigned int limit) {
+			return search_for_items(query, feed, position, limit);
+		},
+		max_results > 0 ? max_results : 0);
+}
+
 void Controller::enqueue_url(const std::string& url,
 	const std::string& title,
 	const time_t pubDate,
@@ -963,6 +983,11 @@ void Controller::update_config()
 		v->apply_colors_to_all_formactions();
 	}
 
+	ProcessPool::getInstance().set_max_processes(
+		cfg.get_configvalue_as_int("max-subprocesses"));
+	ProcessPool::getInstance().set_timeout(
+		cfg.get_configvalue_as_int("subprocess-timeout"));
+
 	if (cfg.get_configvalue("error-log").length() > 0) {
 		try {
 			Logger::getInstance().set_errorlogfile(
@@ -3,6 +3,7 @@
 #include <algorithm> // stable_sort
 #include <numeric>   // accumulate
 
+#include "keyedsort.h"
 #include "utils.h"
 
 namespace newsboat {
@@ -11,82 +12,82 @@ void FeedContainer::sort_feeds(const FeedSortStrategy& sort_strategy)
 {
 	std::lock_guard<std::mutex> feedslock(feeds_mutex);
 
+	/* Every key is computed once per feed, not in each comparison: titles
+	 * have to be converted and unread items counted. */
+	typedef std::shared_ptr<RssFeed> FeedPtr;
 	switch (sort_strategy.sm) {
 	case FeedSortMethod::NONE:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				return a->get_order() < b->get_order();
+		keyed_stable_sort(feeds,
+			[](const FeedPtr& feed) {
+				return feed->get_order();
+			},
+			[](unsigned int a, unsigned int b) {
+				return a < b;
 			});
 		break;
 	case FeedSortMethod::FIRST_TAG:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				if (a->get_firsttag().length() == 0 ||
-					b->get_firsttag().length() == 0) {
-					return a->get_firsttag().length() >
-						b->get_firsttag().length();
+		keyed_stable_sort(feeds,
+			[](const FeedPtr& feed) {
+				return feed->get_firsttag();
+			},
+			[](const std::string& a, const std::string& b) {
+				if (a.length() == 0 || b.length() == 0) {
+					return a.length() > b.length();
 				}
-				return utils::strnaturalcmp(a->get_firsttag().c_str(),
-					       b->get_firsttag().c_str()) < 0;
+				return utils::strnaturalcmp(a, b) < 0;
 			});
 		break;
 	case FeedSortMethod::TITLE:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				return utils::strnaturalcmp(a->title().c_str(),
-					       b->title().c_str()) < 0;
+		keyed_stable_sort(feeds,
+			[](const FeedPtr& feed) {
+				return feed->title();
+			},
+			[](const std::string& a, const std::string& b) {
+				return utils::strnaturalcmp(a, b) < 0;
 			});
 		break;
 	case FeedSortMethod::ARTICLE_COUNT:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				return a->total_item_count() <
-					b->total_item_count();
+		keyed_stable_sort(feeds,
+			[](const FeedPtr& feed) {
+				return feed->total_item_count();
+			},
+			[](unsigned int a, unsigned int b) {
+				return a < b;
 			});
 		break;
 	case FeedSortMethod::UNREAD_ARTICLE_COUNT:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				return a->unread_item_count() <
-					b->unread_item_count();
+		keyed_stable_sort(feeds,
+			[](const FeedPtr& feed) {
+				return feed->unread_item_count();
+			},
+			[](unsigned int a, unsigned int b) {
+				return a < b;
 			});
 		break;
-	case FeedSortMethod::LAST_UPDATED:
-		std::stable_sort(feeds.begin(),
-			feeds.end(),
-			[](std::shared_ptr<RssFeed> a,
-				std::shared_ptr<RssFeed> b) {
-				if (a->items().size() == 0 ||
-					b->items().size() == 0) {
-					return a->items().size() >
-						b->items().size();
+	case FeedSortMethod::LAST_UPDATED: {
+		typedef std::shared_ptr<RssItem> ItemPtr;
+		const auto newer = [](const ItemPtr& a, const ItemPtr& b) {
+			return *a < *b;
+		};
+		// the number of items and the newest of them
+		typedef std::pair<size_t, ItemPtr> Newest;
+		keyed_stable_sort(feeds,
+			[&](const FeedPtr& feed) {
+				auto& items = feed->items();
+				if (items.empty()) {
+					return Newest(0, nullptr);
 				}
-				auto cmp =
-					[](std::shared_ptr<RssItem> a,
-						std::shared_ptr<RssItem> b) {
-						return *a < *b;
-					};
-				auto& a_item =
-					*std::min_element(a->items().begin(),
-						a->items().end(),
-						cmp);
-				auto& b_item =
-					*std::min_element(b->items().begin(),
-						b->items().end(),
-						cmp);
-				return cmp(a_item, b_item);
+				const auto newest = std::min_element(
+					items.begin(), items.end(), newer);
+				return Newest(items.size(), *newest);
+			},
+			[&](const Newest& a, const Newest& b) {
+				if (a.first == 0 || b.first == 0) {
+					return a.first > b.first;
+				}
+				return newer(a.second, b.second);
 			});
-		break;
+	} break;
 	}
 
 	switch (sort_strategy.sd) {
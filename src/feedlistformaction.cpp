@@ -20,6 +20,13 @@
 
 #define FILTER_UNREAD_FEEDS "unread_count != \"0\""
 
+namespace {
+
+// the list is rebuilt at most this often while feeds are being reloaded
+const std::chrono::milliseconds feedlist_rebuild_interval(100);
+
+} // anonymous namespace
+
 namespace newsboat {
 
 FeedListFormAction::FeedListFormAction(View* vv,
@@ -41,6 +48,7 @@ FeedListFormAction::FeedListFormAction(View* vv,
 	, total_feeds(0)
 	, filters(f)
 	, cfg(cfg)
+	, rebuild_pending(false)
 {
 	assert(true == m.parse(FILTER_UNREAD_FEEDS));
 	valid_cmds.push_back("tag");
@@ -92,6 +100,10 @@ void FeedListFormAction::prepare()
 		do_redraw = true;
 	}
 
+	if (rebuild_pending) {
+		do_redraw = true;
+	}
+
 	if (do_redraw) {
 		LOG(Level::DEBUG, "FeedListFormAction::prepare: doing redraw");
 		v->get_ctrl()->update_feedlist();
@@ -497,16 +509,28 @@ void FeedListFormAction::update_visible_feeds(
 
 	visible_feeds.clear();
 
-	unsigned int i = 0;
+	/* Only feeds with the right tag are matched against the filter (and
+	 * can make it throw), the same as if it was checked in the loop. */
+	std::vector<unsigned int> candidates;
+	std::vector<Matchable*> matchables;
+	for (unsigned int i = 0; i < feeds.size(); ++i) {
+		feeds[i]->set_index(i + 1);
+		if (tag == "" || feeds[i]->matches_tag(tag)) {
+			candidates.push_back(i);
+			matchables.push_back(feeds[i].get());
+		}
+	}
+
+	std::vector<bool> results;
+	if (apply_filter) {
+		results = m.matches_all(matchables);
+	}
 
-	for (const auto& feed : feeds) {
-		feed->set_index(i + 1);
-		if ((tag == "" || feed->matches_tag(tag)) &&
-			(!apply_filter || m.matches(feed.get())) &&
-			!feed->hidden()) {
-			visible_feeds.push_back(FeedPtrPosPair(feed, i));
+	for (unsigned int j = 0; j < candidates.size(); ++j) {
+		const unsigned int i = candidates[j];
+		if ((!apply_filter || results[j]) && !feeds[i]->hidden()) {
+			visible_feeds.push_back(FeedPtrPosPair(feeds[i], i));
 		}
-		i++;
 	}
 
 	feeds_shown = visible_feeds.size();
@@ -522,7 +546,10 @@ void FeedListFormAction::set_feedlist(
 	unsigned int i = 0;
 	unread_feeds = 0;
 
-	std::string feedlist_format = cfg->get_configvalue("feedlist-format");
+	const auto feedlist_format = cfg->get_configvalue("feedlist-format");
+	if (feedlist_template.source() != feedlist_format) {
+		feedlist_template = FmtStrTemplate(feedlist_format);
+	}
 
 	ListFormatter listfmt;
 
@@ -532,7 +559,7 @@ void FeedListFormAction::set_feedlist(
 		if (feed.first->unread_item_count() > 0)
 			++unread_feeds;
 
-		listfmt.add_line(format_line(feedlist_format,
+		listfmt.add_line(format_line(feedlist_template,
 					 feed.first,
 					 feed.second,
 					 width),
@@ -546,6 +573,82 @@ void FeedListFormAction::set_feedlist(
 		"replace_inner",
 		listfmt.format_list(rxman, "feedlist"));
 
+	set_head(width);
+
+	rebuild_pending = false;
+	last_rebuild = std::chrono::steady_clock::now();
+}
+
+void FeedListFormAction::update_feed(
+	std::vector<std::shared_ptr<RssFeed>>& feeds,
+	unsigned int pos,
+	const std::shared_ptr<RssFeed>& oldfeed)
+{
+	assert(cfg != nullptr); // must not happen
+	assert(pos < feeds.size());
+
+	const std::shared_ptr<RssFeed>& feed = feeds[pos];
+	feed->set_index(pos + 1);
+
+	// visible_feeds is ordered by position
+	const auto row = std::lower_bound(visible_feeds.begin(),
+		visible_feeds.end(),
+		pos,
+		[](const FeedPtrPosPair& visible, unsigned int p) {
+			return visible.second < p;
+		});
+	const bool was_visible = row != visible_feeds.end() &&
+		row->second == pos && row->first == oldfeed;
+
+	if (!rebuild_pending && was_visible == is_visible(feed)) {
+		if (was_visible) {
+			if (oldfeed->unread_item_count() > 0) {
+				--unread_feeds;
+			}
+			if (feed->unread_item_count() > 0) {
+				++unread_feeds;
+			}
+			row->first = feed;
+
+			const unsigned int width =
+				utils::to_u(f->get("feeds:w"));
+			ListFormatter listfmt;
+			listfmt.add_line(format_line(feedlist_template,
+						 feed,
+						 pos,
+						 width),
+				pos);
+			f->modify(std::to_string(pos),
+				"replace",
+				listfmt.format_line(0, rxman, "feedlist"));
+			set_head(width);
+		}
+		return;
+	}
+
+	if (row != visible_feeds.end() && row->second == pos) {
+		// so that the stale feed can't be opened in the meantime
+		row->first = feed;
+	}
+	rebuild_pending = true;
+	if (std::chrono::steady_clock::now() - last_rebuild >=
+		feedlist_rebuild_interval) {
+		set_feedlist(feeds);
+	} else {
+		LOG(Level::DEBUG,
+			"FeedListFormAction::update_feed: postponing rebuild");
+	}
+}
+
+bool FeedListFormAction::is_visible(const std::shared_ptr<RssFeed>& feed)
+{
+	// the same conditions as in update_visible_feeds()
+	return (tag == "" || feed->matches_tag(tag)) && !feed->hidden() &&
+		(!apply_filter || m.matches(feed.get()));
+}
+
+void FeedListFormAction::set_head(unsigned int width)
+{
 	std::string title_format =
 		cfg->get_configvalue("feedlist-title-format");
 
@@ -554,7 +657,7 @@ void FeedListFormAction::set_feedlist(
 	fmt.register_fmt('N', PROGRAM_NAME);
 	fmt.register_fmt('V', PROGRAM_VERSION);
 	fmt.register_fmt('u', std::to_string(unread_feeds));
-	fmt.register_fmt('t', std::to_string(i));
+	fmt.register_fmt('t', std::to_string(total_feeds));
 
 	f->set("head", fmt.do_format(title_format, width));
 }
@@ -900,12 +1003,14 @@ void FeedListFormAction::op_start_search()
 	if (searchphrase.length() > 0) {
 		v->set_status(_("Searching..."));
 		searchhistory.add_line(searchphrase);
+		std::shared_ptr<SearchResultLoader> loader;
 		std::vector<std::shared_ptr<RssItem>> items;
 		try {
 			std::string utf8searchphrase = utils::convert_text(
 				searchphrase, "utf-8", nl_langinfo(CODESET));
-			items = v->get_ctrl()->search_for_items(
+			loader = v->get_ctrl()->search_in_pages(
 				utf8searchphrase, nullptr);
+			items = loader->start();
 		} catch (const DbException& e) {
 			v->show_error(strprintf::fmt(
 				_("Error while searching for `%s': %s"),
@@ -918,7 +1023,8 @@ void FeedListFormAction::op_start_search()
 			search_dummy_feed->clear_items();
 			search_dummy_feed->add_items(items);
 			search_dummy_feed->item_mutex.unlock();
-			v->push_searchresult(search_dummy_feed, searchphrase);
+			v->push_searchresult(
+				search_dummy_feed, searchphrase, loader);
 		} else {
 			v->show_error(_("No results."));
 		}
@@ -970,30 +1076,43 @@ std::string FeedListFormAction::get_title(std::shared_ptr<RssFeed> feed)
 	return title;
 }
 
-std::string FeedListFormAction::format_line(const std::string& feedlist_format,
+std::string FeedListFormAction::format_line(
+	const FmtStrTemplate& feedlist_format,
 	std::shared_ptr<RssFeed> feed,
 	unsigned int pos,
 	unsigned int width)
 {
-	FmtStrFormatter fmt;
+	FmtStrTemplate::Values& values = feedlist_values;
 	unsigned int unread_count = feed->unread_item_count();
 
-	fmt.register_fmt('i', strprintf::fmt("%u", pos + 1));
-	fmt.register_fmt('u',
-		strprintf::fmt("(%u/%u)",
-			unread_count,
-			static_cast<unsigned int>(feed->total_item_count())));
-	fmt.register_fmt('U', std::to_string(unread_count));
-	fmt.register_fmt('c', std::to_string(feed->total_item_count()));
-	fmt.register_fmt('n', unread_count > 0 ? "N" : " ");
-	fmt.register_fmt('S', feed->get_status());
-	fmt.register_fmt('t', get_title(feed));
-	fmt.register_fmt('T', feed->get_firsttag());
-	fmt.register_fmt('l', utils::censor_url(feed->link()));
-	fmt.register_fmt('L', utils::censor_url(feed->rssurl()));
-	fmt.register_fmt('d', feed->description());
-
-	auto formattedLine = fmt.do_format(feedlist_format, width);
+	values['i'] = std::to_string(pos + 1);
+	values['u'] = strprintf::fmt("(%u/%u)",
+		unread_count,
+		static_cast<unsigned int>(feed->total_item_count()));
+	values['U'] = std::to_string(unread_count);
+	values['c'] = std::to_string(feed->total_item_count());
+	values['n'] = unread_count > 0 ? "N" : " ";
+	// the rest are only computed if the format uses them
+	if (feedlist_format.uses('S')) {
+		values['S'] = feed->get_status();
+	}
+	if (feedlist_format.uses('t')) {
+		values['t'] = get_title(feed);
+	}
+	if (feedlist_format.uses('T')) {
+		values['T'] = feed->get_firsttag();
+	}
+	if (feedlist_format.uses('l')) {
+		values['l'] = utils::censor_url(feed->link());
+	}
+	if (feedlist_format.uses('L')) {
+		values['L'] = utils::censor_url(feed->rssurl());
+	}
+	if (feedlist_format.uses('d')) {
+		values['d'] = feed->description();
+	}
+
+	auto formattedLine = feedlist_format.format(values, width);
 	if (unread_count > 0) {
 		formattedLine = strprintf::fmt("<unread>%s</>", formattedLine);
 	}
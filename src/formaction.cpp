@@ -5,6 +5,7 @@
 #include "config.h"
 #include "exceptions.h"
 #include "logger.h"
+#include "processpool.h"
 #include "strprintf.h"
 #include "utils.h"
 #include "view.h"
@@ -539,12 +540,7 @@ std::string FormAction::bookmark(const std::string& url,
 			v->pop_current_formaction();
 			return "";
 		} else {
-			char* my_argv[4];
-			my_argv[0] = const_cast<char*>("/bin/sh");
-			my_argv[1] = const_cast<char*>("-c");
-			my_argv[2] = const_cast<char*>(cmdline.c_str());
-			my_argv[3] = nullptr;
-			return utils::run_program(my_argv, "");
+			return ProcessPool::getInstance().run_shell(cmdline).output;
 		}
 	} else {
 		return _(
@@ -1,166 +1,270 @@
 #include "formatstring.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <sstream>
-#include <vector>
 
 #include "logger.h"
 #include "utils.h"
 
 namespace newsboat {
 
-void FmtStrFormatter::register_fmt(char f, const std::string& value)
+template<typename String>
+static bool is_ascii(const String& s)
 {
-	fmts[f] = utils::str2wstr(value);
+	typedef typename String::value_type Char;
+	return std::all_of(s.begin(), s.end(), [](Char c) {
+		return static_cast<unsigned long>(c) < 0x80;
+	});
 }
 
-std::string FmtStrFormatter::do_format(const std::string& fmt,
-	unsigned int width)
+/* utils::str2wstr() and utils::wstr2str() are costly, and most strings are
+ * plain ASCII, which converts one-to-one. */
+static std::wstring widen(const std::string& s)
+{
+	return is_ascii(s) ? std::wstring(s.begin(), s.end())
+			   : utils::str2wstr(s);
+}
+
+static std::string narrow(const std::wstring& s)
+{
+	return is_ascii(s) ? std::string(s.begin(), s.end())
+			   : utils::wstr2str(s);
+}
+
+/* Number of characters in s, which is what alignment is measured in. */
+static size_t char_count(const std::string& s)
+{
+	return is_ascii(s) ? s.length() : utils::str2wstr(s).length();
+}
+
+/* The first count characters of s. */
+static std::string first_chars(const std::string& s, size_t count)
+{
+	if (is_ascii(s)) {
+		return s.substr(0, count);
+	}
+	return utils::wstr2str(utils::str2wstr(s).substr(0, count));
+}
+
+/* Number of columns s takes up, or -1 if it contains non-printable
+ * characters, like wcswidth(). */
+static int display_width(const std::string& s)
+{
+	const bool printable = std::all_of(s.begin(), s.end(), [](char c) {
+		return c >= 0x20 && c < 0x7f;
+	});
+	if (printable) {
+		return s.length();
+	}
+	const std::wstring ws = utils::str2wstr(s);
+	return wcswidth(ws.c_str(), ws.length());
+}
+
+/* Index into FmtStrTemplate::Values for the format character c. */
+static unsigned char field_index(wchar_t c)
+{
+	return static_cast<unsigned long>(c) < 128 ? c : 0;
+}
+
+FmtStrTemplate::FmtStrTemplate() {}
+
+FmtStrTemplate::FmtStrTemplate(const std::string& fmt)
+	: src(fmt)
 {
-	std::string result;
 	if (fmt.length() > 0) {
-		std::wstring wfmt(utils::str2wstr(fmt));
-		std::wstring w = do_wformat(wfmt, width);
-		result = utils::wstr2str(w);
+		compile(widen(fmt));
 	}
-	return result;
 }
 
-std::wstring FmtStrFormatter::do_wformat(const std::wstring& wfmt,
-	unsigned int width)
+bool FmtStrTemplate::uses(char f) const
+{
+	const unsigned char c = f;
+	return c < used.size() && used[c];
+}
+
+void FmtStrTemplate::compile(const std::wstring& wfmt)
 {
-	std::wstring result;
-	unsigned int i;
-	unsigned int fmtlen = wfmt.length();
-	for (i = 0; i < fmtlen; ++i) {
-		if (wfmt[i] == L'%') {
+	std::wstring text;
+	const auto add_text = [&]() {
+		if (text.length() > 0) {
+			Instruction in;
+			in.type = Instruction::Type::TEXT;
+			in.text = narrow(text);
+			instructions.push_back(in);
+			text.clear();
+		}
+	};
+	const auto add_field = [&](Instruction::Type type, wchar_t c) {
+		add_text();
+		Instruction in;
+		in.type = type;
+		in.field = field_index(c);
+		instructions.push_back(in);
+		used.set(in.field);
+		return &instructions.back();
+	};
+
+	const unsigned int fmtlen = wfmt.length();
+	for (unsigned int i = 0; i < fmtlen; ++i) {
+		if (wfmt[i] != L'%') {
+			text.append(1, wfmt[i]);
+			continue;
+		}
+		if (i >= fmtlen - 1) {
+			continue;
+		}
+
+		if (wfmt[i + 1] == L'-' || iswdigit(wfmt[i + 1])) {
+			std::string number;
+			while ((wfmt[i + 1] == L'-' || iswdigit(wfmt[i + 1])) &&
+				i < (fmtlen - 1)) {
+				number.append(
+					1, static_cast<char>(wfmt[i + 1]));
+				++i;
+			}
 			if (i < (fmtlen - 1)) {
-				if (wfmt[i + 1] == L'-' ||
-					iswdigit(wfmt[i + 1])) {
-					std::wstring number;
-					while ((wfmt[i + 1] == L'-' ||
-						       iswdigit(wfmt[i + 1])) &&
-						i < (fmtlen - 1)) {
-						number.append(1, wfmt[i + 1]);
-						++i;
-					}
-					if (i < (fmtlen - 1)) {
-						wchar_t c = wfmt[i + 1];
-						++i;
-						std::wistringstream is(number);
-						int align;
-						is >> align;
-						if (static_cast<unsigned int>(
-							    abs(align)) >
-							fmts[c].length()) {
-							wchar_t buf[256];
-							swprintf(buf,
-								sizeof(buf) /
-									sizeof(*buf),
-								L"%*ls",
-								align,
-								fmts[c].c_str());
-							result.append(buf);
-						} else {
-							result.append(fmts[c].substr(
-								0, abs(align)));
-						}
-					}
-				} else if (wfmt[i + 1] == L'%') {
-					result.append(1, L'%');
-					++i;
-				} else if (wfmt[i + 1] == L'>') {
-					if (wfmt[i + 2]) {
-						if (width == 0) {
-							result.append(
-								1, wfmt[i + 2]);
-							i += 2;
-						} else {
-							std::wstring rightside =
-								do_wformat(
-									&wfmt[i +
-										3],
-									0);
-							int diff = width -
-								wcswidth(
-									result.c_str(),
-									result.length()) -
-								wcswidth(
-									rightside
-										.c_str(),
-									rightside
-										.length());
-							if (diff > 0) {
-								result.append(
-									diff,
-									wfmt[i +
-										2]);
-							}
-							result.append(
-								rightside);
-							i = fmtlen;
-						}
-					}
-				} else if (wfmt[i + 1] == L'?') {
-					unsigned int j = i + 2;
-					while (wfmt[j] && wfmt[j] != L'?')
-						j++;
-					if (wfmt[j]) {
-						std::wstring cond = wfmt.substr(
-							i + 2, j - i - 2);
-						unsigned int k = j + 1;
-						while (wfmt[k] &&
-							wfmt[k] != L'?')
-							k++;
-						if (wfmt[k]) {
-							std::wstring values =
-								wfmt.substr(
-									j + 1,
-									k - j - 1);
-							std::vector<
-								std::wstring>
-								pair = utils::wtokenize(
-									values,
-									L"&");
-							while (pair.size() < 2)
-								pair.push_back(
-									L"");
-
-							std::wstring subresult;
-							if (fmts[cond[0]]
-									.length() >
-								0) {
-								if (pair[0].length() >
-									0)
-									subresult = do_wformat(
-										pair[0],
-										width);
-							} else {
-								if (pair[1].length() >
-									0)
-									subresult = do_wformat(
-										pair[1],
-										width);
-							}
-							result.append(
-								subresult);
-							i = k;
-						} else {
-							i = k - 1;
-						}
-					} else {
-						i = j - 1;
-					}
-				} else {
-					result.append(fmts[wfmt[i + 1]]);
-					++i;
-				}
+				const wchar_t c = wfmt[i + 1];
+				++i;
+				std::istringstream is(number);
+				int align = 0;
+				is >> align;
+				Instruction* in = add_field(
+					Instruction::Type::ALIGNED_FIELD, c);
+				in->align = align;
+			}
+		} else if (wfmt[i + 1] == L'%') {
+			text.append(1, L'%');
+			++i;
+		} else if (wfmt[i + 1] == L'>') {
+			// without a fill character, the `>` is kept as text
+			if (wfmt[i + 2]) {
+				add_text();
+				Instruction in;
+				in.type = Instruction::Type::FILLER;
+				in.text = narrow(std::wstring(1, wfmt[i + 2]));
+				instructions.push_back(in);
+				i += 2;
+			}
+		} else if (wfmt[i + 1] == L'?') {
+			unsigned int j = i + 2;
+			while (wfmt[j] && wfmt[j] != L'?')
+				j++;
+			if (!wfmt[j]) {
+				i = j - 1;
+				continue;
 			}
+			const std::wstring cond = wfmt.substr(i + 2, j - i - 2);
+			unsigned int k = j + 1;
+			while (wfmt[k] && wfmt[k] != L'?')
+				k++;
+			if (!wfmt[k]) {
+				i = k - 1;
+				continue;
+			}
+			std::vector<std::wstring> pair = utils::wtokenize(
+					wfmt.substr(j + 1, k - j - 1), L"&");
+			while (pair.size() < 2)
+				pair.push_back(L"");
+
+			const auto if_set = std::make_shared<FmtStrTemplate>(
+				narrow(pair[0]));
+			const auto if_unset = std::make_shared<FmtStrTemplate>(
+				narrow(pair[1]));
+			used |= if_set->used | if_unset->used;
+			Instruction* in = add_field(
+				Instruction::Type::CONDITIONAL,
+				cond.empty() ? L'\0' : cond[0]);
+			in->if_set = if_set;
+			in->if_unset = if_unset;
+			i = k;
 		} else {
-			result.append(1, wfmt[i]);
+			add_field(Instruction::Type::FIELD, wfmt[i + 1]);
+			++i;
 		}
 	}
+	add_text();
+}
+
+std::string FmtStrTemplate::format(const Values& values,
+	unsigned int width) const
+{
+	std::string result;
+	format_from(0, values, width, result);
 	return result;
 }
 
+void FmtStrTemplate::format_from(size_t first,
+	const Values& values,
+	unsigned int width,
+	std::string& result) const
+{
+	for (size_t i = first; i < instructions.size(); ++i) {
+		const Instruction& in = instructions[i];
+		switch (in.type) {
+		case Instruction::Type::TEXT:
+			result.append(in.text);
+			break;
+		case Instruction::Type::FIELD:
+			result.append(values[in.field]);
+			break;
+		case Instruction::Type::ALIGNED_FIELD: {
+			const std::string& value = values[in.field];
+			const size_t length = char_count(value);
+			const size_t align = std::abs(in.align);
+			if (align > length) {
+				if (in.align > 0) {
+					result.append(align - length, ' ');
+				}
+				result.append(value);
+				if (in.align < 0) {
+					result.append(align - length, ' ');
+				}
+			} else {
+				result.append(first_chars(value, align));
+			}
+			break;
+		}
+		case Instruction::Type::FILLER: {
+			if (width == 0) {
+				result.append(in.text);
+				break;
+			}
+			// everything after the filler goes to the right edge
+			std::string rightside;
+			format_from(i + 1, values, 0, rightside);
+			const int diff = width - display_width(result) -
+				display_width(rightside);
+			for (int n = 0; n < diff; ++n) {
+				result.append(in.text);
+			}
+			result.append(rightside);
+			return;
+		}
+		case Instruction::Type::CONDITIONAL: {
+			// a filler in a branch only fills the branch's own text
+			const FmtStrTemplate& branch =
+				values[in.field].length() > 0 ? *in.if_set
+				: *in.if_unset;
+			result.append(branch.format(values, width));
+			break;
+		}
+		}
+	}
+}
+
+void FmtStrFormatter::register_fmt(char f, const std::string& value)
+{
+	const unsigned char c = f;
+	if (c < fmts.size()) {
+		fmts[c] = value;
+	}
+}
+
+std::string FmtStrFormatter::do_format(const std::string& fmt,
+	unsigned int width)
+{
+	return FmtStrTemplate(fmt).format(fmts, width);
+}
+
 } // namespace newsboat
@@ -1,11 +1,12 @@
 #include "htmlrenderer.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <iostream>
 #include <libgen.h>
-#include <sstream>
 #include <stdexcept>
 
 #include "config.h"
@@ -16,52 +17,168 @@
 
 namespace newsboat {
 
+namespace {
+
+struct TagName {
+	const char* name;
+	HtmlTag tag;
+};
+
+constexpr TagName tag_names[] = {
+	{"a", HtmlTag::A},
+	{"embed", HtmlTag::EMBED},
+	{"br", HtmlTag::BR},
+	{"pre", HtmlTag::PRE},
+	{"ituneshack", HtmlTag::ITUNESHACK},
+	{"img", HtmlTag::IMG},
+	{"blockquote", HtmlTag::BLOCKQUOTE},
+	{"aside", HtmlTag::BLOCKQUOTE},
+	{"p", HtmlTag::P},
+	{"h1", HtmlTag::H1},
+	{"h2", HtmlTag::H2},
+	{"h3", HtmlTag::H3},
+	{"h4", HtmlTag::H4},
+	{"h5", HtmlTag::H5},
+	{"h6", HtmlTag::H6},
+	{"ol", HtmlTag::OL},
+	{"ul", HtmlTag::UL},
+	{"li", HtmlTag::LI},
+	{"dt", HtmlTag::DT},
+	{"dd", HtmlTag::DD},
+	{"dl", HtmlTag::DL},
+	{"sup", HtmlTag::SUP},
+	{"sub", HtmlTag::SUB},
+	{"hr", HtmlTag::HR},
+	{"b", HtmlTag::STRONG},
+	{"strong", HtmlTag::STRONG},
+	{"u", HtmlTag::UNDERLINE},
+	{"q", HtmlTag::QUOTATION},
+	{"script", HtmlTag::SCRIPT},
+	{"style", HtmlTag::STYLE},
+	{"table", HtmlTag::TABLE},
+	{"th", HtmlTag::TH},
+	{"tr", HtmlTag::TR},
+	{"td", HtmlTag::TD}};
+
+constexpr size_t tag_name_count = sizeof(tag_names) / sizeof(tag_names[0]);
+
+/*
+ * Tag names are looked up in a perfect hash table: every name above has a
+ * slot of its own, picked by tag_hash(). The table is built by the compiler,
+ * which also checks that no two names share a slot.
+ */
+constexpr size_t tag_slot_count = 128;
+
+constexpr char ascii_lower(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+constexpr size_t tag_hash(char first, char last, size_t length)
+{
+	return (7 * length + static_cast<unsigned char>(ascii_lower(first)) +
+		       5 * static_cast<unsigned char>(ascii_lower(last))) %
+		tag_slot_count;
+}
+
+constexpr size_t name_length(const char* s)
+{
+	return *s == '\0' ? 0 : 1 + name_length(s + 1);
+}
+
+constexpr size_t tag_name_hash(size_t i)
+{
+	return tag_hash(tag_names[i].name[0],
+		tag_names[i].name[name_length(tag_names[i].name) - 1],
+		name_length(tag_names[i].name));
+}
+
+constexpr bool shares_slot(size_t i, size_t j)
+{
+	return j < tag_name_count &&
+		(tag_name_hash(i) == tag_name_hash(j) || shares_slot(i, j + 1));
+}
+
+constexpr bool is_perfect(size_t i)
+{
+	return i >= tag_name_count ||
+		(!shares_slot(i, i + 1) && is_perfect(i + 1));
+}
+
+static_assert(is_perfect(0),
+	"tag_hash() has to put every tag name into a slot of its own");
+
+/* index into tag_names of the name that hashes to `slot`, or -1 */
+constexpr int slot_entry(size_t slot, size_t i)
+{
+	return i >= tag_name_count
+		? -1
+		: tag_name_hash(i) == slot ? static_cast<int>(i)
+					   : slot_entry(slot, i + 1);
+}
+
+template<size_t... Slots>
+struct SlotList {
+};
+
+template<size_t N, size_t... Slots>
+struct MakeSlotList : MakeSlotList<N - 1, N - 1, Slots...> {
+};
+
+template<size_t... Slots>
+struct MakeSlotList<0, Slots...> {
+	typedef SlotList<Slots...> type;
+};
+
+template<size_t... Slots>
+constexpr std::array<signed char, sizeof...(Slots)> make_tag_slots(
+	SlotList<Slots...>)
+{
+	return {{static_cast<signed char>(slot_entry(Slots, 0))...}};
+}
+
+constexpr std::array<signed char, tag_slot_count> tag_slots =
+	make_tag_slots(MakeSlotList<tag_slot_count>::type());
+
+/* Returns the tag called `name` (in any case), or HtmlTag() for tags the
+ * renderer doesn't know. */
+HtmlTag lookup_tag(const std::string& name)
+{
+	if (name.empty()) {
+		return HtmlTag();
+	}
+
+	const int entry =
+		tag_slots[tag_hash(name.front(), name.back(), name.size())];
+	if (entry < 0) {
+		return HtmlTag();
+	}
+
+	const char* candidate = tag_names[entry].name;
+	for (const char c : name) {
+		if (*candidate == '\0' || ascii_lower(c) != *candidate) {
+			return HtmlTag();
+		}
+		candidate++;
+	}
+	return *candidate == '\0' ? tag_names[entry].tag : HtmlTag();
+}
+
+} // anonymous namespace
+
 HtmlRenderer::HtmlRenderer(bool raw)
 	: raw_(raw)
 {
-	tags["a"] = HtmlTag::A;
-	tags["embed"] = HtmlTag::EMBED;
-	tags["br"] = HtmlTag::BR;
-	tags["pre"] = HtmlTag::PRE;
-	tags["ituneshack"] = HtmlTag::ITUNESHACK;
-	tags["img"] = HtmlTag::IMG;
-	tags["blockquote"] = HtmlTag::BLOCKQUOTE;
-	tags["aside"] = HtmlTag::BLOCKQUOTE;
-	tags["p"] = HtmlTag::P;
-	tags["h1"] = HtmlTag::H1;
-	tags["h2"] = HtmlTag::H2;
-	tags["h3"] = HtmlTag::H3;
-	tags["h4"] = HtmlTag::H4;
-	tags["h5"] = HtmlTag::H5;
-	tags["h6"] = HtmlTag::H6;
-	tags["ol"] = HtmlTag::OL;
-	tags["ul"] = HtmlTag::UL;
-	tags["li"] = HtmlTag::LI;
-	tags["dt"] = HtmlTag::DT;
-	tags["dd"] = HtmlTag::DD;
-	tags["dl"] = HtmlTag::DL;
-	tags["sup"] = HtmlTag::SUP;
-	tags["sub"] = HtmlTag::SUB;
-	tags["hr"] = HtmlTag::HR;
-	tags["b"] = HtmlTag::STRONG;
-	tags["strong"] = HtmlTag::STRONG;
-	tags["u"] = HtmlTag::UNDERLINE;
-	tags["q"] = HtmlTag::QUOTATION;
-	tags["script"] = HtmlTag::SCRIPT;
-	tags["style"] = HtmlTag::STYLE;
-	tags["table"] = HtmlTag::TABLE;
-	tags["th"] = HtmlTag::TH;
-	tags["tr"] = HtmlTag::TR;
-	tags["td"] = HtmlTag::TD;
 }
 
-void HtmlRenderer::render(const std::string& source,
+void HtmlRenderer::render(std::istream& input,
 	std::vector<std::pair<LineType, std::string>>& lines,
 	std::vector<LinkPair>& links,
 	const std::string& url)
 {
-	std::istringstream input(source);
-	render(input, lines, links, url);
+	const std::string source((std::istreambuf_iterator<char>(input)),
+		std::istreambuf_iterator<char>());
+	render(source, lines, links, url);
 }
 
 unsigned int HtmlRenderer::add_link(std::vector<LinkPair>& links,
@@ -83,7 +200,7 @@ unsigned int HtmlRenderer::add_link(std::vector<LinkPair>& links,
 	return i;
 }
 
-void HtmlRenderer::render(std::istream& input,
+void HtmlRenderer::render(const std::string& source,
 	std::vector<std::pair<LineType, std::string>>& lines,
 	std::vector<LinkPair>& links,
 	const std::string& url)
@@ -105,26 +222,20 @@ void HtmlRenderer::render(std::istream& input,
 	 * to render the HTML, we use a self-developed "XML" pull parser.
 	 *
 	 * A pull parser works like this:
-	 *   - we feed it with an XML stream
+	 *   - we feed it with an XML document
 	 *   - we then gather an iterator
 	 *   - we then can iterate over all continuous elements, such as start
 	 * tag, close tag, text element, ...
 	 */
 	TagSoupPullParser xpp;
-	xpp.set_input(input);
+	xpp.set_input(source);
 
 	for (TagSoupPullParser::Event e = xpp.next();
 		e != TagSoupPullParser::Event::END_DOCUMENT;
 		e = xpp.next()) {
-		std::string tagname;
 		switch (e) {
 		case TagSoupPullParser::Event::START_TAG:
-			tagname = xpp.get_text();
-			std::transform(tagname.begin(),
-				tagname.end(),
-				tagname.begin(),
-				::tolower);
-			current_tag = tags[tagname];
+			current_tag = lookup_tag(xpp.get_text());
 
 			switch (current_tag) {
 			case HtmlTag::A: {
@@ -471,12 +582,7 @@ void HtmlRenderer::render(std::istream& input,
 			break;
 
 		case TagSoupPullParser::Event::END_TAG:
-			tagname = xpp.get_text();
-			std::transform(tagname.begin(),
-				tagname.end(),
-				tagname.begin(),
-				::tolower);
-			current_tag = tags[tagname];
+			current_tag = lookup_tag(xpp.get_text());
 
 			switch (current_tag) {
 			case HtmlTag::BLOCKQUOTE:
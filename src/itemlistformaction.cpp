@@ -1,5 +1,6 @@
 #include <itemlistformaction.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <langinfo.h>
@@ -681,6 +682,13 @@ void ItemListFormAction::process_operation(Operation op,
 			cfg->set_configvalue("article-sort-order", "guid-desc");
 		}
 	} break;
+	case OP_CANCEL_SEARCH:
+		if (search_loader != nullptr && search_loader->running()) {
+			search_loader->cancel();
+		} else {
+			v->show_error(_("No search is running."));
+		}
+		break;
 	case OP_INT_RESIZE:
 		invalidate(InvalidationMode::COMPLETE);
 		break;
@@ -784,17 +792,14 @@ void ItemListFormAction::qna_start_search()
 
 	v->set_status(_("Searching..."));
 	searchhistory.add_line(searchphrase);
+	std::shared_ptr<SearchResultLoader> loader;
 	std::vector<std::shared_ptr<RssItem>> items;
 	try {
 		std::string utf8searchphrase = utils::convert_text(
 			searchphrase, "utf-8", nl_langinfo(CODESET));
-		if (show_searchresult) {
-			items = v->get_ctrl()->search_for_items(
-				utf8searchphrase, nullptr);
-		} else {
-			items = v->get_ctrl()->search_for_items(
-				utf8searchphrase, feed);
-		}
+		loader = v->get_ctrl()->search_in_pages(utf8searchphrase,
+			show_searchresult ? nullptr : feed);
+		items = loader->start();
 	} catch (const DbException& e) {
 		v->show_error(
 			strprintf::fmt(_("Error while searching for `%s': %s"),
@@ -817,7 +822,55 @@ void ItemListFormAction::qna_start_search()
 	if (show_searchresult) {
 		v->pop_current_formaction();
 	}
-	v->push_searchresult(search_dummy_feed, searchphrase);
+	v->push_searchresult(search_dummy_feed, searchphrase, loader);
+}
+
+bool ItemListFormAction::take_search_results()
+{
+	if (search_loader == nullptr) {
+		return false;
+	}
+
+	// asked first, so that nothing is found between taking the results
+	// and seeing the search is over
+	const bool running = search_loader->running();
+	std::vector<std::shared_ptr<RssItem>> items;
+	search_loader->take(items);
+	if (!items.empty()) {
+		std::lock_guard<std::mutex> lock(feed->item_mutex);
+		feed->add_items(items);
+	}
+
+	if (running) {
+		if (!items.empty()) {
+			f->set("msg",
+				strprintf::fmt(
+					_("Searching... %u results so far"),
+					search_loader->count()));
+		}
+		return !items.empty();
+	}
+
+	const unsigned int count = search_loader->count();
+	if (!search_loader->error().empty()) {
+		f->set("msg",
+			strprintf::fmt(_("Error while searching for `%s': %s"),
+				searchphrase,
+				search_loader->error()));
+	} else if (search_loader->cancelled()) {
+		f->set("msg",
+			strprintf::fmt(_("Search cancelled after %u results."),
+				count));
+	} else if (search_loader->truncated()) {
+		f->set("msg",
+			strprintf::fmt(_("Showing the newest %u results; "
+					 "see max-search-results."),
+				count));
+	} else {
+		f->set("msg", strprintf::fmt(_("Found %u results."), count));
+	}
+	search_loader.reset();
+	return !items.empty();
 }
 
 void ItemListFormAction::do_update_visible_items()
@@ -836,13 +889,23 @@ void ItemListFormAction::do_update_visible_items()
 	 * (if applicable) whether an items matches the currently active filter.
 	 */
 
-	unsigned int i = 0;
-	for (const auto& item : items) {
-		item->set_index(i + 1);
-		if (!apply_filter || m.matches(item.get())) {
-			new_visible_items.push_back(ItemPtrPosPair(item, i));
+	std::vector<Matchable*> matchables;
+	for (unsigned int i = 0; i < items.size(); ++i) {
+		items[i]->set_index(i + 1);
+		if (apply_filter) {
+			matchables.push_back(items[i].get());
+		}
+	}
+
+	std::vector<bool> results;
+	if (apply_filter) {
+		results = m.matches_all(matchables);
+	}
+
+	for (unsigned int i = 0; i < items.size(); ++i) {
+		if (!apply_filter || results[i]) {
+			new_visible_items.push_back(ItemPtrPosPair(items[i], i));
 		}
-		i++;
 	}
 
 	LOG(Level::DEBUG,
@@ -856,8 +919,11 @@ void ItemListFormAction::prepare()
 {
 	std::lock_guard<std::mutex> mtx(redraw_mtx);
 
+	// new search results are appended, so the sort puts them in place
+	const bool found_more = take_search_results();
+
 	const auto sort_strategy = cfg->get_article_sort_strategy();
-	if (sort_strategy != old_sort_strategy) {
+	if (found_more || sort_strategy != old_sort_strategy) {
 		feed->sort(sort_strategy);
 		old_sort_strategy = sort_strategy;
 		invalidate(InvalidationMode::COMPLETE);
@@ -892,32 +958,33 @@ void ItemListFormAction::prepare()
 		old_width = width;
 	}
 
-	if (!invalidated)
-		return;
+	auto datetime_format = cfg->get_configvalue("datetime-format");
+	auto itemlist_format = cfg->get_configvalue("articlelist-format");
+	if (itemlist_template.source() != itemlist_format) {
+		itemlist_template = FmtStrTemplate(itemlist_format);
+	}
 
 	if (invalidated) {
-		auto datetime_format = cfg->get_configvalue("datetime-format");
-		auto itemlist_format =
-			cfg->get_configvalue("articlelist-format");
-
 		if (invalidation_mode == InvalidationMode::COMPLETE) {
+			// Only the lines around the cursor are formatted; the
+			// rest get placeholders until they are scrolled to, so
+			// that long lists open quickly.
 			listfmt.clear();
-
+			line_formatted.assign(visible_items.size(), false);
 			for (const auto& item : visible_items) {
-				auto line = item2formatted_line(item,
-					width,
-					itemlist_format,
-					datetime_format);
-				listfmt.add_line(line, item.second);
+				listfmt.add_line("", item.second);
 			}
+			format_lines_on_screen(
+				width, itemlist_template, datetime_format);
+
+			f->modify("items",
+				"replace_inner",
+				listfmt.format_list(rxman, "articlelist"));
 		} else if (invalidation_mode == InvalidationMode::PARTIAL) {
 			for (const auto& itempos : invalidated_itempos) {
-				auto item = visible_items[itempos];
-				auto line = item2formatted_line(item,
-					width,
-					itemlist_format,
-					datetime_format);
-				listfmt.set_line(itempos, line, item.second);
+				if (itempos < line_formatted.size()) {
+					line_formatted[itempos] = false;
+				}
 			}
 			invalidated_itempos.clear();
 		} else {
@@ -926,50 +993,107 @@ void ItemListFormAction::prepare()
 				"PARTIAL");
 		}
 
-		f->modify("items",
-			"replace_inner",
-			listfmt.format_list(rxman, "articlelist"));
-	}
+		invalidated = false;
 
-	invalidated = false;
+		set_head(feed->title(),
+			feed->unread_item_count(),
+			feed->total_item_count(),
+			feed->rssurl());
 
-	set_head(feed->title(),
-		feed->unread_item_count(),
-		feed->total_item_count(),
-		feed->rssurl());
+		prepare_set_filterpos();
+	}
 
-	prepare_set_filterpos();
+	for (const auto& itempos : format_lines_on_screen(
+			width, itemlist_template, datetime_format)) {
+		f->modify(std::to_string(visible_items[itempos].second),
+			"replace",
+			listfmt.format_line(itempos, rxman, "articlelist"));
+	}
 }
 
-std::string ItemListFormAction::item2formatted_line(const ItemPtrPosPair& item,
+std::vector<unsigned int> ItemListFormAction::format_lines_on_screen(
 	const unsigned int width,
-	const std::string& itemlist_format,
+	const FmtStrTemplate& itemlist_format,
 	const std::string& datetime_format)
 {
-	FmtStrFormatter fmt;
-	fmt.register_fmt('i', strprintf::fmt("%u", item.second + 1));
-	fmt.register_fmt('f', gen_flags(item.first));
-	fmt.register_fmt('D',
-		gen_datestr(item.first->pubDate_timestamp(), datetime_format));
-	if (feed->rssurl() != item.first->feedurl() &&
-		item.first->get_feedptr() != nullptr) {
-		auto feedtitle = utils::replace_all(
-			item.first->get_feedptr()->title(), "<", "<>");
-		utils::remove_soft_hyphens(feedtitle);
-		fmt.register_fmt('T', feedtitle);
+	std::vector<unsigned int> formatted;
+	if (visible_items.empty()) {
+		return formatted;
 	}
 
-	auto itemtitle = utils::replace_all(item.first->title(), "<", "<>");
-	utils::remove_soft_hyphens(itemtitle);
-	fmt.register_fmt('t', itemtitle);
+	unsigned int itempos = utils::to_u(f->get("itempos"));
+	if (itempos >= visible_items.size()) {
+		itempos = visible_items.size() - 1;
+	}
+	unsigned int height = utils::to_u(f->get("items:h"));
+	if (height == 0) {
+		// the list hasn't been drawn yet; guess generously
+		height = 100;
+	}
+
+	// The list scrolls to keep the cursor on screen, so whatever is shown
+	// is within a screenful of it. Another screenful on each side lets
+	// paging up and down find its lines ready.
+	const unsigned int margin = 2 * height;
+	const unsigned int first = itempos > margin ? itempos - margin : 0;
+	const unsigned int last = std::min<unsigned int>(
+			itempos + margin, visible_items.size() - 1);
+
+	for (unsigned int i = first; i <= last; ++i) {
+		if (line_formatted[i]) {
+			continue;
+		}
+		const auto& item = visible_items[i];
+		listfmt.set_line(i,
+			item2formatted_line(
+				item, width, itemlist_format, datetime_format),
+			item.second);
+		line_formatted[i] = true;
+		formatted.push_back(i);
+	}
 
-	auto itemauthor = utils::replace_all(item.first->author(), "<", "<>");
-	utils::remove_soft_hyphens(itemauthor);
-	fmt.register_fmt('a', itemauthor);
+	return formatted;
+}
 
-	fmt.register_fmt('L', item.first->length());
+std::string ItemListFormAction::item2formatted_line(const ItemPtrPosPair& item,
+	const unsigned int width,
+	const FmtStrTemplate& itemlist_format,
+	const std::string& datetime_format)
+{
+	FmtStrTemplate::Values& values = itemlist_values;
+	values['i'] = std::to_string(item.second + 1);
+	// the rest are only computed if the format uses them
+	if (itemlist_format.uses('f')) {
+		values['f'] = gen_flags(item.first);
+	}
+	if (itemlist_format.uses('D')) {
+		values['D'] = gen_datestr(
+			item.first->pubDate_timestamp(), datetime_format);
+	}
+	if (itemlist_format.uses('T')) {
+		values['T'].clear();
+		if (feed->rssurl() != item.first->feedurl() &&
+			item.first->get_feedptr() != nullptr) {
+			values['T'] = utils::replace_all(
+				item.first->get_feedptr()->title(), "<", "<>");
+			utils::remove_soft_hyphens(values['T']);
+		}
+	}
+	if (itemlist_format.uses('t')) {
+		values['t'] =
+			utils::replace_all(item.first->title(), "<", "<>");
+		utils::remove_soft_hyphens(values['t']);
+	}
+	if (itemlist_format.uses('a')) {
+		values['a'] =
+			utils::replace_all(item.first->author(), "<", "<>");
+		utils::remove_soft_hyphens(values['a']);
+	}
+	if (itemlist_format.uses('L')) {
+		values['L'] = item.first->length();
+	}
 
-	auto formattedLine = fmt.do_format(itemlist_format, width);
+	auto formattedLine = itemlist_format.format(values, width);
 
 	if (rxman) {
 		int id;
@@ -1150,6 +1274,42 @@ bool ItemListFormAction::jump_to_next_item(bool start_with_first)
 	return false;
 }
 
+std::shared_ptr<RssItem> ItemListFormAction::peek_item(Operation op)
+{
+	const unsigned int itempos = utils::to_u(f->get("itempos"));
+	const unsigned int count = visible_items.size();
+	if (itempos >= count) {
+		return nullptr;
+	}
+
+	switch (op) {
+	case OP_NEXT:
+		if (itempos + 1 < count) {
+			return visible_items[itempos + 1].first;
+		}
+		break;
+	case OP_PREV:
+		if (itempos > 0) {
+			return visible_items[itempos - 1].first;
+		}
+		break;
+	case OP_NEXTUNREAD:
+	case OP_PREVUNREAD:
+		for (unsigned int i = 1; i < count; ++i) {
+			const unsigned int pos = op == OP_NEXTUNREAD
+				? (itempos + i) % count
+				: (itempos + count - i) % count;
+			if (visible_items[pos].first->unread()) {
+				return visible_items[pos].first;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	return nullptr;
+}
+
 std::string ItemListFormAction::get_guid()
 {
 	unsigned int itempos = utils::to_u(f->get("itempos"));
@@ -0,0 +1,135 @@
+#include "itemprerenderer.h"
+
+#include <tuple>
+#include <utility>
+
+#include "itemrenderer.h"
+#include "logger.h"
+#include "regexmanager.h"
+#include "rss.h"
+
+namespace newsboat {
+
+ItemPrerenderer::ItemPrerenderer(ConfigContainer* cfg, RegexManager* rxman)
+	: cfg(cfg)
+	, rxman(rxman)
+	, generation(0)
+	, stop(false)
+{
+}
+
+ItemPrerenderer::Job::Job(const std::shared_ptr<RssItem>& item,
+	const ItemRenderCache::Key& key,
+	const ConfigContainer& cfg)
+	: item(std::make_shared<RssItem>(*item))
+	, key(key)
+	, cfg(cfg)
+{
+}
+
+ItemPrerenderer::~ItemPrerenderer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	cv.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+void ItemPrerenderer::prerender(const std::shared_ptr<RssItem>& item,
+	const ItemRenderCache::Key& key)
+{
+	std::unique_ptr<Job> job(new Job(item, key, *cfg));
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (rendering == key.guid) {
+			// already on it
+			return;
+		}
+		for (const auto& result : finished) {
+			if (result.first.guid == key.guid) {
+				return;
+			}
+		}
+		LOG(Level::DEBUG,
+			"ItemPrerenderer::prerender: queueing %s",
+			key.guid);
+		pending = std::move(job);
+		if (!worker.joinable()) {
+			worker = std::thread(&ItemPrerenderer::run, this);
+		}
+	}
+	cv.notify_all();
+}
+
+void ItemPrerenderer::cancel()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	LOG(Level::DEBUG, "ItemPrerenderer::cancel: dropping speculative renders");
+	pending.reset();
+	finished.clear();
+	generation++;
+}
+
+void ItemPrerenderer::collect(ItemRenderCache& cache,
+	const std::string& guid,
+	unsigned long highlight_revision)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	if (pending != nullptr && pending->key.guid == guid) {
+		// the user got there before the worker started on it; rendering
+		// it on this thread is just as quick
+		pending.reset();
+	}
+	cv.wait(lock, [&]() {
+		return rendering != guid;
+	});
+
+	for (auto& result : finished) {
+		if (result.first.highlight_revision == highlight_revision) {
+			cache.put(result.first, std::move(result.second));
+		}
+	}
+	finished.clear();
+}
+
+void ItemPrerenderer::run()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	for (;;) {
+		cv.wait(lock, [this]() {
+			return stop || pending != nullptr;
+		});
+		if (stop) {
+			return;
+		}
+
+		const std::unique_ptr<Job> job = std::move(pending);
+		const unsigned long job_generation = generation;
+		rendering = job->key.guid;
+		lock.unlock();
+
+		ItemRenderCache::Entry entry;
+		std::tie(entry.text, entry.num_lines) =
+			item_renderer::to_stfl_list(job->cfg,
+				job->item,
+				job->key.text_width,
+				job->key.window_width,
+				rxman,
+				"article",
+				entry.links);
+
+		lock.lock();
+		rendering.clear();
+		if (job_generation == generation) {
+			finished.emplace_back(job->key, std::move(entry));
+		}
+		cv.notify_all();
+	}
+}
+
+} // namespace newsboat
@@ -0,0 +1,103 @@
+#include "itemrendercache.h"
+
+namespace newsboat {
+
+namespace {
+
+bool same_rendering(const ItemRenderCache::Key& a,
+	const ItemRenderCache::Key& b)
+{
+	return a.revision == b.revision && a.text_width == b.text_width &&
+		a.window_width == b.window_width && a.renderer == b.renderer &&
+		a.feed_title == b.feed_title &&
+		a.highlight_revision == b.highlight_revision;
+}
+
+} // anonymous namespace
+
+ItemRenderCache::ItemRenderCache(size_t budget)
+	: budget(budget)
+	, used(0)
+	, highlight_revision(0)
+{
+}
+
+const ItemRenderCache::Entry* ItemRenderCache::get(const Key& key)
+{
+	check_highlight_revision(key.highlight_revision);
+
+	const auto it = index.find(SlotId(key.guid, key.source));
+	if (it == index.end() || !same_rendering(it->second->key, key)) {
+		return nullptr;
+	}
+
+	slots.splice(slots.begin(), slots, it->second);
+	return &it->second->entry;
+}
+
+void ItemRenderCache::put(const Key& key, Entry entry)
+{
+	check_highlight_revision(key.highlight_revision);
+
+	const SlotId id(key.guid, key.source);
+	const auto it = index.find(id);
+	if (it != index.end()) {
+		remove(it);
+	}
+
+	size_t bytes = sizeof(Slot) + key.guid.size() + key.renderer.size() +
+		key.feed_title.size() + entry.text.size();
+	for (const auto& link : entry.links) {
+		bytes += sizeof(LinkPair) + link.first.size();
+	}
+	if (bytes > budget) {
+		return;
+	}
+
+	slots.push_front(Slot{key, std::move(entry), bytes});
+	index[id] = slots.begin();
+	used += bytes;
+
+	while (used > budget) {
+		const Slot& last = slots.back();
+		remove(index.find(SlotId(last.key.guid, last.key.source)));
+	}
+}
+
+void ItemRenderCache::update_revision(const std::string& guid,
+	unsigned long from,
+	unsigned long to)
+{
+	for (const bool source : {false, true}) {
+		const auto it = index.find(SlotId(guid, source));
+		if (it != index.end() && it->second->key.revision == from) {
+			it->second->key.revision = to;
+		}
+	}
+}
+
+void ItemRenderCache::clear()
+{
+	index.clear();
+	slots.clear();
+	used = 0;
+}
+
+void ItemRenderCache::remove(
+	std::map<SlotId, std::list<Slot>::iterator>::iterator it)
+{
+	used -= it->second->bytes;
+	slots.erase(it->second);
+	index.erase(it);
+}
+
+void ItemRenderCache::check_highlight_revision(unsigned long revision)
+{
+	// entries highlighted with other rules are of no use any more
+	if (revision != highlight_revision) {
+		clear();
+		highlight_revision = revision;
+	}
+}
+
+} // namespace newsboat
@@ -7,6 +7,7 @@
 #include "config.h"
 #include "exceptions.h"
 #include "formatstring.h"
+#include "itemlistformaction.h"
 #include "itemrenderer.h"
 #include "logger.h"
 #include "strprintf.h"
@@ -25,6 +26,9 @@ ItemViewFormAction::ItemViewFormAction(View* vv,
 	, show_source(false)
 	, quit(false)
 	, rxman(0)
+	, render_cache(nullptr)
+	, prerenderer(nullptr)
+	, last_move(OP_NEXTUNREAD)
 	, num_lines(0)
 	, itemlist(il)
 	, in_search(false)
@@ -84,7 +88,9 @@ void ItemViewFormAction::prepare()
 	 * HTML. The links extracted by the renderer are then appended, too.
 	 */
 	if (do_redraw) {
-		{
+		// STFL keeps the widget sizes of the last run, so the form only
+		// has to be rendered here if it wasn't shown yet.
+		if (utils::to_u(f->get("article:w"), 0) == 0) {
 			ScopeMeasure("itemview::prepare: rendering");
 			// XXX HACK: render once so that we get a proper widget width
 			f->run(-3);
@@ -106,26 +112,65 @@ void ItemViewFormAction::prepare()
 			}
 		}
 
+		ItemRenderCache::Key key;
+		key.guid = guid;
+		key.source = show_source;
+		key.revision = item->revision();
+		key.text_width = text_width;
+		key.window_width = window_width;
+		key.renderer = cfg->get_configvalue("html-renderer");
+		key.feed_title = item_renderer::get_feedtitle(item);
+		key.highlight_revision = rxman->revision();
+
+		// search results are highlighted only once, so they aren't
+		// worth keeping
+		const ItemRenderCache::Entry* cached = nullptr;
+		if (render_cache != nullptr && !in_search) {
+			if (prerenderer != nullptr) {
+				prerenderer->collect(*render_cache,
+					guid,
+					key.highlight_revision);
+			}
+			cached = render_cache->get(key);
+		}
+
 		std::string formatted_text;
-		if (show_source) {
-			std::tie(formatted_text, num_lines) =
-				item_renderer::source_to_stfl_list(
-					item,
-					text_width,
-					window_width,
-					rxman,
-					"article");
+		if (cached != nullptr) {
+			formatted_text = cached->text;
+			num_lines = cached->num_lines;
+			if (!show_source) {
+				links = cached->links;
+			}
 		} else {
-			std::tie(formatted_text, num_lines) =
-				item_renderer::to_stfl_list(
-					// cfg can't be nullptr because that's a long-lived object
-					// created at the very start of the program.
-					*cfg,
-					item,
-					text_width,
-					window_width,
-					rxman,
-					"article");
+			ItemRenderCache::Entry entry;
+			if (show_source) {
+				std::tie(entry.text, entry.num_lines) =
+					item_renderer::source_to_stfl_list(
+						item,
+						text_width,
+						window_width,
+						rxman,
+						"article");
+			} else {
+				// cfg can't be nullptr because that's a
+				// long-lived object created at the very start
+				// of the program.
+				std::tie(entry.text, entry.num_lines) =
+					item_renderer::to_stfl_list(
+						*cfg,
+						item,
+						text_width,
+						window_width,
+						rxman,
+						"article",
+						entry.links);
+				links = entry.links;
+			}
+			formatted_text = entry.text;
+			num_lines = entry.num_lines;
+			if (render_cache != nullptr && !in_search) {
+				render_cache->put(key, std::move(entry));
+			}
 		}
 
 		f->modify("article", "replace_inner", formatted_text);
@@ -136,10 +181,48 @@ void ItemViewFormAction::prepare()
 			in_search = false;
 		}
 
+		prerender_next(key);
+
 		do_redraw = false;
 	}
 }
 
+void ItemViewFormAction::prerender_next(ItemRenderCache::Key key)
+{
+	// Only the internal renderer is used speculatively; external ones
+	// are user commands that shouldn't be run behind the user's back.
+	if (prerenderer == nullptr || render_cache == nullptr || show_source ||
+		key.renderer != "internal") {
+		return;
+	}
+
+	const std::shared_ptr<RssItem> next = itemlist->peek_item(last_move);
+	if (next == nullptr) {
+		return;
+	}
+
+	key.guid = next->guid();
+	key.revision = next->revision();
+	key.feed_title = item_renderer::get_feedtitle(next);
+	key.highlight_revision = rxman->revision();
+	if (render_cache->get(key) == nullptr) {
+		prerenderer->prerender(next, key);
+	}
+}
+
+void ItemViewFormAction::note_move(Operation op)
+{
+	const auto backwards = [](Operation o) {
+		return o == OP_PREV || o == OP_PREVUNREAD;
+	};
+	// whatever was rendered for the other direction won't be needed
+	const bool turned = backwards(op) != backwards(last_move);
+	if (prerenderer != nullptr && (op == OP_RANDOMUNREAD || turned)) {
+		prerenderer->cancel();
+	}
+	last_move = op;
+}
+
 void ItemViewFormAction::process_operation(Operation op,
 	bool automatic,
 	std::vector<std::string>* args)
@@ -156,9 +239,15 @@ void ItemViewFormAction::process_operation(Operation op,
 	 */
 	try {
 		bool old_unread = item->unread();
+		const unsigned long old_revision = item->revision();
 		item->set_unread(false);
 		if (old_unread) {
 			v->get_ctrl()->mark_article_read(item->guid(), true);
+			// the unread flag isn't part of the rendered article
+			if (render_cache != nullptr) {
+				render_cache->update_revision(
+					guid, old_revision, item->revision());
+			}
 		}
 	} catch (const DbException& e) {
 		v->show_error(strprintf::fmt(
@@ -297,6 +386,7 @@ void ItemViewFormAction::process_operation(Operation op,
 	case OP_NEXTUNREAD:
 		LOG(Level::INFO,
 			"ItemViewFormAction::process_operation: jumping to next unread article");
+		note_move(OP_NEXTUNREAD);
 		if (v->get_next_unread(itemlist.get(), this)) {
 			do_redraw = true;
 		} else {
@@ -308,6 +398,7 @@ void ItemViewFormAction::process_operation(Operation op,
 		LOG(Level::INFO,
 			"ItemViewFormAction::process_operation: jumping to previous unread "
 			"article");
+		note_move(OP_PREVUNREAD);
 		if (v->get_previous_unread(itemlist.get(), this)) {
 			do_redraw = true;
 		} else {
@@ -317,6 +408,7 @@ void ItemViewFormAction::process_operation(Operation op,
 		break;
 	case OP_NEXT:
 		LOG(Level::INFO, "ItemViewFormAction::process_operation: jumping to next article");
+		note_move(OP_NEXT);
 		if (v->get_next(itemlist.get(), this)) {
 			do_redraw = true;
 		} else {
@@ -327,6 +419,7 @@ void ItemViewFormAction::process_operation(Operation op,
 	case OP_PREV:
 		LOG(Level::INFO,
 			"ItemViewFormAction::process_operation: jumping to previous article");
+		note_move(OP_PREV);
 		if (v->get_previous(itemlist.get(), this)) {
 			do_redraw = true;
 		} else {
@@ -337,6 +430,7 @@ void ItemViewFormAction::process_operation(Operation op,
 	case OP_RANDOMUNREAD:
 		LOG(Level::INFO,
 			"ItemViewFormAction::process_operation: jumping to random unread article");
+		note_move(OP_RANDOMUNREAD);
 		if (v->get_random_unread(itemlist.get(), this)) {
 			do_redraw = true;
 		} else {
@@ -280,6 +280,11 @@ static OpDesc opdescs[] = {
 		"G",
 		_("Sort current list (reverse)"),
 		KM_FEEDLIST | KM_ARTICLELIST},
+	{OP_CANCEL_SEARCH,
+		"cancel-search",
+		"c",
+		_("Stop looking for more search results"),
+		KM_ARTICLELIST},
 
 	{OP_0, "zero", "0", _("Open URL 10"), KM_URLVIEW | KM_ARTICLE},
 	{OP_1, "one", "1", _("Open URL 1"), KM_URLVIEW | KM_ARTICLE},
@@ -0,0 +1,67 @@
+#include "latencyrecorder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "strprintf.h"
+
+namespace newsboat {
+
+namespace {
+
+double to_ms(std::chrono::microseconds us)
+{
+	return us.count() / 1000.0;
+}
+
+} // anonymous namespace
+
+LatencyRecorder::LatencyRecorder(size_t capacity)
+	: capacity(std::max<size_t>(capacity, 1))
+	, next(0)
+	, total(0)
+{
+}
+
+void LatencyRecorder::add(std::chrono::microseconds sample)
+{
+	if (samples.size() < capacity) {
+		samples.push_back(sample);
+	} else {
+		samples[next] = sample;
+		next = (next + 1) % capacity;
+	}
+	total++;
+}
+
+std::chrono::microseconds LatencyRecorder::percentile(double p) const
+{
+	if (samples.empty()) {
+		return std::chrono::microseconds(0);
+	}
+
+	// nearest-rank method
+	const double clamped = std::min(std::max(p, 0.0), 100.0);
+	size_t rank = static_cast<size_t>(
+		std::ceil(clamped / 100.0 * samples.size()));
+	if (rank > 0) {
+		rank--;
+	}
+
+	std::vector<std::chrono::microseconds> sorted = samples;
+	std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+	return sorted[rank];
+}
+
+std::string LatencyRecorder::summary() const
+{
+	return strprintf::fmt(
+		"p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms (%u samples)",
+		to_ms(percentile(50)),
+		to_ms(percentile(90)),
+		to_ms(percentile(99)),
+		to_ms(percentile(100)),
+		static_cast<unsigned int>(samples.size()));
+}
+
+} // namespace newsboat
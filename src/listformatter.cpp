@@ -29,28 +29,24 @@ void ListFormatter::set_line(const unsigned int itempos,
 	std::vector<LineIdPair> formatted_text;
 
 	if (width > 0 && text.length() > 0) {
-		std::wstring mytext = utils::clean_nonprintable_characters(
-			utils::str2wstr(text));
+		const std::string mytext =
+			utils::clean_nonprintable_characters(text);
 
-		while (mytext.length() > 0) {
-			size_t size = mytext.length();
-			size_t w = utils::wcswidth_stfl(mytext, size);
-			if (w > width) {
-				while (size &&
-					(w = utils::wcswidth_stfl(
-						 mytext, size)) > width) {
-					size--;
-				}
+		size_t pos = 0;
+		while (pos < mytext.length()) {
+			size_t w = 0;
+			size_t size = utils::fit_width(mytext, pos, width, w);
+			if (size == 0) {
+				// a double-width character in a one-column list
+				size = utils::fit_width(mytext, pos, 2, w);
 			}
-			formatted_text.push_back(LineIdPair(
-				utils::wstr2str(mytext.substr(0, size)), id));
-			mytext.erase(0, size);
+			formatted_text.push_back(
+				LineIdPair(mytext.substr(pos, size), id));
+			pos += size;
 		}
 	} else {
 		formatted_text.push_back(LineIdPair(
-			utils::wstr2str(utils::clean_nonprintable_characters(
-				utils::str2wstr(text))),
-			id));
+			utils::clean_nonprintable_characters(text), id));
 	}
 
 	if (itempos == UINT_MAX) {
@@ -76,22 +72,32 @@ std::string ListFormatter::format_list(RegexManager* rxman,
 	const std::string& location)
 {
 	format_cache = "{list";
-	for (const auto& line : lines) {
-		std::string str = line.first;
-		if (rxman)
-			rxman->quote_and_highlight(str, location);
-		if (line.second == UINT_MAX) {
-			format_cache.append(strprintf::fmt(
-				"{listitem text:%s}", Stfl::quote(str)));
-		} else {
-			format_cache.append(
-				strprintf::fmt("{listitem[%u] text:%s}",
-					line.second,
-					Stfl::quote(str)));
-		}
+	for (unsigned int i = 0; i < lines.size(); ++i) {
+		format_cache.append(format_line(i, rxman, location));
 	}
 	format_cache.append(1, '}');
 	return format_cache;
 }
 
+std::string ListFormatter::format_line(const unsigned int itempos,
+	RegexManager* rxman,
+	const std::string& location)
+{
+	const auto& line = lines[itempos];
+	std::string str = line.first;
+	// empty lines are common placeholders in long lists; there is nothing
+	// to highlight or quote in them
+	if (str.empty()) {
+		str = "\"\"";
+	} else {
+		if (rxman)
+			rxman->quote_and_highlight(str, location);
+		str = Stfl::quote(str);
+	}
+	if (line.second == UINT_MAX) {
+		return strprintf::fmt("{listitem text:%s}", str);
+	}
+	return strprintf::fmt("{listitem[%u] text:%s}", line.second, str);
+}
+
 } // namespace newsboat
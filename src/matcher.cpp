@@ -1,10 +1,18 @@
 #include "matcher.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <exception>
+#include <langinfo.h>
+#include <mutex>
 #include <regex.h>
-#include <sstream>
 #include <sys/time.h>
+#include <thread>
 #include <vector>
 
 #include "exceptions.h"
@@ -13,9 +21,139 @@
 
 namespace newsboat {
 
+static const struct {
+	const char* name;
+	AttributeId id;
+} attributes[] = {{"title", AttributeId::TITLE},
+	{"link", AttributeId::LINK},
+	{"author", AttributeId::AUTHOR},
+	{"content", AttributeId::CONTENT},
+	{"date", AttributeId::DATE},
+	{"guid", AttributeId::GUID},
+	{"unread", AttributeId::UNREAD},
+	{"enclosure_url", AttributeId::ENCLOSURE_URL},
+	{"enclosure_type", AttributeId::ENCLOSURE_TYPE},
+	{"flags", AttributeId::FLAGS},
+	{"age", AttributeId::AGE},
+	{"articleindex", AttributeId::ARTICLEINDEX},
+	{"feedtitle", AttributeId::FEEDTITLE},
+	{"description", AttributeId::DESCRIPTION},
+	{"feedlink", AttributeId::FEEDLINK},
+	{"feeddate", AttributeId::FEEDDATE},
+	{"rssurl", AttributeId::RSSURL},
+	{"unread_count", AttributeId::UNREAD_COUNT},
+	{"total_count", AttributeId::TOTAL_COUNT},
+	{"tags", AttributeId::TAGS},
+	{"feedindex", AttributeId::FEEDINDEX}};
+
+AttributeId attribute_id(const std::string& attribname)
+{
+	for (const auto& attribute : attributes) {
+		if (attribname == attribute.name) {
+			return attribute.id;
+		}
+	}
+	return AttributeId::UNKNOWN;
+}
+
+const char* attribute_name(AttributeId id)
+{
+	for (const auto& attribute : attributes) {
+		if (attribute.id == id) {
+			return attribute.name;
+		}
+	}
+	return "";
+}
+
 Matchable::Matchable() {}
 Matchable::~Matchable() {}
 
+bool Matchable::has_attribute_id(AttributeId id)
+{
+	return has_attribute(attribute_name(id));
+}
+
+std::string Matchable::get_attribute_id(AttributeId id)
+{
+	return get_attribute(attribute_name(id));
+}
+
+bool Matchable::get_numeric_attribute_id(AttributeId, long&)
+{
+	return false;
+}
+
+bool Matchable::attribute_contains(AttributeId, const std::string&, bool&)
+{
+	return false;
+}
+
+bool Matchable::get_revision(unsigned long&)
+{
+	return false;
+}
+
+/* Checks if \a id is one of the attributes that an item's revision covers:
+ * the item's own ones, except those that change with time or position. */
+static bool is_item_attribute(AttributeId id)
+{
+	switch (id) {
+	case AttributeId::TITLE:
+	case AttributeId::LINK:
+	case AttributeId::AUTHOR:
+	case AttributeId::CONTENT:
+	case AttributeId::DATE:
+	case AttributeId::GUID:
+	case AttributeId::UNREAD:
+	case AttributeId::ENCLOSURE_URL:
+	case AttributeId::ENCLOSURE_TYPE:
+	case AttributeId::FLAGS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static int clamp_to_int(long value)
+{
+	if (value > INT_MAX) {
+		return INT_MAX;
+	}
+	if (value < INT_MIN) {
+		return INT_MIN;
+	}
+	return value;
+}
+
+/* Converts a string to int the same way `std::istringstream >> int` does:
+ * leading whitespace is skipped, parsing stops at the first non-digit,
+ * strings without a number yield 0 and out-of-range values are clamped. */
+static int parse_int(const std::string& s)
+{
+	return clamp_to_int(strtol(s.c_str(), nullptr, 10));
+}
+
+/* Checks if \a token is one of the space-separated words in \a str, without
+ * splitting \a str into a vector first. */
+static bool contains_token(const std::string& str, const std::string& token)
+{
+	if (token.empty() || token.find(' ') != std::string::npos) {
+		return false;
+	}
+
+	std::string::size_type pos = 0;
+	while ((pos = str.find(token, pos)) != std::string::npos) {
+		const auto end = pos + token.length();
+		if ((pos == 0 || str[pos - 1] == ' ') &&
+			(end == str.length() || str[end] == ' ')) {
+			return true;
+		}
+		pos = end;
+	}
+	return false;
+}
+
 Matcher::Matcher() {}
 
 Matcher::Matcher(const std::string& expr)
@@ -42,6 +180,19 @@ bool Matcher::parse(const std::string& expr)
 		errmsg = utils::wstr2str(p.get_error());
 	}
 
+	program.clear();
+	compile(p.get_root());
+
+	cacheable = !program.empty();
+	for (const auto& ins : program) {
+		if (ins.code == OpCode::TEST &&
+			!is_item_attribute(ins.attrib)) {
+			cacheable = false;
+		}
+	}
+	std::lock_guard<std::mutex> lock(results_mtx);
+	results.clear();
+
 	gettimeofday(&tv2, nullptr);
 	unsigned long diff =
 		(((tv2.tv_sec - tv1.tv_sec) * 1000000) + tv2.tv_usec) -
@@ -55,7 +206,161 @@ bool Matcher::parse(const std::string& expr)
 	return b;
 }
 
+void Matcher::compile(expression* e)
+{
+	/*
+	 * The expression tree is flattened into a list of instructions. The
+	 * operands of "and" and "or" are laid out one after the other, with a
+	 * conditional jump in between that skips the right operand if the left
+	 * one already decided the outcome. This keeps the short-circuit
+	 * evaluation of the tree-walking matcher.
+	 */
+	if (e && (e->op == LOGOP_AND || e->op == LOGOP_OR)) {
+		compile(e->l);
+
+		Instruction jump;
+		jump.code = (e->op == LOGOP_AND) ? OpCode::JUMP_IF_FALSE
+						 : OpCode::JUMP_IF_TRUE;
+		const size_t jump_pos = program.size();
+		program.push_back(std::move(jump));
+
+		compile(e->r);
+		program[jump_pos].target = program.size();
+	} else {
+		program.push_back(compile_test(e));
+	}
+}
+
+Matcher::Instruction Matcher::compile_test(expression* e)
+{
+	Instruction ins;
+
+	if (!e) {
+		// shouldn't happen; a missing subexpression always matches
+		ins.negate = true;
+		return ins;
+	}
+
+	ins.name = e->name;
+	ins.literal = e->literal;
+	ins.attrib = attribute_id(e->name);
+
+	switch (e->op) {
+	case MATCHOP_NE:
+		ins.negate = true;
+	// fall through
+	case MATCHOP_EQ:
+		ins.matchop = MATCHOP_EQ;
+		break;
+
+	case MATCHOP_LE:
+		ins.negate = true;
+	// fall through
+	case MATCHOP_GT:
+		ins.matchop = MATCHOP_GT;
+		ins.number = parse_int(e->literal);
+		break;
+
+	case MATCHOP_GE:
+		ins.negate = true;
+	// fall through
+	case MATCHOP_LT:
+		ins.matchop = MATCHOP_LT;
+		ins.number = parse_int(e->literal);
+		break;
+
+	case MATCHOP_BETWEEN: {
+		ins.matchop = MATCHOP_BETWEEN;
+		std::vector<std::string> lit = utils::tokenize(e->literal, ":");
+		if (lit.size() >= 2) {
+			ins.range_valid = true;
+			ins.range_lower = parse_int(lit[0]);
+			ins.range_upper = parse_int(lit[1]);
+			if (ins.range_lower > ins.range_upper) {
+				std::swap(ins.range_lower, ins.range_upper);
+			}
+		}
+		break;
+	}
+
+	case MATCHOP_RXNE:
+		ins.negate = true;
+	// fall through
+	case MATCHOP_RXEQ: {
+		ins.matchop = MATCHOP_RXEQ;
+		regex_t* rx = new regex_t;
+		int err = regcomp(rx,
+				e->literal.c_str(),
+				REG_EXTENDED | REG_ICASE | REG_NOSUB);
+		if (err == 0) {
+			ins.regex = std::shared_ptr<regex_t>(rx, [](regex_t* r) {
+				regfree(r);
+				delete r;
+			});
+		} else {
+			// reported when the expression is evaluated
+			char buf[1024];
+			regerror(err, rx, buf, sizeof(buf));
+			ins.regex_error = buf;
+			delete rx;
+		}
+		break;
+	}
+
+	case MATCHOP_CONTAINSNOT:
+		ins.negate = true;
+	// fall through
+	case MATCHOP_CONTAINS:
+		ins.matchop = MATCHOP_CONTAINS;
+		break;
+
+	default:
+		ins.matchop = LOGOP_INVALID;
+		break;
+	}
+
+	return ins;
+}
+
 bool Matcher::matches(Matchable* item)
+{
+	if (!item) {
+		return false;
+	}
+
+	unsigned long revision = 0;
+	if (!cacheable || !item->get_revision(revision)) {
+		return evaluate(item);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(results_mtx);
+		const auto it = results.find(item);
+		if (it != results.end() && it->second.revision == revision) {
+			return it->second.matched;
+		}
+	}
+
+	const bool matched = evaluate(item);
+	std::lock_guard<std::mutex> lock(results_mtx);
+	remember(item, revision, matched);
+	return matched;
+}
+
+void Matcher::remember(const Matchable* item,
+	unsigned long revision,
+	bool matched)
+{
+	/* Entries of items that are gone are never looked up again, so the
+	 * cache is simply emptied once it gets this big. */
+	const size_t max_results = 1 << 18;
+	if (results.size() >= max_results) {
+		results.clear();
+	}
+	results[item] = CachedResult{revision, matched};
+}
+
+bool Matcher::evaluate(Matchable* item)
 {
 	/*
 	 * with this method, every class that is derived from Matchable can be
@@ -71,177 +376,358 @@ bool Matcher::matches(Matchable* item)
 	 * The whole matching code is speed-critical, as the matching happens on
 	 * a lot of different occassions, and slow matching can be easily
 	 * measured (and felt by the user) on slow computers with a lot of items
-	 * to match.
+	 * to match. That's why parse() compiles the expression up front, and
+	 * this only runs the resulting program.
 	 */
-	bool retval = false;
-	if (item) {
-		ScopeMeasure m1("Matcher::matches");
-		retval = matches_r(p.get_root(), item);
+	if (!item) {
+		return false;
 	}
-	return retval;
+
+	bool result = true;
+	size_t pc = 0;
+	while (pc < program.size()) {
+		const Instruction& ins = program[pc];
+		switch (ins.code) {
+		case OpCode::TEST:
+			result = test(ins, item);
+			++pc;
+			break;
+		case OpCode::JUMP_IF_FALSE:
+			pc = result ? pc + 1 : ins.target;
+			break;
+		case OpCode::JUMP_IF_TRUE:
+			pc = result ? ins.target : pc + 1;
+			break;
+		}
+	}
+	return result;
 }
 
-bool Matcher::matchop_lt(expression* e, Matchable* item)
+bool Matcher::has_attribute(const Instruction& ins, Matchable* item)
 {
-	if (!item->has_attribute(e->name))
-		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
-	std::istringstream islit(e->literal);
-	std::istringstream isatt(item->get_attribute(e->name));
-	int ilit, iatt;
-	islit >> ilit;
-	isatt >> iatt;
-	return iatt < ilit;
+	if (ins.attrib == AttributeId::UNKNOWN) {
+		return item->has_attribute(ins.name);
+	}
+	return item->has_attribute_id(ins.attrib);
 }
 
-bool Matcher::matchop_between(expression* e, Matchable* item)
+std::string Matcher::get_attribute(const Instruction& ins, Matchable* item)
 {
-	if (!item->has_attribute(e->name))
-		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
-	std::vector<std::string> lit = utils::tokenize(e->literal, ":");
-	std::istringstream isatt(item->get_attribute(e->name));
-	int att;
-	isatt >> att;
-	if (lit.size() < 2)
-		return false;
-	std::istringstream is1(lit[0]), is2(lit[1]);
-	int i1, i2;
-	is1 >> i1;
-	is2 >> i2;
-	if (i1 > i2) {
-		int tmp = i1;
-		i1 = i2;
-		i2 = tmp;
+	if (ins.attrib == AttributeId::UNKNOWN) {
+		return item->get_attribute(ins.name);
 	}
-	return (att >= i1 && att <= i2);
+	return item->get_attribute_id(ins.attrib);
 }
 
-bool Matcher::matchop_gt(expression* e, Matchable* item)
+int Matcher::get_numeric_attribute(const Instruction& ins, Matchable* item)
 {
-	if (!item->has_attribute(e->name))
-		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
-	std::istringstream islit(e->literal);
-	std::istringstream isatt(item->get_attribute(e->name));
-	int ilit, iatt;
-	islit >> ilit;
-	isatt >> iatt;
-	return iatt > ilit;
+	long value;
+	if (ins.attrib != AttributeId::UNKNOWN &&
+		item->get_numeric_attribute_id(ins.attrib, value)) {
+		return clamp_to_int(value);
+	}
+	return parse_int(get_attribute(ins, item));
 }
 
-bool Matcher::matchop_rxeq(expression* e, Matchable* item)
+bool Matcher::test(const Instruction& ins, Matchable* item)
 {
-	if (!item->has_attribute(e->name))
+	if (ins.matchop == LOGOP_INVALID) {
+		return ins.negate;
+	}
+
+	if (!has_attribute(ins, item)) {
+		if (ins.matchop == MATCHOP_EQ) {
+			LOG(Level::WARN,
+				"Matcher::matches: attribute %s not available",
+				ins.name);
+		}
 		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
-	if (!e->regex) {
-		e->regex = new regex_t;
-		int err;
-		if ((err = regcomp(e->regex,
-			     e->literal.c_str(),
-			     REG_EXTENDED | REG_ICASE | REG_NOSUB)) != 0) {
-			char buf[1024];
-			regerror(err, e->regex, buf, sizeof(buf));
+			MatcherException::Type::ATTRIB_UNAVAIL, ins.name);
+	}
+
+	bool result = false;
+	switch (ins.matchop) {
+	case MATCHOP_EQ:
+		result = (get_attribute(ins, item) == ins.literal);
+		break;
+
+	case MATCHOP_LT:
+		result = (get_numeric_attribute(ins, item) < ins.number);
+		break;
+
+	case MATCHOP_GT:
+		result = (get_numeric_attribute(ins, item) > ins.number);
+		break;
+
+	case MATCHOP_BETWEEN:
+		if (ins.range_valid) {
+			const int att = get_numeric_attribute(ins, item);
+			result = (att >= ins.range_lower &&
+				att <= ins.range_upper);
+		}
+		break;
+
+	case MATCHOP_RXEQ:
+		if (!ins.regex_error.empty()) {
 			throw MatcherException(
 				MatcherException::Type::INVALID_REGEX,
-				e->literal,
-				buf);
+				ins.literal,
+				ins.regex_error);
+		}
+		result = (regexec(ins.regex.get(),
+				  get_attribute(ins, item).c_str(),
+				  0,
+				  nullptr,
+				  0) == 0);
+		break;
+
+	case MATCHOP_CONTAINS:
+		if (ins.attrib == AttributeId::UNKNOWN ||
+			!item->attribute_contains(
+				ins.attrib, ins.literal, result)) {
+			result = contains_token(
+					get_attribute(ins, item), ins.literal);
 		}
+		break;
 	}
-	if (regexec(e->regex,
-		    item->get_attribute(e->name).c_str(),
-		    0,
-		    nullptr,
-		    0) == 0)
-		return true;
-	return false;
+
+	return ins.negate ? !result : result;
 }
 
-bool Matcher::matchop_cont(expression* e, Matchable* item)
+std::vector<bool> Matcher::matches_all(const std::vector<Matchable*>& items)
 {
-	if (!item->has_attribute(e->name))
-		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
-	std::vector<std::string> elements =
-		utils::tokenize(item->get_attribute(e->name), " ");
-	std::string literal = e->literal;
-	for (const auto& elem : elements) {
-		if (literal == elem) {
-			return true;
+	std::vector<bool> matched(items.size());
+
+	/* Results that are already known are looked up first, so that only the
+	 * rest has to be evaluated, and the lock is only taken twice. */
+	std::vector<size_t> pending;
+	std::vector<unsigned long> revisions(items.size());
+	std::vector<char> has_revision(items.size());
+	{
+		std::unique_lock<std::mutex> lock(results_mtx, std::defer_lock);
+		if (cacheable) {
+			lock.lock();
+		}
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (!items[i]) {
+				continue;
+			}
+			if (cacheable && items[i]->get_revision(revisions[i])) {
+				has_revision[i] = 1;
+				const auto it = results.find(items[i]);
+				if (it != results.end() &&
+					it->second.revision == revisions[i]) {
+					matched[i] = it->second.matched;
+					continue;
+				}
+			}
+			pending.push_back(i);
 		}
 	}
-	return false;
-}
 
-bool Matcher::matchop_eq(expression* e, Matchable* item)
-{
-	if (!item->has_attribute(e->name)) {
-		LOG(Level::WARN,
-			"Matcher::matches_r: attribute %s not available",
-			e->name);
-		throw MatcherException(
-			MatcherException::Type::ATTRIB_UNAVAIL, e->name);
+	const std::vector<char> evaluated = evaluate_all(items, pending);
+
+	std::unique_lock<std::mutex> lock(results_mtx, std::defer_lock);
+	if (cacheable) {
+		lock.lock();
+	}
+	for (size_t j = 0; j < pending.size(); ++j) {
+		const size_t i = pending[j];
+		matched[i] = evaluated[j];
+		if (has_revision[i]) {
+			remember(items[i], revisions[i], evaluated[j]);
+		}
 	}
-	return (item->get_attribute(e->name) == e->literal);
+	return matched;
 }
 
-bool Matcher::matches_r(expression* e, Matchable* item)
+std::vector<char> Matcher::evaluate_all(const std::vector<Matchable*>& items,
+	const std::vector<size_t>& indexes)
 {
-	if (e) {
-		switch (e->op) {
-		/* the operator "and" and "or" simply connect two different
-		 * subexpressions */
-		case LOGOP_AND:
-			return matches_r(e->l, item) &&
-				matches_r(e->r, item); // short-circuit
-						       // evaulation in C ->
-						       // short circuit
-						       // evaluation in the
-						       // filter language
+	/* The program is read-only once compiled (regexes included), so any
+	 * number of threads can run it at once. Below this many items per
+	 * thread, starting the threads costs more than it saves. */
+	const size_t min_items_per_thread = 2000;
+	const size_t num_threads = std::min<size_t>(
+			std::max(1u, std::thread::hardware_concurrency()),
+			indexes.size() / min_items_per_thread);
+
+	// std::vector<bool> can't be written from several threads
+	std::vector<char> matched(indexes.size());
+	if (num_threads <= 1) {
+		for (size_t j = 0; j < indexes.size(); ++j) {
+			matched[j] = evaluate(items[indexes[j]]);
+		}
+		return matched;
+	}
 
-		case LOGOP_OR:
-			return matches_r(e->l, item) ||
-				matches_r(e->r, item); // same here
+	std::vector<std::exception_ptr> errors(num_threads);
+	const auto match_range = [&](size_t part, size_t first, size_t last) {
+		try {
+			for (size_t j = first; j <= last; ++j) {
+				matched[j] = evaluate(items[indexes[j]]);
+			}
+		} catch (...) {
+			errors[part] = std::current_exception();
+		}
+	};
+
+	const auto partitions =
+		utils::partition_indexes(0, indexes.size() - 1, num_threads);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i + 1 < partitions.size(); ++i) {
+		threads.emplace_back(match_range,
+			i,
+			partitions[i].first,
+			partitions[i].second);
+	}
+	match_range(partitions.size() - 1,
+		partitions.back().first,
+		partitions.back().second);
+	for (auto& thread : threads) {
+		thread.join();
+	}
 
-		/* while the other operator connect an attribute with a value */
-		case MATCHOP_EQ:
-			return matchop_eq(e, item);
+	// partitions are in order, so the first error is the one of the
+	// first item that failed
+	for (const auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
 
-		case MATCHOP_NE:
-			return !matchop_eq(e, item);
+	return matched;
+}
 
-		case MATCHOP_LT:
-			return matchop_lt(e, item);
+bool Matcher::uses_attribute(AttributeId id) const
+{
+	for (const auto& ins : program) {
+		if (ins.code == OpCode::TEST && ins.attrib == id) {
+			return true;
+		}
+	}
+	return false;
+}
 
-		case MATCHOP_BETWEEN:
-			return matchop_between(e, item);
+/* Returns an SQL expression on `rss_item` columns that yields the same string
+ * as RssItem::get_attribute_id(), or an empty string if there is none. */
+static std::string sql_column(AttributeId id)
+{
+	switch (id) {
+	case AttributeId::TITLE:
+	case AttributeId::AUTHOR:
+		// RssItem converts these from UTF-8 to the locale's charset,
+		// which is a no-op only in UTF-8 locales
+		if (strcasecmp(nl_langinfo(CODESET), "UTF-8") != 0) {
+			return "";
+		}
+		return (id == AttributeId::TITLE) ? "title" : "author";
+	case AttributeId::LINK:
+		return "url";
+	case AttributeId::GUID:
+		return "guid";
+	case AttributeId::UNREAD:
+		return "(CASE unread WHEN 1 THEN 'yes' ELSE 'no' END)";
+	case AttributeId::ENCLOSURE_URL:
+		return "coalesce(enclosure_url, '')";
+	case AttributeId::ENCLOSURE_TYPE:
+		return "coalesce(enclosure_type, '')";
+	case AttributeId::FLAGS:
+		return "coalesce(flags, '')";
+	default:
+		return "";
+	}
+}
 
-		case MATCHOP_GT:
-			return matchop_gt(e, item);
+static std::string sql_quote(const std::string& literal)
+{
+	return "'" + utils::replace_all(literal, "'", "''") + "'";
+}
 
-		case MATCHOP_LE:
-			return !matchop_gt(e, item);
+bool Matcher::to_sql(std::string& condition)
+{
+	if (!errmsg.empty()) {
+		return false;
+	}
+	return to_sql(p.get_root(), time(nullptr), condition);
+}
 
-		case MATCHOP_GE:
-			return !matchop_lt(e, item);
+bool Matcher::to_sql(expression* e, time_t now, std::string& condition)
+{
+	if (!e) {
+		// a missing subexpression always matches, see compile_test()
+		condition = "1";
+		return true;
+	}
 
-		case MATCHOP_RXEQ:
-			return matchop_rxeq(e, item);
+	if (e->op == LOGOP_AND || e->op == LOGOP_OR) {
+		std::string left, right;
+		if (!to_sql(e->l, now, left) || !to_sql(e->r, now, right)) {
+			return false;
+		}
+		condition = "(" + left +
+			(e->op == LOGOP_AND ? " AND " : " OR ") + right + ")";
+		return true;
+	}
 
-		case MATCHOP_RXNE:
-			return !matchop_rxeq(e, item);
+	const Instruction ins = compile_test(e);
+	if (ins.matchop == LOGOP_INVALID) {
+		condition = ins.negate ? "1" : "0";
+		return true;
+	}
 
-		case MATCHOP_CONTAINS:
-			return matchop_cont(e, item);
+	std::string column;
+	if (ins.attrib == AttributeId::AGE) {
+		column = "((" + std::to_string(now) + " - pubDate) / 86400)";
+	} else {
+		column = sql_column(ins.attrib);
+	}
+	if (column.empty()) {
+		return false;
+	}
 
-		case MATCHOP_CONTAINSNOT:
-			return !matchop_cont(e, item);
+	std::string result;
+	switch (ins.matchop) {
+	case MATCHOP_EQ:
+		result = column + " = " + sql_quote(ins.literal);
+		break;
+
+	case MATCHOP_LT:
+	case MATCHOP_GT:
+	case MATCHOP_BETWEEN:
+		// other attributes would need to be parsed like parse_int() does
+		if (ins.attrib != AttributeId::AGE) {
+			return false;
 		}
+		if (ins.matchop == MATCHOP_BETWEEN) {
+			result = ins.range_valid
+				? column + " BETWEEN " +
+				std::to_string(ins.range_lower) + " AND " +
+				std::to_string(ins.range_upper)
+				: "0";
+		} else {
+			result = column +
+				(ins.matchop == MATCHOP_LT ? " < " : " > ") +
+				std::to_string(ins.number);
+		}
+		break;
+
+	case MATCHOP_CONTAINS:
+		if (ins.literal.empty() ||
+			ins.literal.find(' ') != std::string::npos) {
+			result = "0";
+		} else {
+			result = "instr(' ' || " + column + " || ' ', " +
+				sql_quote(" " + ins.literal + " ") + ") > 0";
+		}
+		break;
+
+	default:
 		return false;
-	} else {
-		return true; // shouldn't happen
 	}
+
+	condition = (ins.negate ? "NOT (" : "(") + result + ")";
+	return true;
 }
 
 const std::string& Matcher::get_parse_error()
@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <string.h>
 #include <time.h>
+#include <utility>
 
+#include "dateparser.h"
 #include "json.h"
 #include "remoteapi.h"
 #include "rsspp.h"
@@ -211,15 +213,6 @@ bool NewsBlurApi::update_article_flags(const std::string& /* oldflags */,
 	return false;
 }
 
-time_t parse_date(const char* raw)
-{
-	struct tm tm;
-	memset(&tm, 0, sizeof(tm));
-
-	strptime(raw, "%Y-%m-%d %H:%M:%S", &tm);
-	return mktime(&tm);
-}
-
 rsspp::Feed NewsBlurApi::fetch_feed(const std::string& id)
 {
 	rsspp::Feed f = known_feeds[id];
@@ -313,17 +306,21 @@ rsspp::Feed NewsBlurApi::fetch_feed(const std::string& id)
 				    item_obj, "story_date", &node) == TRUE) {
 				const char* pub_date =
 					json_object_get_string(node);
-				item.pubDate_ts = parse_date(pub_date);
-
-				char rfc822_date[128];
-				strftime(rfc822_date,
-					sizeof(rfc822_date),
-					"%a, %d %b %Y %H:%M:%S %z",
-					gmtime(&item.pubDate_ts));
-				item.pubDate = rfc822_date;
+				// "2018-09-22 18:27:01", in UTC
+				const time_t date = rsspp::parse_date(pub_date);
+				if (date != -1) {
+					item.pubDate_ts = date;
+
+					char rfc822_date[128];
+					strftime(rfc822_date,
+						sizeof(rfc822_date),
+						"%a, %d %b %Y %H:%M:%S %z",
+						gmtime(&item.pubDate_ts));
+					item.pubDate = rfc822_date;
+				}
 			}
 
-			f.items.push_back(item);
+			f.items.push_back(std::move(item));
 		}
 	}
 
@@ -7,6 +7,7 @@
 #include <json-c/json.h>
 #include <memory>
 #include <time.h>
+#include <utility>
 
 #include "utils.h"
 
@@ -276,8 +277,9 @@ rsspp::Feed OcNewsApi::fetch_feed(const std::string& feed_id)
 			"%a, %d %b %Y %H:%M:%S %z",
 			gmtime(&updated));
 		item.pubDate = rfc822_date;
+		item.pubDate_ts = updated;
 
-		feed.items.push_back(item);
+		feed.items.push_back(std::move(item));
 	}
 
 	return feed;
@@ -0,0 +1,422 @@
+#include "processpool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "logger.h"
+
+extern char** environ;
+
+namespace newsboat {
+
+// how long a child may linger after SIGTERM before it gets SIGKILL
+static const std::chrono::milliseconds kill_grace_period(2000);
+
+// how often we check whether a child that closed its stdout has exited
+static const std::chrono::milliseconds reap_interval(10);
+
+// how often a waiting worker checks whether the pool is being shut down
+static const int shutdown_poll_ms = 100;
+
+static void set_nonblocking(int fd)
+{
+	::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void close_fd(int& fd)
+{
+	if (fd != -1) {
+		::close(fd);
+		fd = -1;
+	}
+}
+
+/*
+ * Returns true and fills \a exit_status if the child is gone. SIGCHLD handler
+ * in Controller reaps children on its own, so ECHILD means "already exited,
+ * status unknown".
+ */
+static bool try_reap(pid_t pid, int& exit_status, bool block)
+{
+	int status = 0;
+	pid_t rc;
+	do {
+		rc = ::waitpid(pid, &status, block ? 0 : WNOHANG);
+	} while (rc == -1 && errno == EINTR);
+
+	if (rc == pid) {
+		exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+		return true;
+	}
+	return rc == -1;
+}
+
+static void terminate(pid_t pid, int& exit_status)
+{
+	LOG(Level::INFO, "ProcessPool: sending SIGTERM to process group %d", pid);
+	::kill(-pid, SIGTERM);
+
+	const auto deadline =
+		std::chrono::steady_clock::now() + kill_grace_period;
+	while (std::chrono::steady_clock::now() < deadline) {
+		if (try_reap(pid, exit_status, false)) {
+			return;
+		}
+		std::this_thread::sleep_for(reap_interval);
+	}
+
+	LOG(Level::INFO, "ProcessPool: sending SIGKILL to process group %d", pid);
+	::kill(-pid, SIGKILL);
+	try_reap(pid, exit_status, true);
+}
+
+ProcessPool& ProcessPool::getInstance()
+{
+	static ProcessPool instance;
+	return instance;
+}
+
+ProcessPool::~ProcessPool()
+{
+	shutdown();
+}
+
+void ProcessPool::shutdown()
+{
+	std::vector<std::thread> threads;
+	std::deque<Job> dropped;
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stopping = true;
+		threads.swap(workers);
+		dropped.swap(queue);
+		prefetched.clear();
+	}
+	queue_cv.notify_all();
+
+	for (auto& job : dropped) {
+		job.result.set_value(ProcessResult());
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	// the tests make and destroy several Controllers, and each of them
+	// shuts the pool down
+	std::lock_guard<std::mutex> lock(mtx);
+	stopping = false;
+}
+
+void ProcessPool::set_max_processes(unsigned int n)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		max_processes = (n == 0) ? 1 : n;
+	}
+	// idle workers beyond the new limit exit
+	queue_cv.notify_all();
+}
+
+void ProcessPool::set_timeout(unsigned int seconds)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	timeout = seconds;
+}
+
+ProcessResult ProcessPool::run(const std::vector<std::string>& argv,
+	const std::string& input)
+{
+	return submit(argv, input).get();
+}
+
+void ProcessPool::run_in_background(const std::vector<std::string>& argv)
+{
+	submit(argv, "");
+}
+
+ProcessResult ProcessPool::run_shell(const std::string& cmdline,
+	const std::string& input)
+{
+	if (input.empty()) {
+		std::shared_future<ProcessResult> future;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			const auto it = prefetched.find(cmdline);
+			if (it != prefetched.end()) {
+				future = it->second;
+				prefetched.erase(it);
+			}
+		}
+		if (future.valid()) {
+			LOG(Level::DEBUG,
+				"ProcessPool::run_shell: using prefetched "
+				"output of `%s'",
+				cmdline);
+			return future.get();
+		}
+	}
+
+	return run({"/bin/sh", "-c", cmdline}, input);
+}
+
+void ProcessPool::prefetch_shell(const std::string& cmdline)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (prefetched.count(cmdline) != 0) {
+			return;
+		}
+	}
+	auto future = submit({"/bin/sh", "-c", cmdline}, "");
+
+	std::lock_guard<std::mutex> lock(mtx);
+	prefetched.emplace(cmdline, future);
+}
+
+void ProcessPool::discard_prefetched()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	prefetched.clear();
+}
+
+std::shared_future<ProcessResult> ProcessPool::submit(
+	const std::vector<std::string>& argv,
+	const std::string& input)
+{
+	Job job;
+	job.argv = argv;
+	job.input = input;
+	std::shared_future<ProcessResult> future = job.result.get_future();
+
+	std::lock_guard<std::mutex> lock(mtx);
+	if (stopping) {
+		job.result.set_value(ProcessResult());
+		return future;
+	}
+	queue.push_back(std::move(job));
+	if (running_workers < max_processes) {
+		// Workers are joined by shutdown(), so that none of them is
+		// left using the pool while it's destroyed at exit.
+		++running_workers;
+		workers.emplace_back(&ProcessPool::worker, this);
+	} else {
+		queue_cv.notify_one();
+	}
+
+	return future;
+}
+
+void ProcessPool::worker()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	for (;;) {
+		queue_cv.wait(lock, [this]() {
+			return stopping || !queue.empty() ||
+				running_workers > max_processes;
+		});
+		if (stopping || running_workers > max_processes) {
+			--running_workers;
+			return;
+		}
+
+		Job job = std::move(queue.front());
+		queue.pop_front();
+		const unsigned int job_timeout = timeout;
+		lock.unlock();
+
+		job.result.set_value(execute(job.argv, job.input, job_timeout));
+
+		lock.lock();
+	}
+}
+
+ProcessResult ProcessPool::execute(const std::vector<std::string>& argv,
+	const std::string& input,
+	unsigned int seconds)
+{
+	ProcessResult result;
+	if (argv.empty()) {
+		return result;
+	}
+
+	// Other threads fork too (e.g. to run a browser), so the pipes must
+	// be close-on-exec from the start; otherwise such a child could hold
+	// on to them and we'd never see EOF.
+	int in_pipe[2];
+	int out_pipe[2];
+	if (::pipe2(in_pipe, O_CLOEXEC) != 0) {
+		return result;
+	}
+	if (::pipe2(out_pipe, O_CLOEXEC) != 0) {
+		::close(in_pipe[0]);
+		::close(in_pipe[1]);
+		return result;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, in_pipe[0], 0);
+	posix_spawn_file_actions_adddup2(&actions, out_pipe[1], 1);
+	posix_spawn_file_actions_addopen(
+		&actions, 2, "/dev/null", O_WRONLY, 0);
+
+	// The child gets its own process group, so that a timeout kills
+	// everything spawned by `sh -c` and not just the shell itself.
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	sigset_t sigs;
+	sigemptyset(&sigs);
+	posix_spawnattr_setsigmask(&attr, &sigs);
+	sigaddset(&sigs, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &sigs);
+	posix_spawnattr_setpgroup(&attr, 0);
+	posix_spawnattr_setflags(&attr,
+		POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK |
+			POSIX_SPAWN_SETSIGDEF);
+
+	std::vector<char*> c_argv;
+	for (const auto& arg : argv) {
+		c_argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	c_argv.push_back(nullptr);
+
+	pid_t pid;
+	const int rc = ::posix_spawnp(
+		&pid, c_argv[0], &actions, &attr, c_argv.data(), environ);
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+
+	::close(in_pipe[0]);
+	::close(out_pipe[1]);
+	int to_child = in_pipe[1];
+	int from_child = out_pipe[0];
+
+	if (rc != 0) {
+		LOG(Level::ERROR,
+			"ProcessPool: couldn't spawn `%s': %s",
+			argv[0],
+			strerror(rc));
+		close_fd(to_child);
+		close_fd(from_child);
+		return result;
+	}
+	LOG(Level::DEBUG, "ProcessPool: spawned `%s' as %d", argv.back(), pid);
+
+	set_nonblocking(to_child);
+	set_nonblocking(from_child);
+	if (input.empty()) {
+		close_fd(to_child);
+	}
+
+	const bool has_deadline = seconds > 0;
+	const auto deadline =
+		std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+	size_t written = 0;
+	char buf[65536];
+
+	while (from_child != -1) {
+		if (stopping) {
+			result.timed_out = true;
+			break;
+		}
+
+		int wait_ms = shutdown_poll_ms;
+		if (has_deadline) {
+			const auto left =
+				std::chrono::duration_cast<
+					std::chrono::milliseconds>(
+					deadline - std::chrono::steady_clock::now())
+					.count();
+			if (left <= 0) {
+				result.timed_out = true;
+				break;
+			}
+			wait_ms = std::min(
+				wait_ms, static_cast<int>(left));
+		}
+
+		struct pollfd fds[2];
+		nfds_t nfds = 0;
+		fds[nfds++] = {from_child, POLLIN, 0};
+		if (to_child != -1) {
+			fds[nfds++] = {to_child, POLLOUT, 0};
+		}
+
+		const int ready = ::poll(fds, nfds, wait_ms);
+		if (ready == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		if (fds[0].revents != 0) {
+			ssize_t n;
+			while ((n = ::read(from_child, buf, sizeof(buf))) > 0) {
+				result.output.append(buf, n);
+			}
+			if (n == 0 || (n == -1 && errno != EAGAIN &&
+						  errno != EINTR)) {
+				close_fd(from_child);
+			}
+		}
+
+		if (nfds > 1 && fds[1].revents != 0) {
+			const ssize_t n = ::write(to_child,
+				input.data() + written,
+				input.length() - written);
+			if (n > 0) {
+				written += n;
+			}
+			if (written == input.length() ||
+				(n == -1 && errno != EAGAIN && errno != EINTR)) {
+				close_fd(to_child);
+			}
+		}
+	}
+	close_fd(to_child);
+	close_fd(from_child);
+
+	// The child closed its stdout, but may still be running.
+	while (!result.timed_out && !try_reap(pid, result.exit_status, false)) {
+		if (stopping || (has_deadline &&
+				    std::chrono::steady_clock::now() >=
+					    deadline)) {
+			result.timed_out = true;
+			break;
+		}
+		std::this_thread::sleep_for(reap_interval);
+	}
+
+	if (result.timed_out) {
+		if (stopping) {
+			LOG(Level::INFO,
+				"ProcessPool: shutting down, killing `%s'",
+				argv.back());
+		} else {
+			LOG(Level::USERERROR,
+				"`%s' didn't finish within %u seconds, killing "
+				"it",
+				argv.back(),
+				seconds);
+		}
+		terminate(pid, result.exit_status);
+	}
+
+	LOG(Level::DEBUG,
+		"ProcessPool: process %d finished with status %d",
+		pid,
+		result.exit_status);
+	return result;
+}
+
+} // namespace newsboat
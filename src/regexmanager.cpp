@@ -1,5 +1,6 @@
 #include "regexmanager.h"
 
+#include <cctype>
 #include <cstring>
 
 #include "config.h"
@@ -40,6 +41,7 @@ void RegexManager::dump_config(std::vector<std::string>& config_output)
 void RegexManager::handle_action(const std::string& action,
 	const std::vector<std::string>& params)
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	if (action == "highlight") {
 		if (params.size() < 3)
 			throw ConfigHandlerException(
@@ -112,6 +114,7 @@ void RegexManager::handle_action(const std::string& action,
 				location);
 			locations[location].first.push_back(rx);
 			locations[location].second.push_back(colorstr);
+			add_pattern(location, params[1]);
 		} else {
 			delete rx;
 			for (auto& location : locations) {
@@ -130,6 +133,7 @@ void RegexManager::handle_action(const std::string& action,
 					REG_EXTENDED | REG_ICASE);
 				location.second.first.push_back(rx);
 				location.second.second.push_back(colorstr);
+				add_pattern(location.first, params[1]);
 			}
 		}
 		std::string line = "highlight";
@@ -194,6 +198,7 @@ void RegexManager::handle_action(const std::string& action,
 
 		locations["articlelist"].first.push_back(nullptr);
 		locations["articlelist"].second.push_back(colorstr);
+		add_pattern("articlelist", "");
 
 		matchers.push_back(
 			std::pair<std::shared_ptr<Matcher>, int>(m, pos));
@@ -215,11 +220,129 @@ int RegexManager::article_matches(Matchable* item)
 
 void RegexManager::remove_last_regex(const std::string& location)
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	std::vector<regex_t*>& regexes = locations[location].first;
 
 	auto it = regexes.begin() + regexes.size() - 1;
 	delete *it;
 	regexes.erase(it);
+
+	Prefilter& prefilter = prefilters[location];
+	if (!prefilter.patterns.empty()) {
+		prefilter.patterns.pop_back();
+	}
+	prefilter.valid = false;
+	revision_++;
+}
+
+void RegexManager::add_pattern(const std::string& location,
+	const std::string& pattern)
+{
+	Prefilter& prefilter = prefilters[location];
+	prefilter.patterns.push_back(pattern);
+	prefilter.valid = false;
+	revision_++;
+}
+
+/* Patterns are only combined this many at a time, so that a line that one
+ * pattern matches doesn't make us run all of them separately. */
+static const size_t max_patterns_per_group = 16;
+
+static bool has_backreference(const std::string& pattern)
+{
+	for (size_t i = 0; i + 1 < pattern.length(); ++i) {
+		if (pattern[i] == '\\' && isdigit(static_cast<unsigned char>(pattern[i + 1]))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static std::shared_ptr<regex_t> combine_patterns(
+	const std::vector<std::string>& patterns,
+	size_t begin,
+	size_t end)
+{
+	std::string alternatives;
+	for (size_t i = begin; i < end; ++i) {
+		if (i != begin) {
+			alternatives.append("|");
+		}
+		alternatives.append("(" + patterns[i] + ")");
+	}
+
+	regex_t* rx = new regex_t;
+	if (regcomp(rx,
+			alternatives.c_str(),
+			REG_EXTENDED | REG_ICASE | REG_NOSUB) != 0) {
+		delete rx;
+		return nullptr;
+	}
+	return std::shared_ptr<regex_t>(rx, [](regex_t* r) {
+		regfree(r);
+		delete r;
+	});
+}
+
+const std::vector<RegexManager::PatternGroup>&
+RegexManager::get_pattern_groups(const std::string& location)
+{
+	Prefilter& prefilter = prefilters[location];
+	if (prefilter.valid) {
+		return prefilter.groups;
+	}
+
+	const std::vector<regex_t*>& regexes = locations[location].first;
+	prefilter.groups.clear();
+	prefilter.valid = true;
+
+	if (prefilter.patterns.size() != regexes.size()) {
+		// the regexes were changed through get_regexes(); we don't know
+		// their patterns, so each one has to be run
+		unsigned int marker = 0;
+		for (size_t i = 0; i < regexes.size(); ++i) {
+			prefilter.groups.push_back({i, i + 1, marker, nullptr});
+			if (regexes[i]) {
+				++marker;
+			}
+		}
+		return prefilter.groups;
+	}
+
+	/* Backreferences would refer to the wrong group once the patterns are
+	 * combined, and highlight-article placeholders have no pattern at all,
+	 * so those end up in groups of their own. */
+	const auto combinable = [&](size_t i) {
+		return regexes[i] && !has_backreference(prefilter.patterns[i]);
+	};
+
+	unsigned int marker = 0;
+	size_t begin = 0;
+	while (begin < regexes.size()) {
+		size_t end = begin + 1;
+		if (combinable(begin)) {
+			while (end < regexes.size() &&
+				end - begin < max_patterns_per_group &&
+				combinable(end)) {
+				++end;
+			}
+		}
+
+		std::shared_ptr<regex_t> combined;
+		if (combinable(begin)) {
+			combined = combine_patterns(prefilter.patterns, begin, end);
+		}
+		prefilter.groups.push_back({begin, end, marker, combined});
+
+		for (size_t i = begin; i < end; ++i) {
+			if (regexes[i]) {
+				++marker;
+			}
+		}
+		begin = end;
+	}
+
+	return prefilter.groups;
 }
 
 std::string RegexManager::extract_initial_marker(const std::string& str)
@@ -239,36 +362,57 @@ std::string RegexManager::extract_initial_marker(const std::string& str)
 void RegexManager::quote_and_highlight(std::string& str,
 	const std::string& location)
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	std::vector<regex_t*>& regexes = locations[location].first;
 
-	unsigned int i = 0;
-	for (const auto& regex : regexes) {
-		if (!regex) {
+	/* Each regex sees the markers inserted for the ones before it, so the
+	 * combined regexes can only be used to skip groups until the first
+	 * highlight is inserted. From then on, every regex is run as before. */
+	bool highlighted = false;
+	for (const auto& group : get_pattern_groups(location)) {
+		if (!highlighted && group.combined &&
+			regexec(group.combined.get(), str.c_str(), 0, nullptr, 0) !=
+			0) {
 			continue;
 		}
-		std::string initial_marker = extract_initial_marker(str);
-		regmatch_t pmatch;
-		unsigned int offset = 0;
-		int err = regexec(regex, str.c_str(), 1, &pmatch, 0);
-		while (err == 0) {
-			if (pmatch.rm_so != pmatch.rm_eo) {
-				const std::string marker = strprintf::fmt("<%u>", i);
-				str.insert(offset + pmatch.rm_eo,
-						std::string("</>") + initial_marker);
-				str.insert(offset + pmatch.rm_so, marker);
-				offset += pmatch.rm_eo + marker.length() +
-					strlen("</>") + initial_marker.length();
-			}
-			else {
-				offset++;
+
+		unsigned int i = group.first_marker;
+		for (size_t r = group.begin; r < group.end; ++r) {
+			regex_t* regex = regexes[r];
+			if (!regex) {
+				continue;
 			}
-			if (offset >= str.length()) {
-				break;
+			std::string initial_marker = extract_initial_marker(str);
+			regmatch_t pmatch;
+			unsigned int offset = 0;
+			int err = regexec(regex, str.c_str(), 1, &pmatch, 0);
+			while (err == 0) {
+				if (pmatch.rm_so != pmatch.rm_eo) {
+					const std::string marker =
+						strprintf::fmt("<%u>", i);
+					str.insert(offset + pmatch.rm_eo,
+						std::string("</>") +
+						initial_marker);
+					str.insert(offset + pmatch.rm_so, marker);
+					offset += pmatch.rm_eo +
+						marker.length() +
+						strlen("</>") +
+						initial_marker.length();
+					highlighted = true;
+				} else {
+					offset++;
+				}
+				if (offset >= str.length()) {
+					break;
+				}
+				err = regexec(regex,
+						str.c_str() + offset,
+						1,
+						&pmatch,
+						0);
 			}
-			err = regexec(
-				regex, str.c_str() + offset, 1, &pmatch, 0);
+			i++;
 		}
-		i++;
 	}
 }
 
@@ -9,6 +9,7 @@
 #include "downloadthread.h"
 #include "exceptions.h"
 #include "formatstring.h"
+#include "processpool.h"
 #include "reloadrangethread.h"
 #include "reloadthread.h"
 #include "rss/rsspp.h"
@@ -123,6 +124,8 @@ std::string Reloader::prepare_message(unsigned int pos, unsigned int max)
 
 void Reloader::reload_all(bool unattended)
 {
+	ScopeMeasure m1("Reloader::reload_all");
+
 	const auto unread_feeds =
 		ctrl->get_feedcontainer()->unread_feed_count();
 	const auto unread_articles =
@@ -140,6 +143,15 @@ void Reloader::reload_all(bool unattended)
 
 	t1 = time(nullptr);
 
+	// exec: scripts don't depend on each other, so start them right away
+	// instead of waiting for the reload thread that owns the feed
+	for (const auto& feed : ctrl->get_feedcontainer()->feeds) {
+		if (utils::is_exec_url(feed->rssurl())) {
+			ProcessPool::getInstance().prefetch_shell(
+				feed->rssurl().substr(5));
+		}
+	}
+
 	LOG(Level::DEBUG, "Reloader::reload_all: starting with reload all...");
 	if (num_threads == 1) {
 		reload_range(0, num_feeds - 1, num_feeds, unattended);
@@ -168,6 +180,7 @@ void Reloader::reload_all(bool unattended)
 			threads[i].join();
 		}
 	}
+	ProcessPool::getInstance().discard_prefetched();
 
 	// refresh query feeds (update and sort)
 	LOG(Level::DEBUG, "Reloader::reload_all: refresh query feeds");
@@ -178,6 +191,9 @@ void Reloader::reload_all(bool unattended)
 
 	ctrl->get_feedcontainer()->sort_feeds(cfg->get_feed_sort_strategy());
 	ctrl->update_feedlist();
+	if (!unattended) {
+		ctrl->get_view()->flush_updates();
+	}
 
 	t2 = time(nullptr);
 	dt = t2 - t1;
@@ -237,7 +253,11 @@ void Reloader::reload_indexes(const std::vector<int>& indexes, bool unattended)
 		notify(fmt.do_format(cfg->get_configvalue("notify-format")));
 	}
 	if (!unattended) {
+		// picks up a rebuild of the feed list that replace_feed()
+		// had to postpone
+		ctrl->update_feedlist();
 		ctrl->get_view()->set_status("");
+		ctrl->get_view()->flush_updates();
 	}
 }
 
@@ -299,7 +319,7 @@ void Reloader::notify(const std::string& msg)
 		LOG(Level::DEBUG,
 			"reloader:notify: notifying external program `%s'",
 			prog);
-		utils::run_command(prog, msg);
+		ProcessPool::getInstance().run_in_background({prog, msg});
 	}
 }
 
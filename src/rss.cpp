@@ -11,12 +11,15 @@
 #include <sys/utsname.h>
 #include <string.h>
 #include <time.h>
+#include <unordered_set>
+#include <utility>
 
 #include "cache.h"
 #include "config.h"
 #include "configcontainer.h"
 #include "exceptions.h"
 #include "htmlrenderer.h"
+#include "keyedsort.h"
 #include "logger.h"
 #include "strprintf.h"
 #include "tagsouppullparser.h"
@@ -24,6 +27,15 @@
 
 namespace newsboat {
 
+/* Revisions of items and feeds are drawn from a single counter, so that a
+ * query feed can compare them against the revision of a feed it saw last. */
+static std::atomic<unsigned long> last_revision(0);
+
+static unsigned long next_revision()
+{
+	return ++last_revision;
+}
+
 RssItem::RssItem(Cache* c)
 	: ch(c)
 	, idx(0)
@@ -33,6 +45,33 @@ RssItem::RssItem(Cache* c)
 	, enqueued_(false)
 	, deleted_(0)
 	, override_unread_(false)
+	, revision_(next_revision())
+{
+}
+
+RssItem::RssItem(const RssItem& other)
+	: Matchable(other)
+	, title_(other.title_)
+	, link_(other.link_)
+	, author_(other.author_)
+	, description_(other.description_)
+	, guid_(other.guid_)
+	, feedurl_(other.feedurl_)
+	, ch(other.ch)
+	, enclosure_url_(other.enclosure_url_)
+	, enclosure_type_(other.enclosure_type_)
+	, flags_(other.flags_)
+	, oldflags_(other.oldflags_)
+	, feedptr_(other.feedptr_)
+	, base(other.base)
+	, idx(other.idx)
+	, size_(other.size_)
+	, pubDate_(other.pubDate_)
+	, unread_(other.unread_)
+	, enqueued_(other.enqueued_)
+	, deleted_(other.deleted_)
+	, override_unread_(other.override_unread_)
+	, revision_(other.revision_.load())
 {
 }
 
@@ -46,6 +85,10 @@ RssFeed::RssFeed(Cache* c)
 	, idx(0)
 	, order(0)
 	, status_(DlStatus::SUCCESS)
+	, revision_(next_revision())
+	, items_revision_(revision_.load())
+	, items_sorted(false)
+	, items_sort_strategy()
 {
 }
 
@@ -56,26 +99,30 @@ RssFeed::~RssFeed()
 
 // RssItem setters
 
-void RssItem::set_title(const std::string& t)
+void RssItem::set_title(std::string t)
 {
-	title_ = t;
+	title_ = std::move(t);
 	utils::trim(title_);
+	touch();
 }
 
-void RssItem::set_link(const std::string& l)
+void RssItem::set_link(std::string l)
 {
-	link_ = l;
+	link_ = std::move(l);
 	utils::trim(link_);
+	touch();
 }
 
-void RssItem::set_author(const std::string& a)
+void RssItem::set_author(std::string a)
 {
-	author_ = a;
+	author_ = std::move(a);
+	touch();
 }
 
-void RssItem::set_description(const std::string& d)
+void RssItem::set_description(std::string d)
 {
-	description_ = d;
+	description_ = std::move(d);
+	touch();
 }
 
 void RssItem::set_size(unsigned int size)
@@ -99,21 +146,38 @@ std::string RssItem::length() const
 void RssItem::set_pubDate(time_t t)
 {
 	pubDate_ = t;
+	touch();
 }
 
-void RssItem::set_guid(const std::string& g)
+void RssItem::set_guid(std::string g)
 {
-	guid_ = g;
+	guid_ = std::move(g);
+	touch();
+}
+
+void RssItem::touch()
+{
+	const unsigned long revision = next_revision();
+	revision_ = revision;
+	std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
+	if (feedptr)
+		feedptr->item_changed(revision);
 }
 
 void RssItem::set_unread_nowrite(bool u)
 {
-	unread_ = u;
+	if (unread_ != u) {
+		unread_ = u;
+		touch();
+	}
 }
 
 void RssItem::set_unread_nowrite_notify(bool u, bool notify)
 {
-	unread_ = u;
+	if (unread_ != u) {
+		unread_ = u;
+		touch();
+	}
 	std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 	if (feedptr && notify) {
 		feedptr->get_item_by_guid(guid_)->set_unread_nowrite(
@@ -126,6 +190,7 @@ void RssItem::set_unread(bool u)
 	if (unread_ != u) {
 		bool old_u = unread_;
 		unread_ = u;
+		touch();
 		std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 		if (feedptr)
 			feedptr->get_item_by_guid(guid_)->set_unread_nowrite(
@@ -146,11 +211,11 @@ void RssItem::set_unread(bool u)
 
 std::string RssItem::pubDate() const
 {
+	// localtime_r() because filters may be evaluated on several threads
+	struct tm stm;
+	localtime_r(&pubDate_, &stm);
 	char text[1024];
-	strftime(text,
-		sizeof(text),
-		_("%a, %d %b %Y %T %z"),
-		localtime(&pubDate_));
+	strftime(text, sizeof(text), _("%a, %d %b %Y %T %z"), &stm);
 	return std::string(text);
 }
 
@@ -192,16 +257,32 @@ std::string RssFeed::get_tags()
 void RssFeed::set_tags(const std::vector<std::string>& tags)
 {
 	tags_ = tags;
+	tag_words.clear();
+	for (const auto& t : tags_) {
+		if (t.substr(0, 1) != "~" && t.substr(0, 1) != "!") {
+			for (const auto& word : utils::tokenize(t, " ")) {
+				tag_words.insert(word);
+			}
+		}
+	}
+	items_changed();
+}
+
+void RssFeed::items_changed()
+{
+	items_revision_ = revision_ = next_revision();
 }
 
-void RssItem::set_enclosure_url(const std::string& url)
+void RssItem::set_enclosure_url(std::string url)
 {
-	enclosure_url_ = url;
+	enclosure_url_ = std::move(url);
+	touch();
 }
 
-void RssItem::set_enclosure_type(const std::string& type)
+void RssItem::set_enclosure_type(std::string type)
 {
-	enclosure_type_ = type;
+	enclosure_type_ = std::move(type);
+	touch();
 }
 
 std::string RssItem::title() const
@@ -276,58 +357,136 @@ std::shared_ptr<RssItem> RssFeed::get_item_by_guid_unlocked(
 
 bool RssItem::has_attribute(const std::string& attribname)
 {
-	if (attribname == "title" || attribname == "link" ||
-		attribname == "author" || attribname == "content" ||
-		attribname == "date" || attribname == "guid" ||
-		attribname == "unread" || attribname == "enclosure_url" ||
-		attribname == "enclosure_type" || attribname == "flags" ||
-		attribname == "age" || attribname == "articleindex")
+	return has_attribute_id(attribute_id(attribname));
+}
+
+std::string RssItem::get_attribute(const std::string& attribname)
+{
+	return get_attribute_id(attribute_id(attribname));
+}
+
+bool RssItem::has_attribute_id(AttributeId id)
+{
+	switch (id) {
+	case AttributeId::TITLE:
+	case AttributeId::LINK:
+	case AttributeId::AUTHOR:
+	case AttributeId::CONTENT:
+	case AttributeId::DATE:
+	case AttributeId::GUID:
+	case AttributeId::UNREAD:
+	case AttributeId::ENCLOSURE_URL:
+	case AttributeId::ENCLOSURE_TYPE:
+	case AttributeId::FLAGS:
+	case AttributeId::AGE:
+	case AttributeId::ARTICLEINDEX:
 		return true;
+	case AttributeId::UNKNOWN:
+		return false;
+	default:
+		break;
+	}
 
 	// if we have a feed, then forward the request
 	std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 	if (feedptr)
-		return feedptr->RssFeed::has_attribute(attribname);
+		return feedptr->RssFeed::has_attribute_id(id);
 
 	return false;
 }
 
-std::string RssItem::get_attribute(const std::string& attribname)
+std::string RssItem::get_attribute_id(AttributeId id)
 {
-	if (attribname == "title")
+	switch (id) {
+	case AttributeId::TITLE:
 		return title();
-	else if (attribname == "link")
+	case AttributeId::LINK:
 		return link();
-	else if (attribname == "author")
+	case AttributeId::AUTHOR:
 		return author();
-	else if (attribname == "content")
+	case AttributeId::CONTENT:
 		return description();
-	else if (attribname == "date")
+	case AttributeId::DATE:
 		return pubDate();
-	else if (attribname == "guid")
+	case AttributeId::GUID:
 		return guid();
-	else if (attribname == "unread")
+	case AttributeId::UNREAD:
 		return unread_ ? "yes" : "no";
-	else if (attribname == "enclosure_url")
+	case AttributeId::ENCLOSURE_URL:
 		return enclosure_url();
-	else if (attribname == "enclosure_type")
+	case AttributeId::ENCLOSURE_TYPE:
 		return enclosure_type();
-	else if (attribname == "flags")
+	case AttributeId::FLAGS:
 		return flags();
-	else if (attribname == "age")
+	case AttributeId::AGE:
 		return std::to_string(
 			(time(nullptr) - pubDate_timestamp()) / 86400);
-	else if (attribname == "articleindex")
+	case AttributeId::ARTICLEINDEX:
 		return std::to_string(idx);
+	case AttributeId::UNKNOWN:
+		return "";
+	default:
+		break;
+	}
 
 	// if we have a feed, then forward the request
 	std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
 	if (feedptr)
-		return feedptr->RssFeed::get_attribute(attribname);
+		return feedptr->RssFeed::get_attribute_id(id);
 
 	return "";
 }
 
+bool RssItem::get_revision(unsigned long& revision)
+{
+	revision = revision_;
+	return true;
+}
+
+bool RssItem::get_numeric_attribute_id(AttributeId id, long& value)
+{
+	switch (id) {
+	case AttributeId::AGE:
+		value = (time(nullptr) - pubDate_timestamp()) / 86400;
+		return true;
+	case AttributeId::ARTICLEINDEX:
+		value = idx;
+		return true;
+	case AttributeId::UNREAD_COUNT:
+	case AttributeId::TOTAL_COUNT:
+	case AttributeId::FEEDINDEX: {
+		std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
+		if (feedptr)
+			return feedptr->RssFeed::get_numeric_attribute_id(
+				id, value);
+		return false;
+	}
+	default:
+		return false;
+	}
+}
+
+bool RssItem::attribute_contains(AttributeId id,
+	const std::string& token,
+	bool& contains)
+{
+	switch (id) {
+	case AttributeId::FLAGS:
+		// flags are letters only, so they form a single word
+		contains = !token.empty() && token == flags_;
+		return true;
+	case AttributeId::TAGS: {
+		std::shared_ptr<RssFeed> feedptr = feedptr_.lock();
+		if (feedptr)
+			return feedptr->RssFeed::attribute_contains(
+				id, token, contains);
+		return false;
+	}
+	default:
+		return false;
+	}
+}
+
 void RssItem::update_flags()
 {
 	if (ch) {
@@ -340,6 +499,9 @@ void RssItem::set_flags(const std::string& ff)
 	oldflags_ = flags_;
 	flags_ = ff;
 	sort_flags();
+	if (flags_ != oldflags_) {
+		touch();
+	}
 }
 
 void RssItem::sort_flags()
@@ -358,37 +520,84 @@ void RssItem::sort_flags()
 
 bool RssFeed::has_attribute(const std::string& attribname)
 {
-	if (attribname == "feedtitle" || attribname == "description" ||
-		attribname == "feedlink" || attribname == "feeddate" ||
-		attribname == "rssurl" || attribname == "unread_count" ||
-		attribname == "total_count" || attribname == "tags" ||
-		attribname == "feedindex")
-		return true;
-	return false;
+	return has_attribute_id(attribute_id(attribname));
 }
 
 std::string RssFeed::get_attribute(const std::string& attribname)
 {
-	if (attribname == "feedtitle")
+	return get_attribute_id(attribute_id(attribname));
+}
+
+bool RssFeed::has_attribute_id(AttributeId id)
+{
+	switch (id) {
+	case AttributeId::FEEDTITLE:
+	case AttributeId::DESCRIPTION:
+	case AttributeId::FEEDLINK:
+	case AttributeId::FEEDDATE:
+	case AttributeId::RSSURL:
+	case AttributeId::UNREAD_COUNT:
+	case AttributeId::TOTAL_COUNT:
+	case AttributeId::TAGS:
+	case AttributeId::FEEDINDEX:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::string RssFeed::get_attribute_id(AttributeId id)
+{
+	switch (id) {
+	case AttributeId::FEEDTITLE:
 		return title();
-	else if (attribname == "description")
+	case AttributeId::DESCRIPTION:
 		return description();
-	else if (attribname == "feedlink")
+	case AttributeId::FEEDLINK:
 		return title();
-	else if (attribname == "feeddate")
+	case AttributeId::FEEDDATE:
 		return pubDate();
-	else if (attribname == "rssurl")
+	case AttributeId::RSSURL:
 		return rssurl();
-	else if (attribname == "unread_count") {
+	case AttributeId::UNREAD_COUNT:
 		return std::to_string(unread_item_count());
-	} else if (attribname == "total_count") {
+	case AttributeId::TOTAL_COUNT:
 		return std::to_string(items_.size());
-	} else if (attribname == "tags") {
+	case AttributeId::TAGS:
 		return get_tags();
-	} else if (attribname == "feedindex") {
+	case AttributeId::FEEDINDEX:
 		return std::to_string(idx);
+	default:
+		return "";
 	}
-	return "";
+}
+
+bool RssFeed::get_numeric_attribute_id(AttributeId id, long& value)
+{
+	switch (id) {
+	case AttributeId::UNREAD_COUNT:
+		value = unread_item_count();
+		return true;
+	case AttributeId::TOTAL_COUNT:
+		value = items_.size();
+		return true;
+	case AttributeId::FEEDINDEX:
+		value = idx;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool RssFeed::attribute_contains(AttributeId id,
+	const std::string& token,
+	bool& contains)
+{
+	if (id != AttributeId::TAGS) {
+		return false;
+	}
+	contains = tag_words.count(token) > 0;
+	return true;
 }
 
 void RssIgnores::handle_action(const std::string& action,
@@ -406,15 +615,32 @@ void RssIgnores::handle_action(const std::string& action,
 				_("couldn't parse filter expression `%s': %s"),
 				ignore_expr,
 				m.get_parse_error()));
-		ignores.push_back(FeedUrlExprPair(
-			ignore_rssurl, new Matcher(ignore_expr)));
+		Matcher* rule = new Matcher(ignore_expr);
+		ignores.push_back(FeedUrlExprPair(ignore_rssurl, rule));
+		if (ignore_rssurl == "*") {
+			wildcard_ignores.push_back(rule);
+			for (auto& feed : feed_ignores) {
+				feed.second.push_back(rule);
+			}
+		} else {
+			// a feed's first rule comes after the wildcard ones
+			// defined so far
+			auto feed = feed_ignores.find(ignore_rssurl);
+			if (feed == feed_ignores.end()) {
+				feed = feed_ignores.emplace(
+					ignore_rssurl, wildcard_ignores).first;
+			}
+			feed->second.push_back(rule);
+		}
 	} else if (action == "always-download") {
 		for (const auto& param : params) {
 			ignores_lastmodified.push_back(param);
+			ignores_lastmodified_set.insert(param);
 		}
 	} else if (action == "reset-unread-on-update") {
 		for (const auto& param : params) {
 			resetflag.push_back(param);
+			resetflag_set.insert(param);
 		}
 	} else
 		throw ConfigHandlerException(
@@ -452,19 +678,27 @@ RssIgnores::~RssIgnores()
 
 bool RssIgnores::matches(RssItem* item)
 {
-	for (const auto& ign : ignores) {
-		LOG(Level::DEBUG,
-			"RssIgnores::matches: ign.first = `%s' item->feedurl "
-			"= "
-			"`%s'",
-			ign.first,
-			item->feedurl());
-		if (ign.first == "*" || item->feedurl() == ign.first) {
-			if (ign.second->matches(item)) {
-				LOG(Level::DEBUG,
-					"RssIgnores::matches: found match");
-				return true;
-			}
+	for (const auto& rule : rules_for(item->feedurl())) {
+		if (rule->matches(item)) {
+			LOG(Level::DEBUG, "RssIgnores::matches: found match");
+			return true;
+		}
+	}
+	return false;
+}
+
+const std::vector<Matcher*>& RssIgnores::rules_for(
+	const std::string& url) const
+{
+	const auto feed = feed_ignores.find(url);
+	return feed != feed_ignores.end() ? feed->second : wildcard_ignores;
+}
+
+bool RssIgnores::uses_attribute(const std::string& url, AttributeId id) const
+{
+	for (const auto& rule : rules_for(url)) {
+		if (rule->uses_attribute(id)) {
+			return true;
 		}
 	}
 	return false;
@@ -472,18 +706,49 @@ bool RssIgnores::matches(RssItem* item)
 
 bool RssIgnores::matches_lastmodified(const std::string& url)
 {
-	return std::find_if(ignores_lastmodified.begin(),
-		       ignores_lastmodified.end(),
-		       [&](const std::string& u) { return u == url; }) !=
-		ignores_lastmodified.end();
+	return ignores_lastmodified_set.count(url) > 0;
 }
 
 bool RssIgnores::matches_resetunread(const std::string& url)
 {
-	return std::find_if(resetflag.begin(),
-		       resetflag.end(),
-		       [&](const std::string& u) { return u == url; }) !=
-		resetflag.end();
+	return resetflag_set.count(url) > 0;
+}
+
+static bool article_less(const ArticleSortStrategy& sort_strategy,
+	const std::shared_ptr<RssItem>& a,
+	const std::shared_ptr<RssItem>& b)
+{
+	const bool desc = (sort_strategy.sd == SortDirection::DESC);
+	switch (sort_strategy.sm) {
+	case ArtSortMethod::TITLE: {
+		const int cmp = utils::strnaturalcmp(
+			a->title().c_str(), b->title().c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	}
+	case ArtSortMethod::FLAGS: {
+		const int cmp = strcmp(a->flags().c_str(), b->flags().c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	}
+	case ArtSortMethod::AUTHOR: {
+		const int cmp =
+			strcmp(a->author().c_str(), b->author().c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	}
+	case ArtSortMethod::LINK: {
+		const int cmp = strcmp(a->link().c_str(), b->link().c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	}
+	case ArtSortMethod::GUID: {
+		const int cmp = strcmp(a->guid().c_str(), b->guid().c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	}
+	case ArtSortMethod::DATE:
+		// date is descending by default
+		return sort_strategy.sd == SortDirection::ASC
+			? (a->pubDate_timestamp() > b->pubDate_timestamp())
+			: (a->pubDate_timestamp() < b->pubDate_timestamp());
+	}
+	return false;
 }
 
 void RssFeed::update_items(std::vector<std::shared_ptr<RssFeed>> feeds)
@@ -494,49 +759,147 @@ void RssFeed::update_items(std::vector<std::shared_ptr<RssFeed>> feeds)
 
 	LOG(Level::DEBUG, "RssFeed::update_items: query = `%s'", query);
 
-	struct timeval tv1, tv2, tvx;
+	struct timeval tv1, tv2;
 	gettimeofday(&tv1, nullptr);
 
-	Matcher m(query);
+	if (!query_matcher) {
+		query_matcher.reset(new Matcher(query));
+		query_sources.clear();
+	}
+
+	/* Age changes as time passes and indices change whenever a list is
+	 * redisplayed, neither of which shows up in the revisions, so queries
+	 * that use them have to look at every item every time. */
+	if (query_matcher->uses_attribute(AttributeId::AGE) ||
+		query_matcher->uses_attribute(AttributeId::ARTICLEINDEX) ||
+		query_matcher->uses_attribute(AttributeId::FEEDINDEX)) {
+		items_.clear();
+		items_guid_map.clear();
+		query_sources.clear();
+	}
 
-	items_.clear();
-	items_guid_map.clear();
+	/* Feed-wide counters change with any of the feed's items, so all of
+	 * the feed's items have to be matched again. */
+	const bool feed_wide =
+		query_matcher->uses_attribute(AttributeId::UNREAD_COUNT) ||
+		query_matcher->uses_attribute(AttributeId::TOTAL_COUNT);
+
+	std::unordered_map<const RssFeed*, QuerySource> sources;
+	// feeds whose items are all matched again
+	std::unordered_set<const RssFeed*> rescanned;
+	// items that are matched again
+	std::unordered_set<const RssItem*> rematched;
+	// items that have to be matched, and the feeds they belong to
+	std::vector<std::pair<std::shared_ptr<RssItem>, std::shared_ptr<RssFeed>>>
+		candidates;
+	std::vector<Matchable*> matchables;
 
 	for (const auto& feed : feeds) {
-		if (!feed->is_query_feed()) { // don't fetch items from other query feeds!
-			for (const auto& item : feed->items()) {
-				if (m.matches(item.get())) {
-					LOG(Level::DEBUG,
-						"RssFeed::update_items: "
-						"Matcher "
-						"matches!");
-					item->set_feedptr(feed);
-					items_.push_back(item);
-					items_guid_map[item->guid()] = item;
+		if (feed->is_query_feed()) {
+			// don't fetch items from other query feeds!
+			continue;
+		}
+
+		const unsigned long revision = feed->revision();
+		sources[feed.get()] = QuerySource{feed, revision};
+
+		const auto source = query_sources.find(feed.get());
+		const bool known = source != query_sources.end() &&
+			source->second.feed.lock() == feed;
+		if (known && source->second.revision == revision) {
+			continue;
+		}
+
+		const bool rescan = !known || feed_wide ||
+			feed->items_revision() > source->second.revision;
+		if (rescan) {
+			rescanned.insert(feed.get());
+		}
+
+		for (const auto& item : feed->items()) {
+			if (!rescan) {
+				if (item->revision() <= source->second.revision) {
+					continue;
 				}
+				rematched.insert(item.get());
 			}
+			candidates.emplace_back(item, feed);
+			matchables.push_back(item.get());
 		}
 	}
 
-	gettimeofday(&tvx, nullptr);
+	const std::vector<bool> results = query_matcher->matches_all(matchables);
+	std::vector<std::shared_ptr<RssItem>> matched;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (results[i]) {
+			candidates[i].first->set_feedptr(candidates[i].second);
+			matched.push_back(candidates[i].first);
+		}
+	}
 
-	std::sort(items_.begin(), items_.end());
+	/* Drop items that were matched again, and those of feeds that are gone
+	 * or were rescanned. The rest keeps its place. */
+	bool dropped_feeds = false;
+	for (const auto& source : query_sources) {
+		if (sources.find(source.first) == sources.end()) {
+			dropped_feeds = true;
+			break;
+		}
+	}
+	if (dropped_feeds || !rescanned.empty() || !rematched.empty()) {
+		const auto is_stale = [&](const std::shared_ptr<RssItem>& item) {
+			if (rematched.count(item.get()) > 0) {
+				return true;
+			}
+			const auto feed = item->get_feedptr();
+			return !feed || sources.count(feed.get()) == 0 ||
+				rescanned.count(feed.get()) > 0;
+		};
+		for (const auto& item : items_) {
+			if (is_stale(item)) {
+				const auto it = items_guid_map.find(item->guid());
+				if (it != items_guid_map.end() && it->second == item) {
+					items_guid_map.erase(it);
+				}
+			}
+		}
+		items_.erase(std::remove_if(items_.begin(), items_.end(), is_stale),
+			items_.end());
+	}
+
+	for (const auto& item : matched) {
+		items_guid_map[item->guid()] = item;
+	}
+	if (items_sorted) {
+		const auto less = [&](const std::shared_ptr<RssItem>& a,
+					  const std::shared_ptr<RssItem>& b) {
+			return article_less(items_sort_strategy, a, b);
+		};
+		std::stable_sort(matched.begin(), matched.end(), less);
+		std::vector<std::shared_ptr<RssItem>> merged;
+		merged.reserve(items_.size() + matched.size());
+		std::merge(items_.begin(),
+			items_.end(),
+			matched.begin(),
+			matched.end(),
+			std::back_inserter(merged),
+			less);
+		items_.swap(merged);
+	} else {
+		items_.insert(items_.end(), matched.begin(), matched.end());
+	}
+
+	query_sources.swap(sources);
 
 	gettimeofday(&tv2, nullptr);
 	unsigned long diff =
 		(((tv2.tv_sec - tv1.tv_sec) * 1000000) + tv2.tv_usec) -
 		tv1.tv_usec;
-	unsigned long diffx =
-		(((tv2.tv_sec - tvx.tv_sec) * 1000000) + tv2.tv_usec) -
-		tvx.tv_usec;
 	LOG(Level::DEBUG,
-		"RssFeed::update_items matching took %lu.%06lu s",
+		"RssFeed::update_items matched %u items in %lu.%06lu s",
+		candidates.size(),
 		diff / 1000000,
 		diff % 1000000);
-	LOG(Level::DEBUG,
-		"RssFeed::update_items sorting took %lu.%06lu s",
-		diffx / 1000000,
-		diffx % 1000000);
 }
 
 void RssFeed::set_rssurl(const std::string& u)
@@ -584,91 +947,83 @@ void RssFeed::set_rssurl(const std::string& u)
 void RssFeed::sort(const ArticleSortStrategy& sort_strategy)
 {
 	std::lock_guard<std::mutex> lock(item_mutex);
+	// query feeds keep their items in order while updating them
+	if (is_query_feed() && items_sorted &&
+		items_sort_strategy == sort_strategy) {
+		return;
+	}
 	sort_unlocked(sort_strategy);
 }
 
 void RssFeed::sort_unlocked(const ArticleSortStrategy& sort_strategy)
 {
+	/* The same order as article_less() gives, but every item's title or
+	 * author is converted only once rather than in every comparison. */
+	const bool desc = (sort_strategy.sd == SortDirection::DESC);
+	const auto string_less = [desc](const std::string& a,
+		const std::string& b) {
+		const int cmp = strcmp(a.c_str(), b.c_str());
+		return desc ? (cmp > 0) : (cmp < 0);
+	};
+	const auto pointee_less = [&](const std::string* a,
+		const std::string* b) {
+		return string_less(*a, *b);
+	};
+
 	switch (sort_strategy.sm) {
 	case ArtSortMethod::TITLE:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
-				return sort_strategy.sd ==
-						SortDirection::DESC
-					? (utils::strnaturalcmp(a->title().c_str(),
-						   b->title().c_str()) > 0)
-					: (utils::strnaturalcmp(a->title().c_str(),
-						   b->title().c_str()) < 0);
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return item->title();
+			},
+			[desc](const std::string& a, const std::string& b) {
+				const int cmp = utils::strnaturalcmp(a, b);
+				return desc ? (cmp > 0) : (cmp < 0);
 			});
 		break;
 	case ArtSortMethod::FLAGS:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
-				return sort_strategy.sd ==
-						SortDirection::DESC
-					? (strcmp(a->flags().c_str(),
-						   b->flags().c_str()) > 0)
-					: (strcmp(a->flags().c_str(),
-						   b->flags().c_str()) < 0);
-			});
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return &item->flags();
+			},
+			pointee_less);
 		break;
 	case ArtSortMethod::AUTHOR:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
-				return sort_strategy.sd ==
-						SortDirection::DESC
-					? (strcmp(a->author().c_str(),
-						   b->author().c_str()) > 0)
-					: (strcmp(a->author().c_str(),
-						   b->author().c_str()) < 0);
-			});
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return item->author();
+			},
+			string_less);
 		break;
 	case ArtSortMethod::LINK:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
-				return sort_strategy.sd ==
-						SortDirection::DESC
-					? (strcmp(a->link().c_str(),
-						   b->link().c_str()) > 0)
-					: (strcmp(a->link().c_str(),
-						   b->link().c_str()) < 0);
-			});
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return &item->link();
+			},
+			pointee_less);
 		break;
 	case ArtSortMethod::GUID:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
-				return sort_strategy.sd ==
-						SortDirection::DESC
-					? (strcmp(a->guid().c_str(),
-						   b->guid().c_str()) > 0)
-					: (strcmp(a->guid().c_str(),
-						   b->guid().c_str()) < 0);
-			});
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return &item->guid();
+			},
+			pointee_less);
 		break;
 	case ArtSortMethod::DATE:
-		std::stable_sort(items_.begin(),
-			items_.end(),
-			[&](std::shared_ptr<RssItem> a,
-				std::shared_ptr<RssItem> b) {
+		keyed_stable_sort(items_,
+			[](const std::shared_ptr<RssItem>& item) {
+				return item->pubDate_timestamp();
+			},
+			[&](time_t a, time_t b) {
 				// date is descending by default
 				return sort_strategy.sd == SortDirection::ASC
-					? (a->pubDate_timestamp() >
-						  b->pubDate_timestamp())
-					: (a->pubDate_timestamp() <
-						  b->pubDate_timestamp());
+					? (a > b)
+					: (a < b);
 			});
 		break;
 	}
+	items_sorted = true;
+	items_sort_strategy = sort_strategy;
 }
 
 void RssFeed::remove_old_deleted_items()
@@ -681,6 +1036,26 @@ void RssFeed::remove_old_deleted_items()
 	ch->remove_old_deleted_items(rssurl_, guids);
 }
 
+std::vector<std::shared_ptr<RssItem>> RssFeed::search_items(
+	const std::string& query)
+{
+	std::unordered_set<std::string> guids;
+	for (const auto& item : items_) {
+		if (!item->deleted()) {
+			guids.insert(item->guid());
+		}
+	}
+	guids = ch->search_in_items(query, guids);
+
+	std::vector<std::shared_ptr<RssItem>> result;
+	for (const auto& item : items_) {
+		if (guids.find(item->guid()) != guids.end()) {
+			result.push_back(item);
+		}
+	}
+	return result;
+}
+
 void RssFeed::purge_deleted_items()
 {
 	std::lock_guard<std::mutex> lock(item_mutex);
@@ -696,12 +1071,16 @@ void RssFeed::purge_deleted_items()
 		}
 	}
 
+	const auto old_size = items_.size();
 	items_.erase(std::remove_if(items_.begin(),
 			     items_.end(),
 			     [](const std::shared_ptr<RssItem> item) {
 				     return item->deleted();
 			     }),
 		items_.end());
+	if (items_.size() != old_size) {
+		items_changed();
+	}
 }
 
 void RssFeed::set_feedptrs(std::shared_ptr<RssFeed> self)
@@ -5,17 +5,19 @@
 #include <cstring>
 #include <curl/curl.h>
 #include <sstream>
+#include <utility>
 
 #include "cache.h"
 #include "config.h"
 #include "configcontainer.h"
+#include "dateparser.h"
 #include "htmlrenderer.h"
 #include "logger.h"
 #include "newsblurapi.h"
 #include "ocnewsapi.h"
+#include "processpool.h"
 #include "rss.h"
 #include "rsspp.h"
-#include "rssppinternal.h"
 #include "strprintf.h"
 #include "ttrssapi.h"
 #include "utils.h"
@@ -75,21 +77,12 @@ std::shared_ptr<RssFeed> RssParser::parse()
 
 time_t RssParser::parse_date(const std::string& datestr)
 {
-	time_t t = curl_getdate(datestr.c_str(), nullptr);
+	time_t t = rsspp::parse_date(datestr);
 	if (t == -1) {
 		LOG(Level::INFO,
-			"RssParser::parse_date: encountered t == -1, trying "
-			"out "
-			"W3CDTF parser...");
-		t = curl_getdate(
-			rsspp::RssParser::__w3cdtf_to_rfc822(datestr).c_str(),
-			nullptr);
-	}
-	if (t == -1) {
-		LOG(Level::INFO,
-			"RssParser::parse_date: still t == -1, setting to "
-			"current "
-			"time");
+			"RssParser::parse_date: couldn't parse `%s', setting "
+			"to current time",
+			datestr);
 		t = ::time(nullptr);
 	}
 	return t;
@@ -253,8 +246,28 @@ void RssParser::download_http(const std::string& uri)
 
 void RssParser::get_execplugin(const std::string& plugin)
 {
-	std::string buf = utils::get_command_output(plugin);
+	const ProcessResult process = ProcessPool::getInstance().run_shell(plugin);
+	if (process.timed_out) {
+		throw strprintf::fmt(_("`%s' didn't finish in time"), plugin);
+	}
+	const std::string& buf = process.output;
 	is_valid = false;
+
+	/*
+	 * exec: URLs have no Last-Modified or ETag, so we fingerprint the
+	 * script's output instead; if it didn't change since the last reload,
+	 * there's nothing to parse or store.
+	 */
+	const std::string hash = utils::content_digest(buf);
+	if (!is_content_changed(hash)) {
+		LOG(Level::DEBUG,
+			"RssParser::get_execplugin: output of %s didn't change, "
+			"skipping",
+			plugin);
+		skip_parsing = true;
+		return;
+	}
+
 	try {
 		rsspp::Parser p;
 		f = p.parse_buffer(buf);
@@ -263,6 +276,7 @@ void RssParser::get_execplugin(const std::string& plugin)
 		is_valid = false;
 		throw;
 	}
+	ch->update_content_hash(my_uri, hash);
 	LOG(Level::DEBUG,
 		"RssParser::parse: execplugin %s, is_valid = %s",
 		plugin,
@@ -289,18 +303,99 @@ void RssParser::parse_file(const std::string& file)
 void RssParser::download_filterplugin(const std::string& filter,
 	const std::string& uri)
 {
-	std::string buf = utils::retrieve_url(uri, cfgcont);
+	is_valid = false;
+
+	std::string proxy;
+	std::string proxy_auth;
+	std::string proxy_type;
+	if (cfgcont->get_configvalue_as_bool("use-proxy") == true) {
+		proxy = cfgcont->get_configvalue("proxy");
+		proxy_auth = cfgcont->get_configvalue("proxy-auth");
+		proxy_type = cfgcont->get_configvalue("proxy-type");
+	}
+
+	rsspp::Parser p(cfgcont->get_configvalue_as_int("download-timeout"),
+		utils::get_useragent(cfgcont),
+		proxy,
+		proxy_auth,
+		utils::get_proxy_type(proxy_type),
+		cfgcont->get_configvalue_as_bool("ssl-verifypeer"));
+
+	/*
+	 * Last-Modified and ETag of the input are stored under the filter: URL
+	 * itself, since that's the key of the feed in the cache.
+	 */
+	time_t lm = 0;
+	std::string etag;
+	const bool conditional = !ign || !ign->matches_lastmodified(my_uri);
+	if (conditional) {
+		ch->fetch_lastmodified(my_uri, lm, etag);
+	}
+	std::string buf = p.fetch_url(uri,
+		lm,
+		etag,
+		nullptr,
+		cfgcont->get_configvalue("cookie-cache"),
+		easyhandle ? easyhandle->ptr() : nullptr);
+	if (p.get_last_modified() != 0 || p.get_etag().length() > 0) {
+		ch->update_lastmodified(my_uri,
+			(p.get_last_modified() != lm) ? p.get_last_modified()
+						      : 0,
+			(etag != p.get_etag()) ? p.get_etag() : "");
+	}
+	if (buf.empty() && (lm != 0 || !etag.empty())) {
+		LOG(Level::DEBUG,
+			"RssParser::download_filterplugin: %s not modified, "
+			"skipping",
+			uri);
+		skip_parsing = true;
+		return;
+	}
+
+	/*
+	 * The stored fingerprint is "<input hash>:<output hash>". Unchanged
+	 * input means we don't even have to run the filter; unchanged output
+	 * means there's nothing new to parse.
+	 */
+	std::string old_hash;
+	ch->fetch_content_hash(my_uri, old_hash);
+	const std::string::size_type sep = old_hash.find(':');
+	const std::string old_input_hash = old_hash.substr(0, sep);
+	const std::string old_output_hash =
+		(sep == std::string::npos) ? "" : old_hash.substr(sep + 1);
+
+	const std::string input_hash = utils::content_digest(buf);
+	if (conditional && input_hash == old_input_hash) {
+		LOG(Level::DEBUG,
+			"RssParser::download_filterplugin: input of %s didn't "
+			"change, skipping",
+			filter);
+		skip_parsing = true;
+		return;
+	}
 
-	char* argv[4] = {const_cast<char*>("/bin/sh"),
-		const_cast<char*>("-c"),
-		const_cast<char*>(filter.c_str()),
-		nullptr};
-	std::string result = utils::run_program(argv, buf);
+	const ProcessResult process =
+		ProcessPool::getInstance().run_shell(filter, buf);
+	if (process.timed_out) {
+		throw strprintf::fmt(_("`%s' didn't finish in time"), filter);
+	}
+	const std::string& result = process.output;
 	LOG(Level::DEBUG,
 		"RssParser::parse: output of `%s' is: %s",
 		filter,
 		result);
-	is_valid = false;
+
+	const std::string output_hash = utils::content_digest(result);
+	if (conditional && output_hash == old_output_hash) {
+		LOG(Level::DEBUG,
+			"RssParser::download_filterplugin: output of %s didn't "
+			"change, skipping",
+			filter);
+		ch->update_content_hash(my_uri, input_hash + ":" + output_hash);
+		skip_parsing = true;
+		return;
+	}
+
 	try {
 		rsspp::Parser p;
 		f = p.parse_buffer(result);
@@ -309,12 +404,24 @@ void RssParser::download_filterplugin(const std::string& filter,
 		is_valid = false;
 		throw;
 	}
+	ch->update_content_hash(my_uri, input_hash + ":" + output_hash);
 	LOG(Level::DEBUG,
 		"RssParser::parse: filterplugin %s, is_valid = %s",
 		filter,
 		is_valid ? "true" : "false");
 }
 
+bool RssParser::is_content_changed(const std::string& hash)
+{
+	if (ign && ign->matches_lastmodified(my_uri)) {
+		return true;
+	}
+
+	std::string old_hash;
+	ch->fetch_content_hash(my_uri, old_hash);
+	return hash != old_hash;
+}
+
 void RssParser::fill_feed_fields(std::shared_ptr<RssFeed> feed)
 {
 	/*
@@ -327,7 +434,7 @@ void RssParser::fill_feed_fields(std::shared_ptr<RssFeed> feed)
 		feed->set_title(f.title);
 	}
 
-	feed->set_description(f.description);
+	feed->set_description(std::move(f.description));
 
 	feed->set_link(utils::absolute_url(my_uri, f.link));
 
@@ -346,14 +453,29 @@ void RssParser::fill_feed_fields(std::shared_ptr<RssFeed> feed)
 
 void RssParser::fill_feed_items(std::shared_ptr<RssFeed> feed)
 {
+	ScopeMeasure m1("RssParser::fill_feed_items");
+
 	/*
 	 * we iterate over all items of a feed, create an RssItem object for
 	 * each item, and fill it with the appropriate values from the data
-	 * structure.
+	 * structure. Strings are moved out of the rsspp::Item wherever
+	 * possible, so large descriptions aren't copied yet again; that's why
+	 * the GUID has to be worked out before the title is taken away.
 	 */
-	for (const auto& item : f.items) {
+	/* Unless the ignore rules look at the content or the enclosure, items
+	 * are checked before those are filled in, so that ignored ones don't
+	 * have their content copied (or their full page downloaded). */
+	const std::string& url = feed->rssurl();
+	const bool ignore_early = ign &&
+		!ign->uses_attribute(url, AttributeId::CONTENT) &&
+		!ign->uses_attribute(url, AttributeId::ENCLOSURE_URL) &&
+		!ign->uses_attribute(url, AttributeId::ENCLOSURE_TYPE);
+
+	for (auto& item : f.items) {
 		std::shared_ptr<RssItem> x(new RssItem(ch));
 
+		x->set_guid(get_guid(item));
+
 		set_item_title(feed, x, item);
 
 		if (item.link != "") {
@@ -420,16 +542,20 @@ void RssParser::fill_feed_items(std::shared_ptr<RssFeed> feed)
 			}
 		}
 
-		set_item_content(x, item);
-
-		if (item.pubDate != "")
+		if (item.pubDate_ts != 0)
+			x->set_pubDate(item.pubDate_ts);
+		else if (item.pubDate != "")
 			x->set_pubDate(parse_date(item.pubDate));
 		else
 			x->set_pubDate(::time(nullptr));
 
-		x->set_guid(get_guid(item));
+		x->set_base(std::move(item.base));
 
-		x->set_base(item.base);
+		if (ignore_early && is_ignored(x)) {
+			continue;
+		}
+
+		set_item_content(x, item);
 
 		set_item_enclosure(x, item);
 
@@ -437,23 +563,25 @@ void RssParser::fill_feed_items(std::shared_ptr<RssFeed> feed)
 			"RssParser::parse: item title = `%s' link = `%s' "
 			"pubDate "
 			"= `%s' (%d) description = `%s'",
-			x->title(),
+			x->title_raw(),
 			x->link(),
 			x->pubDate(),
 			x->pubDate_timestamp(),
-			x->description());
+			x->description_raw());
 
-		add_item_to_feed(feed, x);
+		if (ignore_early || !ign || !is_ignored(x)) {
+			add_item_to_feed(feed, x);
+		}
 	}
 }
 
 void RssParser::set_item_title(std::shared_ptr<RssFeed> feed,
 	std::shared_ptr<RssItem> x,
-	const rsspp::Item& item)
+	rsspp::Item& item)
 {
-	std::string title = item.title;
+	std::string title = std::move(item.title);
 
-	if (item.title.empty()) {
+	if (title.empty()) {
 		title = utils::make_title(item.link);
 	}
 
@@ -461,12 +589,12 @@ void RssParser::set_item_title(std::shared_ptr<RssFeed> feed,
 		x->set_title(render_xhtml_title(title, feed->link()));
 	} else {
 		replace_newline_characters(title);
-		x->set_title(title);
+		x->set_title(std::move(title));
 	}
 }
 
 void RssParser::set_item_author(std::shared_ptr<RssItem> x,
-	const rsspp::Item& item)
+	rsspp::Item& item)
 {
 	/*
 	 * some feeds only have a feed-wide managingEditor, which we use as an
@@ -479,30 +607,30 @@ void RssParser::set_item_author(std::shared_ptr<RssItem> x,
 			x->set_author(f.dc_creator);
 		}
 	} else {
-		x->set_author(item.author);
+		x->set_author(std::move(item.author));
 	}
 }
 
 void RssParser::set_item_content(std::shared_ptr<RssItem> x,
-	const rsspp::Item& item)
+	rsspp::Item& item)
 {
 	handle_content_encoded(x, item);
 
 	handle_itunes_summary(x, item);
 
-	if (x->description() == "") {
-		x->set_description(item.description);
+	if (x->description_raw().empty()) {
+		x->set_description(std::move(item.description));
 	} else {
 		if (cfgcont->get_configvalue_as_bool(
 			    "always-display-description") &&
 			item.description != "")
-			x->set_description(
-				x->description() + "<hr>" + item.description);
+			x->set_description(x->description_raw() + "<hr>" +
+				item.description);
 	}
 
 	/* if it's still empty and we shall download the full page, then we do
 	 * so. */
-	if (x->description() == "" &&
+	if (x->description_raw().empty() &&
 		cfgcont->get_configvalue_as_bool("download-full-page") &&
 		x->link() != "") {
 		x->set_description(utils::retrieve_url(x->link(), cfgcont));
@@ -510,7 +638,7 @@ void RssParser::set_item_content(std::shared_ptr<RssItem> x,
 
 	LOG(Level::DEBUG,
 		"RssParser::set_item_content: content = %s",
-		x->description());
+		x->description_raw());
 }
 
 std::string RssParser::get_guid(const rsspp::Item& item) const
@@ -535,52 +663,52 @@ std::string RssParser::get_guid(const rsspp::Item& item) const
 }
 
 void RssParser::set_item_enclosure(std::shared_ptr<RssItem> x,
-	const rsspp::Item& item)
+	rsspp::Item& item)
 {
-	x->set_enclosure_url(item.enclosure_url);
-	x->set_enclosure_type(item.enclosure_type);
 	LOG(Level::DEBUG,
 		"RssParser::parse: found enclosure_url: %s",
 		item.enclosure_url);
 	LOG(Level::DEBUG,
 		"RssParser::parse: found enclosure_type: %s",
 		item.enclosure_type);
+	x->set_enclosure_url(std::move(item.enclosure_url));
+	x->set_enclosure_type(std::move(item.enclosure_type));
+}
+
+bool RssParser::is_ignored(std::shared_ptr<RssItem> item)
+{
+	if (!ign->matches(item.get())) {
+		return false;
+	}
+	LOG(Level::INFO,
+		"RssParser::parse: ignored article title = `%s' link = `%s'",
+		item->title(),
+		item->link());
+	return true;
 }
 
 void RssParser::add_item_to_feed(std::shared_ptr<RssFeed> feed,
 	std::shared_ptr<RssItem> item)
 {
-	// only add item to feed if it isn't on the ignore list or if there is
-	// no ignore list
-	if (!ign || !ign->matches(item.get())) {
-		feed->add_item(item);
-		LOG(Level::INFO,
-			"RssParser::parse: added article title = `%s' link = "
-			"`%s' "
-			"ign = %p",
-			item->title(),
-			item->link(),
-			ign);
-	} else {
-		LOG(Level::INFO,
-			"RssParser::parse: ignored article title = `%s' link "
-			"= "
-			"`%s'",
-			item->title(),
-			item->link());
-	}
+	feed->add_item(item);
+	LOG(Level::INFO,
+		"RssParser::parse: added article title = `%s' link = `%s' "
+		"ign = %p",
+		item->title(),
+		item->link(),
+		ign);
 }
 
 void RssParser::handle_content_encoded(std::shared_ptr<RssItem> x,
-	const rsspp::Item& item) const
+	rsspp::Item& item) const
 {
-	if (x->description() != "")
+	if (!x->description_raw().empty())
 		return;
 
 	/* here we handle content:encoded tags that are an extension but very
 	 * widespread */
 	if (item.content_encoded != "") {
-		x->set_description(item.content_encoded);
+		x->set_description(std::move(item.content_encoded));
 	} else {
 		LOG(Level::DEBUG,
 			"RssParser::parse: found no content:encoded");
@@ -588,17 +716,17 @@ void RssParser::handle_content_encoded(std::shared_ptr<RssItem> x,
 }
 
 void RssParser::handle_itunes_summary(std::shared_ptr<RssItem> x,
-	const rsspp::Item& item)
+	rsspp::Item& item)
 {
-	if (x->description() != "")
+	if (!x->description_raw().empty())
 		return;
 
-	std::string summary = item.itunes_summary;
+	const std::string& summary = item.itunes_summary;
 	if (summary != "") {
 		std::string desc = "<ituneshack>";
 		desc.append(summary);
 		desc.append("</ituneshack>");
-		x->set_description(desc);
+		x->set_description(std::move(desc));
 	}
 }
 
@@ -0,0 +1,145 @@
+#include "searchresultloader.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include "logger.h"
+#include "rss.h"
+
+namespace newsboat {
+
+SearchResultLoader::SearchResultLoader(Fetch fetch,
+	unsigned int max_items,
+	unsigned int first_page_size,
+	unsigned int page_size)
+	: fetch(std::move(fetch))
+	, max_items(max_items)
+	, first_page_size(std::max(first_page_size, 1u))
+	, page_size(std::max(page_size, 1u))
+	, total(0)
+	, is_running(false)
+	, is_cancelled(false)
+{
+}
+
+SearchResultLoader::~SearchResultLoader()
+{
+	cancel();
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+std::vector<std::shared_ptr<RssItem>> SearchResultLoader::start()
+{
+	std::vector<std::shared_ptr<RssItem>> items =
+		fetch(position, next_page_size(first_page_size));
+
+	std::lock_guard<std::mutex> lock(mtx);
+	total = items.size();
+	if (!position.done && next_page_size(page_size) > 0) {
+		is_running = true;
+		worker = std::thread(&SearchResultLoader::run, this);
+	}
+	return items;
+}
+
+void SearchResultLoader::take(std::vector<std::shared_ptr<RssItem>>& items)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::move(found.begin(), found.end(), std::back_inserter(items));
+	found.clear();
+}
+
+void SearchResultLoader::cancel()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	if (is_running) {
+		LOG(Level::DEBUG,
+			"SearchResultLoader::cancel: cancelled after %u results",
+			total);
+		is_cancelled = true;
+	}
+}
+
+bool SearchResultLoader::running() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return is_running;
+}
+
+unsigned int SearchResultLoader::count() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return total;
+}
+
+bool SearchResultLoader::truncated() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return max_items > 0 && total >= max_items && !position.done;
+}
+
+bool SearchResultLoader::cancelled() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return is_cancelled;
+}
+
+std::string SearchResultLoader::error() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return error_message;
+}
+
+unsigned int SearchResultLoader::next_page_size(unsigned int page) const
+{
+	if (max_items == 0) {
+		return page;
+	}
+	return total < max_items ? std::min(page, max_items - total) : 0;
+}
+
+void SearchResultLoader::run()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	while (!is_cancelled && !position.done) {
+		const unsigned int limit = next_page_size(page_size);
+		if (limit == 0) {
+			LOG(Level::INFO,
+				"SearchResultLoader::run: stopping at %u results",
+				total);
+			break;
+		}
+
+		SearchPosition next = position;
+		lock.unlock();
+		std::vector<std::shared_ptr<RssItem>> items;
+		std::string failure;
+		try {
+			items = fetch(next, limit);
+		} catch (const std::exception& e) {
+			failure = e.what();
+		}
+		lock.lock();
+
+		if (!failure.empty()) {
+			LOG(Level::ERROR,
+				"SearchResultLoader::run: search failed: %s",
+				failure);
+			error_message = failure;
+			break;
+		}
+		if (is_cancelled) {
+			break;
+		}
+		position = next;
+		total += items.size();
+		std::move(items.begin(), items.end(), std::back_inserter(found));
+	}
+	is_running = false;
+}
+
+} // namespace newsboat
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <istream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -21,7 +23,10 @@ namespace newsboat {
  */
 
 TagSoupPullParser::TagSoupPullParser()
-	: inputstream(0)
+	: input(nullptr)
+	, input_size(0)
+	, input_pos(0)
+	, eof(true)
 	, current_event(Event::START_DOCUMENT)
 	, c('\0')
 {
@@ -31,7 +36,17 @@ TagSoupPullParser::~TagSoupPullParser() {}
 
 void TagSoupPullParser::set_input(std::istream& is)
 {
-	inputstream = &is;
+	buffer.assign(std::istreambuf_iterator<char>(is),
+		std::istreambuf_iterator<char>());
+	set_input(buffer);
+}
+
+void TagSoupPullParser::set_input(const std::string& s)
+{
+	input = s.data();
+	input_size = s.size();
+	input_pos = 0;
+	eof = false;
 	current_event = Event::START_DOCUMENT;
 }
 
@@ -51,7 +66,7 @@ TagSoupPullParser::Event TagSoupPullParser::get_event_type() const
 	return current_event;
 }
 
-std::string TagSoupPullParser::get_text() const
+const std::string& TagSoupPullParser::get_text() const
 {
 	return text;
 }
@@ -64,9 +79,9 @@ TagSoupPullParser::Event TagSoupPullParser::next()
 	 * event.
 	 */
 	attributes.clear();
-	text = "";
+	text.clear();
 
-	if (inputstream->eof()) {
+	if (eof) {
 		current_event = Event::END_DOCUMENT;
 	}
 
@@ -75,7 +90,7 @@ TagSoupPullParser::Event TagSoupPullParser::next()
 	case Event::START_TAG:
 	case Event::END_TAG:
 		skip_whitespace();
-		if (inputstream->eof()) {
+		if (eof) {
 			current_event = Event::END_DOCUMENT;
 		} else if (c != '<') {
 			handle_text();
@@ -95,16 +110,16 @@ TagSoupPullParser::Event TagSoupPullParser::next()
 void TagSoupPullParser::skip_whitespace()
 {
 	c = '\0';
-	ws = "";
-	do {
-		inputstream->read(&c, 1);
-		if (!inputstream->eof()) {
-			if (!isspace(c))
-				break;
-			else
-				ws.append(1, c);
-		}
-	} while (!inputstream->eof());
+	const size_t start = input_pos;
+	while (input_pos < input_size && isspace(input[input_pos])) {
+		input_pos++;
+	}
+	ws.assign(input + start, input_pos - start);
+	if (input_pos < input_size) {
+		c = input[input_pos++];
+	} else {
+		eof = true;
+	}
 }
 
 void TagSoupPullParser::add_attribute(std::string s)
@@ -133,15 +148,16 @@ void TagSoupPullParser::add_attribute(std::string s)
 
 std::string TagSoupPullParser::read_tag()
 {
-	std::string s;
-	getline(*inputstream, s, '>');
-	if (inputstream->eof()) {
-		throw XmlException(
-			_("EOF found while reading XML tag")); // TODO: test
-							       // whether this
-							       // works reliably
+	const char* start = input + input_pos;
+	const char* end = static_cast<const char*>(
+		memchr(start, '>', input_size - input_pos));
+	if (end == nullptr) {
+		input_pos = input_size;
+		eof = true;
+		throw XmlException(_("EOF found while reading XML tag"));
 	}
-	return s;
+	input_pos += end - start + 1;
+	return std::string(start, end);
 }
 
 TagSoupPullParser::Event TagSoupPullParser::determine_tag_type()
@@ -168,15 +184,38 @@ std::string TagSoupPullParser::decode_attribute(const std::string& s)
 
 std::string TagSoupPullParser::decode_entities(const std::string& s)
 {
+	if (s.find('&') == std::string::npos) {
+		return s;
+	}
+
+	// Splits the string the way std::getline() would: once the end is
+	// reached, further calls leave `tmp` alone, so an '&' without a ';'
+	// drops the ampersand but keeps the text after it.
 	std::string result;
-	std::istringstream sbuf(s);
 	std::string tmp;
-	getline(sbuf, tmp, '&');
-	while (!sbuf.eof()) {
+	size_t pos = 0;
+	bool at_end = false;
+	const auto read_until = [&](char delim) {
+		if (at_end) {
+			return;
+		}
+		const size_t found = s.find(delim, pos);
+		if (found == std::string::npos) {
+			tmp.assign(s, pos, std::string::npos);
+			pos = s.size();
+			at_end = true;
+		} else {
+			tmp.assign(s, pos, found - pos);
+			pos = found + 1;
+		}
+	};
+
+	read_until('&');
+	while (!at_end) {
 		result.append(tmp);
-		getline(sbuf, tmp, ';');
+		read_until(';');
 		result.append(decode_entity(tmp));
-		getline(sbuf, tmp, '&');
+		read_until('&');
 	}
 	result.append(tmp);
 	return result;
@@ -614,9 +653,17 @@ void TagSoupPullParser::handle_text()
 	if (current_event != Event::START_DOCUMENT)
 		text.append(ws);
 	text.append(1, c);
-	std::string tmp;
-	getline(*inputstream, tmp, '<');
-	text.append(tmp);
+	const char* start = input + input_pos;
+	const char* end = static_cast<const char*>(
+		memchr(start, '<', input_size - input_pos));
+	if (end == nullptr) {
+		text.append(start, input_size - input_pos);
+		input_pos = input_size;
+		eof = true;
+	} else {
+		text.append(start, end);
+		input_pos += end - start + 1;
+	}
 	text = decode_entities(text);
 	utils::remove_soft_hyphens(text);
 	current_event = Event::TEXT;
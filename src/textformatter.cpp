@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cstdint>
 #include <limits.h>
 
 #include "htmlrenderer.h"
@@ -22,8 +23,7 @@ void TextFormatter::add_line(LineType type, std::string line)
 		line,
 		static_cast<unsigned int>(type));
 
-	auto clean_line = utils::wstr2str(
-		utils::clean_nonprintable_characters(utils::str2wstr(line)));
+	const auto clean_line = utils::clean_nonprintable_characters(line);
 	lines.push_back(std::make_pair(type, clean_line));
 }
 
@@ -55,45 +55,56 @@ std::vector<std::string> wrap_line(const std::string& line, const size_t width)
 			});
 	};
 	if (iswhitespace(words[0])) {
-		prefix = utils::substr_with_width(words[0], width);
-		prefix_width = utils::strwidth_stfl(prefix);
+		prefix = words[0].substr(
+			0, utils::fit_width(words[0], 0, width, prefix_width));
 		words.erase(words.cbegin());
 	}
 
+	// Widths are measured once per word and then kept up to date, and
+	// long words are split by walking through them, so that a line is
+	// wrapped in time proportional to its length.
 	std::string curline = prefix;
+	size_t curline_width = prefix_width;
 
 	for (auto& word : words) {
-		size_t word_width = utils::strwidth_stfl(word);
-		size_t curline_width = utils::strwidth_stfl(curline);
+		size_t word_width = 0;
+		utils::fit_width(word, 0, SIZE_MAX, word_width);
+		size_t pos = 0;
 
 		// for languages (e.g., CJK) don't use a space as a word
 		// boundary
 		while (word_width > (width - prefix_width)) {
-			size_t space_left = width - curline_width;
-			std::string part =
-				utils::substr_with_width(word, space_left);
-			curline.append(part);
-			word.erase(0, part.length());
+			size_t part_width = 0;
+			const size_t space_left = width - curline_width;
+			const size_t part = utils::fit_width(
+					word, pos, space_left, part_width);
+			curline.append(word, pos, part);
 			result.push_back(curline);
 			curline = prefix;
-			if (part.empty()) {
+			curline_width = prefix_width;
+			if (part == 0) {
 				// discard the current word
-				word.clear();
+				pos = word.length();
+				word_width = 0;
+			} else {
+				pos += part;
+				word_width -= part_width;
 			}
-
-			word_width = utils::strwidth_stfl(word);
-			curline_width = utils::strwidth_stfl(curline);
 		}
+		word.erase(0, pos);
 
 		if ((curline_width + word_width) > width) {
 			result.push_back(curline);
 			if (iswhitespace(word)) {
 				curline = prefix;
+				curline_width = prefix_width;
 			} else {
 				curline = prefix + word;
+				curline_width = prefix_width + word_width;
 			}
 		} else {
 			curline.append(word);
+			curline_width += word_width;
 		}
 	}
 
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <thread>
 #include <time.h>
+#include <utility>
 
 #include "3rd-party/json.hpp"
 #include "remoteapi.h"
@@ -438,7 +439,7 @@ rsspp::Feed TtRssApi::fetch_feed(const std::string& id, CURL* cached_handle)
 			item.pubDate = rfc822_date;
 			item.pubDate_ts = updated;
 
-			f.items.push_back(item);
+			f.items.push_back(std::move(item));
 		}
 	} catch (json::exception& e) {
 		LOG(Level::ERROR,
@@ -0,0 +1,68 @@
+#include "uiupdatequeue.h"
+
+#include <utility>
+
+namespace newsboat {
+
+namespace {
+
+// how long after the last post the main loop keeps waking up every frame
+const std::chrono::seconds busy_period(1);
+
+} // anonymous namespace
+
+UiUpdateQueue::UiUpdateQueue(std::chrono::milliseconds frame_interval)
+	: interval(frame_interval)
+	, pending(false)
+{
+}
+
+void UiUpdateQueue::post_status(const std::string& msg)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	updates.has_status = true;
+	updates.status = msg;
+	updates.posts++;
+	pending = true;
+	last_post = Clock::now();
+}
+
+void UiUpdateQueue::post_redraw()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	updates.posts++;
+	pending = true;
+	last_post = Clock::now();
+}
+
+bool UiUpdateQueue::take(Updates& taken)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	if (!pending) {
+		return false;
+	}
+	taken = std::move(updates);
+	updates = Updates();
+	pending = false;
+	return true;
+}
+
+bool UiUpdateQueue::frame_due(Clock::time_point now) const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return pending && now - last_frame >= interval;
+}
+
+void UiUpdateQueue::frame_drawn(Clock::time_point now)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	last_frame = now;
+}
+
+bool UiUpdateQueue::busy(Clock::time_point now) const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return pending || now - last_post < busy_period;
+}
+
+} // namespace newsboat
@@ -7,14 +7,17 @@
 #include <cstdlib>
 #include <cstring>
 #include <curl/curl.h>
+#include <cstdint>
 #include <cwchar>
 #include <errno.h>
 #include <fcntl.h>
 #include <iconv.h>
+#include <iomanip>
 #include <langinfo.h>
 #include <libgen.h>
 #include <libxml/uri.h>
 #include <locale>
+#include <map>
 #include <pwd.h>
 #include <regex>
 #include <sstream>
@@ -335,6 +338,160 @@ std::string utils::translit(const std::string& tocode,
 						     : (tocode));
 }
 
+/* Charsets in which every byte below 0x80 stands for the same ASCII
+ * character, so pure ASCII text is the same in all of them. Only names that
+ * show up as locale codesets or feed encodings are listed; anything else goes
+ * through iconv. */
+static bool is_ascii_compatible(const std::string& charset)
+{
+	static const char* const prefixes[] = {"utf-8",
+		"utf8",
+		"iso-8859-",
+		"iso8859-",
+		"iso_8859-",
+		"ansi_x3.4-1968",
+		"us-ascii",
+		"ascii",
+		"koi8-",
+		"cp125",
+		"windows-125",
+		"euc-",
+		"gb2312",
+		"gbk",
+		"gb18030",
+		"big5"};
+	for (const char* prefix : prefixes) {
+		if (strncasecmp(charset.c_str(), prefix, strlen(prefix)) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool is_utf8(const std::string& charset)
+{
+	return strcasecmp(charset.c_str(), "utf-8") == 0 ||
+		strcasecmp(charset.c_str(), "utf8") == 0;
+}
+
+/* Returns the length of the leading run of ASCII bytes in [s, s + len),
+ * stopping at the first NUL as well. Works a machine word at a time, which
+ * is enough for the compiler to vectorize the common all-ASCII case. */
+static size_t ascii_prefix_length(const char* s, size_t len)
+{
+	const uint64_t high_bits = 0x8080808080808080ULL;
+	const uint64_t low_bits = 0x0101010101010101ULL;
+
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, s + i, sizeof(word));
+		const uint64_t has_zero = (word - low_bits) & ~word & high_bits;
+		if ((word & high_bits) || has_zero) {
+			break;
+		}
+	}
+	for (; i < len; ++i) {
+		const unsigned char c = s[i];
+		if (c == 0 || c >= 0x80) {
+			break;
+		}
+	}
+	return i;
+}
+
+/* Checks that [s, s + len) is well-formed UTF-8 without NULs, i.e. that
+ * iconv would pass it through unchanged. */
+static bool is_valid_utf8(const char* s, size_t len)
+{
+	size_t i = 0;
+	while (i < len) {
+		i += ascii_prefix_length(s + i, len - i);
+		if (i == len) {
+			return true;
+		}
+
+		const unsigned char c = s[i];
+		size_t extra;
+		unsigned char min = 0x80;
+		unsigned char max = 0xBF;
+		if (c >= 0xC2 && c <= 0xDF) {
+			extra = 1;
+		} else if (c >= 0xE0 && c <= 0xEF) {
+			extra = 2;
+			if (c == 0xE0) {
+				min = 0xA0;
+			} else if (c == 0xED) {
+				// surrogates
+				max = 0x9F;
+			}
+		} else if (c >= 0xF0 && c <= 0xF4) {
+			extra = 3;
+			if (c == 0xF0) {
+				min = 0x90;
+			} else if (c == 0xF4) {
+				max = 0x8F;
+			}
+		} else {
+			// NUL, stray continuation byte, overlong form or
+			// beyond U+10FFFF
+			return false;
+		}
+
+		if (len - i <= extra) {
+			return false;
+		}
+		for (size_t j = 1; j <= extra; ++j) {
+			const unsigned char cc = s[i + j];
+			if (cc < min || cc > max) {
+				return false;
+			}
+			min = 0x80;
+			max = 0xBF;
+		}
+		i += extra + 1;
+	}
+	return true;
+}
+
+namespace {
+
+/* Conversion descriptors are expensive to open, and convert_text() runs for
+ * every title, author and description that gets displayed, sorted or
+ * matched. They're kept open per thread, since a descriptor carries
+ * conversion state and can't be shared. */
+class IconvCache {
+public:
+	~IconvCache()
+	{
+		for (const auto& entry : descriptors) {
+			if (entry.second != reinterpret_cast<iconv_t>(-1)) {
+				iconv_close(entry.second);
+			}
+		}
+	}
+
+	iconv_t get(const std::string& tocode, const std::string& fromcode)
+	{
+		const auto key = std::make_pair(tocode, fromcode);
+		const auto it = descriptors.find(key);
+		if (it != descriptors.end()) {
+			return it->second;
+		}
+
+		iconv_t cd = ::iconv_open(
+			utils::translit(tocode, fromcode).c_str(),
+			fromcode.c_str());
+		descriptors.emplace(key, cd);
+		return cd;
+	}
+
+private:
+	std::map<std::pair<std::string, std::string>, iconv_t> descriptors;
+};
+
+} // namespace
+
 std::string utils::convert_text(const std::string& text,
 	const std::string& tocode,
 	const std::string& fromcode)
@@ -344,14 +501,31 @@ std::string utils::convert_text(const std::string& text,
 	if (strcasecmp(tocode.c_str(), fromcode.c_str()) == 0)
 		return text;
 
-	iconv_t cd = ::iconv_open(
-		translit(tocode, fromcode).c_str(), fromcode.c_str());
+	/*
+	 * iconv stops at the first NUL, as it always has; the fast paths below
+	 * don't apply to such strings.
+	 */
+	const size_t length = strnlen(text.c_str(), text.length());
+	if (length == text.length()) {
+		if (ascii_prefix_length(text.data(), length) == length &&
+			is_ascii_compatible(tocode) &&
+			is_ascii_compatible(fromcode)) {
+			return text;
+		}
+		if (is_utf8(tocode) && is_utf8(fromcode) &&
+			is_valid_utf8(text.data(), length)) {
+			return text;
+		}
+	}
+
+	thread_local IconvCache cache;
+	iconv_t cd = cache.get(tocode, fromcode);
 
 	if (cd == reinterpret_cast<iconv_t>(-1))
 		return result;
 
-	size_t inbytesleft;
-	size_t outbytesleft;
+	// reset the shift state left over from the previous conversion
+	::iconv(cd, nullptr, nullptr, nullptr, nullptr);
 
 	/*
 	 * of all the Unix-like systems around there, only Linux/glibc seems to
@@ -364,45 +538,29 @@ std::string utils::convert_text(const std::string& text,
 #else
 	char* inbufp;
 #endif
-	char outbuf[16];
-	char* outbufp = outbuf;
+	char outbuf[4096];
 
-	outbytesleft = sizeof(outbuf);
 	inbufp = const_cast<char*>(
 		text.c_str()); // evil, but spares us some trouble
-	inbytesleft = strlen(inbufp);
+	size_t inbytesleft = length;
+	result.reserve(length);
 
-	do {
-		char* old_outbufp = outbufp;
-		int rc = ::iconv(
+	while (inbytesleft > 0) {
+		char* outbufp = outbuf;
+		size_t outbytesleft = sizeof(outbuf);
+		const size_t rc = ::iconv(
 			cd, &inbufp, &inbytesleft, &outbufp, &outbytesleft);
-		if (-1 == rc) {
-			switch (errno) {
-			case E2BIG:
-				result.append(
-					old_outbufp, outbufp - old_outbufp);
-				outbufp = outbuf;
-				outbytesleft = sizeof(outbuf);
-				inbufp += strlen(inbufp) - inbytesleft;
-				inbytesleft = strlen(inbufp);
-				break;
-			case EILSEQ:
-			case EINVAL:
-				result.append(
-					old_outbufp, outbufp - old_outbufp);
+		result.append(outbuf, outbufp - outbuf);
+		if (rc == static_cast<size_t>(-1)) {
+			if (errno == EILSEQ || errno == EINVAL) {
 				result.append("?");
-				inbufp += strlen(inbufp) - inbytesleft + 1;
-				inbytesleft = strlen(inbufp);
-				break;
-			default:
+				++inbufp;
+				--inbytesleft;
+			} else if (errno != E2BIG) {
 				break;
 			}
-		} else {
-			result.append(old_outbufp, outbufp - old_outbufp);
 		}
-	} while (inbytesleft > 0);
-
-	iconv_close(cd);
+	}
 
 	return result;
 }
@@ -929,6 +1087,67 @@ std::string utils::substr_with_width(const std::string& str,
 	return utils::wstr2str(result);
 }
 
+size_t utils::fit_width(const std::string& str,
+	size_t pos,
+	const size_t max_width,
+	size_t& width)
+{
+	// Measures like substr_with_width(), but in a single pass over the
+	// multibyte string, so that long lines can be split into many pieces
+	// in linear time. ASCII is measured without any conversion. A `<`
+	// without a matching `>` takes the rest of the string as a tag, so
+	// that no text is lost.
+
+	const size_t start = pos;
+	std::mbstate_t state = std::mbstate_t();
+	while (pos < str.length()) {
+		const char c = str[pos];
+		if (c == '<') {
+			const size_t end = str.find('>', pos + 1);
+			if (end == std::string::npos) {
+				pos = str.length();
+				break;
+			}
+			if (end == pos + 1) { // escaped less-than
+				if (width + 1 > max_width) {
+					break;
+				}
+				width++;
+			}
+			pos = end + 1;
+			continue;
+		}
+
+		size_t length = 1;
+		int w = 0;
+		if ((c & 0x80) == 0) {
+			w = (c >= 0x20 && c < 0x7f) ? 1 : 0;
+		} else {
+			wchar_t wc;
+			length = std::mbrtowc(&wc,
+					str.data() + pos,
+					str.length() - pos,
+					&state);
+			if (length == static_cast<size_t>(-1) ||
+				length == static_cast<size_t>(-2)) {
+				// invalid sequence; take a byte at a time
+				state = std::mbstate_t();
+				length = 1;
+				w = 1;
+			} else {
+				length = std::max<size_t>(length, 1);
+				w = std::max(wcwidth(wc), 0);
+			}
+		}
+		if (width + w > max_width) {
+			break;
+		}
+		width += w;
+		pos += length;
+	}
+	return pos - start;
+}
+
 std::string utils::join(const std::vector<std::string>& strings,
 	const std::string& separator)
 {
@@ -1240,6 +1459,19 @@ std::wstring utils::clean_nonprintable_characters(std::wstring text)
 	return text;
 }
 
+std::string utils::clean_nonprintable_characters(const std::string& text)
+{
+	// printable ASCII is left as it is, so skip the conversions
+	const bool printable_ascii =
+		std::all_of(text.cbegin(), text.cend(), [](char c) {
+			return c >= 0x20 && c < 0x7f;
+		});
+	if (printable_ascii) {
+		return text;
+	}
+	return utils::wstr2str(clean_nonprintable_characters(str2wstr(text)));
+}
+
 unsigned int utils::gentabs(const std::string& str)
 {
 	int tabcount = 4 - (utils::strwidth(str) / 8);
@@ -1463,4 +1695,23 @@ std::string utils::get_default_browser()
 	return std::string(browser);
 }
 
+/*
+ * Returns a fingerprint of the data that is stable across runs and platforms,
+ * so it can be persisted to the cache and compared on the next reload. This is
+ * 64-bit FNV-1a prefixed by the data length; it's meant for change detection,
+ * not for anything security-related.
+ */
+std::string utils::content_digest(const std::string& data)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (const unsigned char c : data) {
+		hash ^= c;
+		hash *= 0x100000001b3ULL;
+	}
+	std::ostringstream os;
+	os << data.length() << '-' << std::hex << std::setw(16)
+	   << std::setfill('0') << hash;
+	return os.str();
+}
+
 } // namespace newsboat
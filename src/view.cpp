@@ -64,11 +64,14 @@ View::View(Controller* c)
 	, keys(0)
 	, current_formaction(0)
 	, rxman(nullptr)
+	, item_render_cache(16 * 1024 * 1024)
 	, is_inside_qna(false)
 	, is_inside_cmdline(false)
 	, tab_count(0)
 	, rsscache(nullptr)
 	, filters(nullptr)
+	, ui_updates(std::chrono::milliseconds(50))
+	, ui_polling(false)
 {
 	if (getenv("ESCDELAY") == nullptr) {
 		set_escdelay(25);
@@ -78,6 +81,11 @@ View::View(Controller* c)
 View::~View()
 {
 	Stfl::reset();
+	if (input_latency.count() > 0) {
+		LOG(Level::INFO,
+			"View: input-to-draw latency: %s",
+			input_latency.summary());
+	}
 }
 
 void View::set_config_container(ConfigContainer* cfgcontainer)
@@ -150,6 +158,7 @@ void View::set_status_unlocked(const std::string& msg)
 		if (form) {
 			form->set("msg", msg);
 			form->run(-1);
+			ui_updates.frame_drawn(UiUpdateQueue::Clock::now());
 		} else {
 			LOG(Level::ERROR,
 				"View::set_status_unlocked: "
@@ -162,7 +171,56 @@ void View::set_status_unlocked(const std::string& msg)
 void View::set_status(const std::string& msg)
 {
 	std::lock_guard<std::mutex> lock(mtx);
-	set_status_unlocked(msg);
+	if (on_ui_thread()) {
+		set_status_unlocked(msg);
+		return;
+	}
+
+	ui_updates.post_status(msg);
+	draw_updates_unlocked(false);
+}
+
+void View::flush_updates()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	draw_updates_unlocked(true);
+}
+
+bool View::on_ui_thread() const
+{
+	// before the main loop runs, every thread draws for itself
+	return ui_thread == std::thread::id() ||
+		ui_thread == std::this_thread::get_id();
+}
+
+void View::draw_updates_unlocked(bool force)
+{
+	// while the main loop wakes up every frame, it draws the updates
+	// itself; otherwise the posting thread does, but at most once a frame
+	if (ui_polling) {
+		return;
+	}
+	if (!force && !ui_updates.frame_due(UiUpdateQueue::Clock::now())) {
+		return;
+	}
+
+	UiUpdateQueue::Updates updates;
+	if (!ui_updates.take(updates)) {
+		return;
+	}
+	LOG(Level::DEBUG,
+		"View::draw_updates_unlocked: drawing %u updates",
+		updates.posts);
+
+	auto fa = get_current_formaction();
+	if (fa == nullptr || fa->get_form() == nullptr) {
+		return;
+	}
+	if (updates.has_status) {
+		fa->get_form()->set("msg", updates.status);
+	}
+	fa->get_form()->run(-1);
+	ui_updates.frame_drawn(UiUpdateQueue::Clock::now());
 }
 
 void View::show_error(const std::string& msg)
@@ -175,22 +233,21 @@ int View::run()
 	bool have_macroprefix = false;
 	std::vector<MacroCmd> macrocmds;
 
-	// create feedlist
-	auto feedlist = std::make_shared<FeedListFormAction>(
-		this, feedlist_str, rsscache, filters, cfg);
-	set_bindings(feedlist);
-	feedlist->set_regexmanager(rxman);
-	feedlist->set_tags(tags);
-	apply_colors(feedlist);
-	formaction_stack.push_back(feedlist);
-	current_formaction = formaction_stack_size() - 1;
+	// set before init() starts the reload threads, which tell by it
+	// whether to draw for themselves
+	ui_thread = std::this_thread::get_id();
 
+	push_feedlist();
 	get_current_formaction()->init();
 
 	Stfl::reset();
 
 	curs_set(0);
 
+	// when the last key press was read, if it hasn't been drawn yet
+	bool input_pending = false;
+	UiUpdateQueue::Clock::time_point input_time;
+
 	/*
 	 * This is the main "event" loop of newsboat.
 	 */
@@ -199,6 +256,18 @@ int View::run()
 		// first, we take the current formaction.
 		std::shared_ptr<FormAction> fa = get_current_formaction();
 
+		// what other threads posted is drawn with this frame
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			UiUpdateQueue::Updates updates;
+			if (ui_updates.take(updates) && updates.has_status) {
+				fa->get_form()->set("msg", updates.status);
+			}
+			ui_polling =
+				ui_updates.busy(UiUpdateQueue::Clock::now()) ||
+				fa->is_loading();
+		}
+
 		// we signal "oh, you will receive an operation soon"
 		fa->prepare();
 
@@ -217,8 +286,28 @@ int View::run()
 							    // processed
 
 		} else {
-			// we then receive the event and ignore timeouts.
-			const char* event = fa->get_form()->run(60000);
+			const auto now = UiUpdateQueue::Clock::now();
+			if (input_pending) {
+				input_pending = false;
+				input_latency.add(std::chrono::duration_cast<
+					std::chrono::microseconds>(
+					now - input_time));
+				if (input_latency.count() % 100 == 0) {
+					LOG(Level::DEBUG,
+						"View::run: input-to-draw "
+						"latency: %s",
+						input_latency.summary());
+				}
+			}
+			ui_updates.frame_drawn(now);
+
+			// we then receive the event and ignore timeouts. While
+			// other threads post updates, we wake up every frame
+			// to draw them.
+			const int timeout = ui_polling
+				? ui_updates.frame_interval().count()
+				: 60000;
+			const char* event = fa->get_form()->run(timeout);
 
 			if (ctrl_c_hit) {
 				ctrl_c_hit = false;
@@ -242,6 +331,9 @@ int View::run()
 				continue;
 			}
 
+			input_pending = true;
+			input_time = UiUpdateQueue::Clock::now();
+
 			if (is_inside_qna) {
 				LOG(Level::DEBUG,
 					"View::run: we're inside QNA input");
@@ -454,6 +546,35 @@ void View::set_feedlist(std::vector<std::shared_ptr<RssFeed>> feeds)
 					FormAction>(formaction_stack[0]);
 			feedlist->set_feedlist(feeds);
 		}
+		if (!on_ui_thread()) {
+			ui_updates.post_redraw();
+		}
+	} catch (const MatcherException& e) {
+		set_status(strprintf::fmt(
+			_("Error: applying the filter failed: %s"), e.what()));
+	}
+}
+
+void View::update_feed(std::vector<std::shared_ptr<RssFeed>>& feeds,
+	unsigned int pos,
+	std::shared_ptr<RssFeed> oldfeed)
+{
+	try {
+		std::lock_guard<std::mutex> lock(mtx);
+
+		if (!feeds[pos]->is_query_feed()) {
+			feeds[pos]->set_feedptrs(feeds[pos]);
+		}
+
+		if (formaction_stack_size() > 0) {
+			std::shared_ptr<FeedListFormAction> feedlist =
+				std::dynamic_pointer_cast<FeedListFormAction,
+					FormAction>(formaction_stack[0]);
+			feedlist->update_feed(feeds, pos, oldfeed);
+		}
+		if (!on_ui_thread()) {
+			ui_updates.post_redraw();
+		}
 	} catch (const MatcherException& e) {
 		set_status(strprintf::fmt(
 			_("Error: applying the filter failed: %s"), e.what()));
@@ -466,7 +587,8 @@ void View::set_tags(const std::vector<std::string>& t)
 }
 
 void View::push_searchresult(std::shared_ptr<RssFeed> feed,
-	const std::string& phrase)
+	const std::string& phrase,
+	std::shared_ptr<SearchResultLoader> loader)
 {
 	assert(feed != nullptr);
 	LOG(Level::DEBUG, "View::push_searchresult: pushing search result");
@@ -480,6 +602,7 @@ void View::push_searchresult(std::shared_ptr<RssFeed> feed,
 		searchresult->set_feed(feed);
 		searchresult->set_show_searchresult(true);
 		searchresult->set_searchphrase(phrase);
+		searchresult->set_search_loader(loader);
 		apply_colors(searchresult);
 		searchresult->set_parent_formaction(get_current_formaction());
 		searchresult->init();
@@ -490,6 +613,18 @@ void View::push_searchresult(std::shared_ptr<RssFeed> feed,
 	}
 }
 
+void View::push_feedlist()
+{
+	auto feedlist = std::make_shared<FeedListFormAction>(
+		this, feedlist_str, rsscache, filters, cfg);
+	set_bindings(feedlist);
+	feedlist->set_regexmanager(rxman);
+	feedlist->set_tags(tags);
+	apply_colors(feedlist);
+	formaction_stack.push_back(feedlist);
+	current_formaction = formaction_stack_size() - 1;
+}
+
 void View::push_itemlist(std::shared_ptr<RssFeed> feed)
 {
 	assert(feed != nullptr);
@@ -548,6 +683,11 @@ void View::push_itemview(std::shared_ptr<RssFeed> f,
 				this, itemlist, itemview_str, rsscache, cfg));
 		set_bindings(itemview);
 		itemview->set_regexmanager(rxman);
+		if (item_prerenderer == nullptr) {
+			item_prerenderer.reset(new ItemPrerenderer(cfg, rxman));
+		}
+		itemview->set_render_cache(&item_render_cache);
+		itemview->set_prerenderer(item_prerenderer.get());
 		itemview->set_feed(f);
 		itemview->set_guid(guid);
 		itemview->set_parent_formaction(fa);
@@ -996,6 +1136,10 @@ void View::force_redraw()
 	std::shared_ptr<FormAction> fa = get_current_formaction();
 	if (fa != nullptr) {
 		fa->set_redraw(true);
+		if (ui_polling && !on_ui_thread()) {
+			// the main loop redraws with its next frame
+			return;
+		}
 		fa->prepare();
 		fa->get_form()->run(-1);
 	}
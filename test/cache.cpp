@@ -1,5 +1,6 @@
 #include "cache.h"
 
+#include <ctime>
 #include <sstream>
 
 #include "3rd-party/catch.hpp"
@@ -559,6 +560,51 @@ TEST_CASE("search_for_items finds all items with matching title or content",
 	}
 }
 
+TEST_CASE("search_for_items with a position returns the matches in pages",
+	"[Cache]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	std::vector<std::string> feedurls = {
+		"file://data/atom10_1.xml", "file://data/rss20_1.xml"};
+	for (const auto& url : feedurls) {
+		RssParser parser(url, &rsscache, &cfg, nullptr);
+		std::shared_ptr<RssFeed> feed = parser.parse();
+
+		rsscache.externalize_rssfeed(feed, false);
+	}
+
+	auto query = "content";
+	std::string feedurl;
+
+	SECTION("Search the whole DB")
+	{
+		feedurl = "";
+	}
+
+	SECTION("Search specific feed")
+	{
+		feedurl = feedurls[0];
+	}
+
+	const auto all = rsscache.search_for_items(query, feedurl);
+	REQUIRE(all.size() >= 3);
+
+	SearchPosition position;
+	std::vector<std::shared_ptr<RssItem>> paged;
+	while (!position.done) {
+		const auto page =
+			rsscache.search_for_items(query, feedurl, position, 2);
+		REQUIRE(page.size() <= 2);
+		paged.insert(paged.end(), page.begin(), page.end());
+	}
+
+	REQUIRE(paged.size() == all.size());
+	for (unsigned int i = 0; i < all.size(); ++i) {
+		REQUIRE(paged[i]->guid() == all[i]->guid());
+	}
+}
+
 TEST_CASE("update_rssitem_flags dumps `rss_item` object's flags to DB",
 	"[Cache]")
 {
@@ -836,6 +882,87 @@ TEST_CASE("internalize_rssfeed doesn't return items that are ignored",
 	REQUIRE(feed->total_item_count() == 2);
 }
 
+TEST_CASE("internalize_rssfeed ignores the same items whether ignore rules "
+	"are checked in SQL or in memory",
+	"[Cache]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	const std::string feedurl("http://example.com/feed.xml");
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_rssurl(feedurl);
+	const time_t now = time(nullptr);
+	for (int i = 0; i < 6; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid(std::to_string(i));
+		item->set_title(i % 2 ? "Odd item" : "Even item");
+		item->set_link("http://example.com/" + std::to_string(i));
+		item->set_author(i < 3 ? "John's" : "");
+		item->set_description("");
+		item->set_pubDate(now - i * 86400 - 60);
+		item->set_unread(i % 3 != 0);
+		item->set_flags(i % 2 ? "as" : "");
+		if (i == 4) {
+			item->set_enclosure_url("http://example.com/4.mp3");
+			item->set_enclosure_type("audio/mpeg");
+		}
+		feed->add_item(item);
+	}
+	rsscache.externalize_rssfeed(feed, false);
+
+	auto all_items = rsscache.internalize_rssfeed(feedurl, nullptr)->items();
+	REQUIRE(all_items.size() == 6);
+
+	const std::vector<std::string> expressions = {
+		"unread = \"yes\"",
+		"unread != \"no\"",
+		"unread = \"maybe\"",
+		"unread # \"yes\"",
+		"title = \"Odd item\"",
+		"title # \"Odd\"",
+		"title !# \"Odd item\"",
+		"author = \"John's\"",
+		"author != \"\"",
+		"link = \"http://example.com/3\"",
+		"guid = \"1\" or guid = \"2\"",
+		"flags # \"as\"",
+		"flags !# \"s\"",
+		"flags # \"\"",
+		"enclosure_url = \"\"",
+		"enclosure_type = \"audio/mpeg\"",
+		"age < 2",
+		"age > 3",
+		"age <= 2",
+		"age >= 3",
+		"age between 4:1",
+		"age between 2",
+		"unread = \"yes\" and (age < 2 or flags = \"as\")",
+		"title =~ \"^Even\" and age > 1",
+	};
+
+	for (const auto& expr : expressions) {
+		INFO(expr);
+		Matcher m(expr);
+		std::vector<std::string> expected;
+		for (const auto& item : all_items) {
+			if (!m.matches(item.get())) {
+				expected.push_back(item->guid());
+			}
+		}
+
+		RssIgnores ign;
+		ign.handle_action("ignore-article", {"*", expr});
+		feed = rsscache.internalize_rssfeed(feedurl, &ign);
+		std::vector<std::string> actual;
+		for (const auto& item : feed->items()) {
+			actual.push_back(item->guid());
+		}
+
+		REQUIRE(actual == expected);
+	}
+}
+
 TEST_CASE(
 	"externalize_rssfeed resets \"unread\" field if item's content "
 	"changed and reset_unread = \"yes\"",
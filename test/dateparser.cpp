@@ -0,0 +1,450 @@
+#include "dateparser.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <curl/curl.h>
+#include <string>
+#include <vector>
+
+#include "3rd-party/catch.hpp"
+#include "test-helpers.h"
+
+using namespace rsspp;
+
+/*
+ * Until dateparser.cpp came along, dates were handed to curl_getdate(), and
+ * if that failed, rewritten from W3CDTF into RFC 822 with the function below
+ * and handed to curl_getdate() again. It's kept here as the reference the
+ * new parser is compared against.
+ */
+static std::string legacy_w3cdtf_to_rfc822(const std::string& w3cdtf)
+{
+	if (w3cdtf.empty()) {
+		return "";
+	}
+
+	struct tm stm;
+	memset(&stm, 0, sizeof(stm));
+	stm.tm_mday = 1;
+
+	char* ptr = strptime(w3cdtf.c_str(), "%Y", &stm);
+
+	if (ptr != nullptr) {
+		ptr = strptime(ptr, "-%m", &stm);
+	} else {
+		return "";
+	}
+
+	if (ptr != nullptr) {
+		ptr = strptime(ptr, "-%d", &stm);
+	}
+	if (ptr != nullptr) {
+		ptr = strptime(ptr, "T%H", &stm);
+	}
+	if (ptr != nullptr) {
+		ptr = strptime(ptr, ":%M", &stm);
+	}
+	if (ptr != nullptr) {
+		ptr = strptime(ptr, ":%S", &stm);
+	}
+
+	int offs = 0;
+	if (ptr != nullptr) {
+		if (ptr[0] == '+' || ptr[0] == '-') {
+			unsigned int hour, min;
+			if (sscanf(ptr + 1, "%02u:%02u", &hour, &min) == 2) {
+				offs = 60 * 60 * hour + 60 * min;
+				if (ptr[0] == '+')
+					offs = -offs;
+				stm.tm_gmtoff = offs;
+			}
+		} else if (ptr[0] == 'Z') {
+			stm.tm_gmtoff = 0;
+		}
+	}
+
+	stm.tm_isdst = -1;
+	time_t gmttime = mktime(&stm) + offs;
+	char datebuf[256];
+	strftime(datebuf,
+		sizeof(datebuf),
+		"%a, %d %b %Y %H:%M:%S +0000",
+		localtime(&gmttime));
+	return datebuf;
+}
+
+static time_t legacy_parse_date(const std::string& date)
+{
+	time_t t = curl_getdate(date.c_str(), nullptr);
+	if (t == -1) {
+		t = curl_getdate(
+			legacy_w3cdtf_to_rfc822(date).c_str(), nullptr);
+	}
+	return t;
+}
+
+static const char* const weekdays[] = {
+	"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char* const long_weekdays[] = {"Sunday",
+	"Monday",
+	"Tuesday",
+	"Wednesday",
+	"Thursday",
+	"Friday",
+	"Saturday"};
+static const char* const months[] = {"Jan",
+	"Feb",
+	"Mar",
+	"Apr",
+	"May",
+	"Jun",
+	"Jul",
+	"Aug",
+	"Sep",
+	"Oct",
+	"Nov",
+	"Dec"};
+
+struct NamedZone {
+	const char* name;
+	int east; // minutes
+};
+
+static const NamedZone named_zones[] = {{"GMT", 0},
+	{"UTC", 0},
+	{"UT", 0},
+	{"EST", -300},
+	{"EDT", -240},
+	{"CST", -360},
+	{"PDT", -420},
+	{"CEST", 120},
+	{"JST", 540},
+	{"NZDT", 780},
+	{"Z", 0},
+	{"gmt", 0}};
+
+static const int numeric_zones[] = {0, 60, -480, 330, 840, -720, 345, -210};
+
+static std::string fmt(const char* format, ...)
+{
+	char buf[256];
+	va_list ap;
+	va_start(ap, format);
+	vsnprintf(buf, sizeof(buf), format, ap);
+	va_end(ap);
+	return buf;
+}
+
+static struct tm broken_down(time_t t, int east_minutes)
+{
+	const time_t local = t + east_minutes * 60;
+	struct tm stm;
+	gmtime_r(&local, &stm);
+	return stm;
+}
+
+static std::string numeric_zone(int east_minutes, bool colon)
+{
+	const int minutes = east_minutes < 0 ? -east_minutes : east_minutes;
+	return fmt(colon ? "%c%02d:%02d" : "%c%02d%02d",
+		east_minutes < 0 ? '-' : '+',
+		minutes / 60,
+		minutes % 60);
+}
+
+/* The same moment in time, written down in all the ways feeds do it. */
+static std::vector<std::string> spellings(time_t t, unsigned int variant)
+{
+	std::vector<std::string> result;
+
+	const int east = numeric_zones[variant % 8];
+	struct tm l = broken_down(t, east);
+	const int year = l.tm_year + 1900;
+	result.push_back(fmt("%s, %02d %s %04d %02d:%02d:%02d %s",
+		weekdays[l.tm_wday],
+		l.tm_mday,
+		months[l.tm_mon],
+		year,
+		l.tm_hour,
+		l.tm_min,
+		l.tm_sec,
+		numeric_zone(east, false).c_str()));
+	result.push_back(fmt("%d %s %04d %02d:%02d:%02d %s",
+		l.tm_mday,
+		months[l.tm_mon],
+		year,
+		l.tm_hour,
+		l.tm_min,
+		l.tm_sec,
+		numeric_zone(east, false).c_str()));
+	result.push_back(fmt("%s, %02d %s %04d %02d:%02d %s",
+		weekdays[l.tm_wday],
+		l.tm_mday,
+		months[l.tm_mon],
+		year,
+		l.tm_hour,
+		l.tm_min,
+		numeric_zone(east, false).c_str()));
+	result.push_back(fmt("%s, %02d %s %02d %d:%d:%d %s",
+		weekdays[l.tm_wday],
+		l.tm_mday,
+		months[l.tm_mon],
+		year % 100,
+		l.tm_hour,
+		l.tm_min,
+		l.tm_sec,
+		numeric_zone(east, false).c_str()));
+
+	const NamedZone& zone = named_zones[variant % 12];
+	struct tm n = broken_down(t, zone.east);
+	result.push_back(fmt("%s, %2d %s %04d %02d:%02d:%02d %s",
+		weekdays[n.tm_wday],
+		n.tm_mday,
+		months[n.tm_mon],
+		n.tm_year + 1900,
+		n.tm_hour,
+		n.tm_min,
+		n.tm_sec,
+		zone.name));
+
+	struct tm u = broken_down(t, 0);
+	result.push_back(fmt("%s, %02d-%s-%02d %02d:%02d:%02d GMT",
+		long_weekdays[u.tm_wday],
+		u.tm_mday,
+		months[u.tm_mon],
+		(u.tm_year + 1900) % 100,
+		u.tm_hour,
+		u.tm_min,
+		u.tm_sec));
+	result.push_back(fmt("%s %s %2d %02d:%02d:%02d %04d",
+		weekdays[u.tm_wday],
+		months[u.tm_mon],
+		u.tm_mday,
+		u.tm_hour,
+		u.tm_min,
+		u.tm_sec,
+		u.tm_year + 1900));
+	result.push_back(fmt("%04d%02d%02d",
+		u.tm_year + 1900,
+		u.tm_mon + 1,
+		u.tm_mday));
+	result.push_back(fmt("\n\t%s, %02d %s %04d %02d:%02d:%02d GMT\r\n",
+		weekdays[u.tm_wday],
+		u.tm_mday,
+		months[u.tm_mon],
+		u.tm_year + 1900,
+		u.tm_hour,
+		u.tm_min,
+		u.tm_sec));
+
+	result.push_back(fmt("%04d-%02d-%02dT%02d:%02d:%02d%s",
+		year,
+		l.tm_mon + 1,
+		l.tm_mday,
+		l.tm_hour,
+		l.tm_min,
+		l.tm_sec,
+		east == 0 ? "Z" : numeric_zone(east, true).c_str()));
+	result.push_back(fmt("%04d-%02d-%02dT%02d:%02d:%02d",
+		u.tm_year + 1900,
+		u.tm_mon + 1,
+		u.tm_mday,
+		u.tm_hour,
+		u.tm_min,
+		u.tm_sec));
+	result.push_back(fmt("  %04d-%02d-%02dT%02d:%02d:%02dZ\n",
+		u.tm_year + 1900,
+		u.tm_mon + 1,
+		u.tm_mday,
+		u.tm_hour,
+		u.tm_min,
+		u.tm_sec));
+	result.push_back(fmt(
+		"%04d-%02d-%02d", u.tm_year + 1900, u.tm_mon + 1, u.tm_mday));
+	result.push_back(fmt("%04d-%02d", u.tm_year + 1900, u.tm_mon + 1));
+	result.push_back(fmt("%04d", u.tm_year + 1900));
+
+	return result;
+}
+
+static std::vector<std::string> corpus()
+{
+	std::vector<std::string> result;
+
+	// 1901 to 2099, picked by a fixed LCG so that the corpus is the same
+	// on every run
+	const int64_t first = -2177452800;
+	const int64_t range = 4102444800 - first;
+	uint64_t state = 20181018;
+	for (unsigned int i = 0; i < 2000; ++i) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		const time_t t = first + (state >> 11) % range;
+		for (const auto& s : spellings(t, i)) {
+			result.push_back(s);
+		}
+	}
+
+	const std::vector<std::string> oddities = {
+		"Tue,30 Dec 2008 10:03:15 GMT",
+		"Tue, 30 Dec 2008 10:03:15 +0000 (UTC)",
+		"Tue, 30 Dec 2008 10:03:15 GMT+1",
+		"Tue, 30 Dec 2008 10:03:15 EST extra",
+		"Tue 30 Dec 2008 10:03:15 +0000 extra",
+		"TUE, 30 DEC 2008 10:03:15 gmt",
+		"Tuesday, 30 Dec 2008 10:03:15 GMT",
+		"Mon, 30 Dec 2008 10:03:15 GMT",
+		"Tue, 31 Feb 2008 10:03:15 GMT",
+		"Tue, 30 Dec 2008 10:03:60 GMT",
+		"Tue, 30 Dec 2008 10:3:5 GMT",
+		"Tue, 30 Dec 2008 1:03:15 GMT",
+		"Tue, 30 Dec 2008 10:03:15 -0000",
+		"Tue, 30 Dec 2008 10:03:15 +1400",
+		"Tue, 30 Dec 2008 10:03:15 A",
+		"Tue, 30 Dec 2008 10:03:15 N",
+		"Tue, 30 Dec 70 10:03:15 GMT",
+		"Tue, 30 Dec 71 10:03:15 GMT",
+		"Tue, 30 Dec 1583 10:03:15 GMT",
+		"30 Dec 2008",
+		"Dec 30, 2008",
+		"Dec 2008 30",
+		"2008 Dec 30",
+		"2008-Dec-30",
+		"2008-13-01",
+		"2008-12-32T10:00:00Z",
+		"2008-12-30T24:00:00Z",
+		"2008-12-30T10:03:15-08:00",
+		"2008-12-30T10:03Z",
+		"2008-12-30T10Z",
+		"2008-12-30T",
+		"2008-12-30Tfoo",
+		// these were never understood
+		"",
+		"garbage",
+		"Tue, 30 Dec 2008 25:03:15 GMT",
+		"Tue, 30 Dec 2008 10:03:15 +2400",
+		"Tue, 30 Dec 2008 10:03:15 XYZ",
+		"Tue, 30 Dec 1500 10:03:15 GMT",
+		"Tue, 0 Dec 2008 10:03:15 GMT",
+		"-3",
+	};
+	result.insert(result.end(), oddities.begin(), oddities.end());
+
+	return result;
+}
+
+TEST_CASE("parse_date() agrees with curl_getdate() and the old W3CDTF parser",
+	"[rsspp::parse_date]")
+{
+	TestHelpers::EnvVar tzEnv("TZ");
+	tzEnv.on_change([]() { ::tzset(); });
+	tzEnv.set("UTC");
+
+	unsigned int mismatches = 0;
+	for (const auto& date : corpus()) {
+		const time_t expected = legacy_parse_date(date);
+		const time_t actual = parse_date(date);
+		if (expected != actual) {
+			INFO("date: `" << date << "'");
+			CHECK(actual == expected);
+			if (++mismatches == 10) {
+				break;
+			}
+		}
+	}
+	REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("parse_date() understands dates the old code got wrong",
+	"[rsspp::parse_date]")
+{
+	const time_t expected = 1230631395; // 2008-12-30T10:03:15Z
+
+	SECTION("Colon in RFC 822 timezone")
+	{
+		REQUIRE(parse_date("Tue, 30 Dec 2008 11:03:15 +01:00") ==
+			expected);
+	}
+
+	SECTION("Full month name")
+	{
+		REQUIRE(parse_date("Tue, 30 December 2008 10:03:15 GMT") ==
+			expected);
+	}
+
+	SECTION("Fractional seconds")
+	{
+		REQUIRE(parse_date("Tue, 30 Dec 2008 10:03:15.123 GMT") ==
+			expected);
+		REQUIRE(parse_date("2008-12-30T11:03:15.5+01:00") == expected);
+	}
+
+	SECTION("Space between date and time")
+	{
+		REQUIRE(parse_date("2008-12-30 10:03:15") == expected);
+	}
+
+	SECTION("W3CDTF timezone without a colon, or without seconds")
+	{
+		REQUIRE(parse_date("2008-12-30T11:03:15+0100") == expected);
+		REQUIRE(parse_date("2008-12-30T11:03+01:00") == expected - 15);
+	}
+
+	SECTION("Leading numbers aren't mistaken for a W3CDTF year")
+	{
+		// these used to end up as 1 Jan 2030 and 1 Jan 2012
+		REQUIRE(parse_date("30/12/2008") == -1);
+		REQUIRE(parse_date("12/30/2008 10:00") == -1);
+		REQUIRE(parse_date("30 Dec 2008 10:03:15 +0000 extra more") ==
+			-1);
+	}
+}
+
+TEST_CASE("parse_w3cdtf_date() only accepts W3CDTF", "[rsspp::parse_date]")
+{
+	REQUIRE(parse_w3cdtf_date("2008-12-30T10:03:15Z") == 1230631395);
+	REQUIRE(parse_w3cdtf_date("2008") == 1199145600);
+	REQUIRE(parse_w3cdtf_date("Tue, 30 Dec 2008 10:03:15 GMT") == -1);
+	REQUIRE(parse_w3cdtf_date("20081230") == -1);
+	REQUIRE(parse_w3cdtf_date("") == -1);
+}
+
+TEST_CASE("format_rfc822_date() writes dates in UTC", "[rsspp::parse_date]")
+{
+	TestHelpers::EnvVar tzEnv("TZ");
+	tzEnv.on_change([]() { ::tzset(); });
+	tzEnv.set("Australia/Sydney");
+
+	REQUIRE(format_rfc822_date(1230631395) ==
+		"Tue, 30 Dec 2008 10:03:15 +0000");
+	REQUIRE(format_rfc822_date(0) == "Thu, 01 Jan 1970 00:00:00 +0000");
+	REQUIRE(format_rfc822_date(-2177452800) ==
+		"Tue, 01 Jan 1901 00:00:00 +0000");
+}
+
+TEST_CASE("parse_date() benchmark", "[.][benchmark][rsspp::parse_date]")
+{
+	TestHelpers::EnvVar tzEnv("TZ");
+	tzEnv.on_change([]() { ::tzset(); });
+	tzEnv.set("UTC");
+
+	const auto dates = corpus();
+	time_t sum = 0;
+
+	BENCHMARK("curl_getdate() with the old W3CDTF fallback")
+	{
+		for (const auto& date : dates) {
+			sum += legacy_parse_date(date);
+		}
+	}
+
+	BENCHMARK("rsspp::parse_date()")
+	{
+		for (const auto& date : dates) {
+			sum += parse_date(date);
+		}
+	}
+
+	REQUIRE(sum != 0);
+}
@@ -0,0 +1,131 @@
+#include "feedlistformaction.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "controller.h"
+#include "filtercontainer.h"
+#include "keymap.h"
+#include "regexmanager.h"
+#include "rss.h"
+#include "view.h"
+
+using namespace newsboat;
+
+namespace {
+
+std::shared_ptr<RssFeed> make_feed(Cache* rsscache,
+	const std::string& url,
+	unsigned int unread,
+	unsigned int total)
+{
+	auto feed = std::make_shared<RssFeed>(rsscache);
+	feed->set_rssurl(url);
+	feed->set_title(url);
+	for (unsigned int i = 0; i < total; ++i) {
+		auto item = std::make_shared<RssItem>(rsscache);
+		item->set_guid(url + "#" + std::to_string(i));
+		item->set_unread_nowrite(i < unread);
+		feed->add_item(item);
+	}
+	return feed;
+}
+
+bool has_line(const std::shared_ptr<Stfl::Form>& form, unsigned int pos)
+{
+	const std::string name = "listitem[" + std::to_string(pos) + "]";
+	return form->dump("feeds", "", 0).find(name) != std::string::npos;
+}
+
+} // anonymous namespace
+
+TEST_CASE("update_feed() keeps the feed list up to date while feeds are "
+	"reloaded",
+	"[FeedListFormAction]")
+{
+	Controller c;
+	newsboat::View v(&c);
+	ConfigContainer cfg;
+	cfg.set_configvalue("feedlist-title-format", "%u of %t unread");
+	Cache rsscache(":memory:", &cfg);
+	FilterContainer filters;
+	RegexManager regman;
+
+	KeyMap k(KM_NEWSBOAT);
+	v.set_keymap(&k);
+
+	v.set_regexmanager(&regman);
+	v.set_config_container(&cfg);
+	v.set_cache(&rsscache);
+	v.set_filters(&filters);
+	c.set_view(&v);
+
+	std::vector<std::shared_ptr<RssFeed>>& feeds =
+		c.get_feedcontainer()->feeds;
+	feeds.push_back(make_feed(&rsscache, "http://example.com/a", 1, 2));
+	feeds.push_back(make_feed(&rsscache, "http://example.com/b", 2, 2));
+	feeds.push_back(make_feed(&rsscache, "http://example.com/c", 1, 1));
+
+	v.push_feedlist();
+	const auto feedlist = std::dynamic_pointer_cast<FeedListFormAction>(
+			v.get_current_formaction());
+	REQUIRE(feedlist != nullptr);
+	const auto form = feedlist->get_form();
+	c.update_feedlist();
+	REQUIRE(form->get("head") == "3 of 3 unread");
+
+	SECTION("a feed whose articles were all read gets its line replaced")
+	{
+		const auto oldfeed = feeds[0];
+		feeds[0] = make_feed(&rsscache, "http://example.com/a", 0, 2);
+		feedlist->update_feed(feeds, 0, oldfeed);
+
+		const std::string line = form->dump("0", "", 0);
+		REQUIRE(line.find("(0/2)") != std::string::npos);
+		REQUIRE(line.find("<unread>") == std::string::npos);
+		REQUIRE(form->get("head") == "2 of 3 unread");
+	}
+
+	SECTION("hiding read feeds")
+	{
+		feedlist->process_op(OP_TOGGLESHOWREAD);
+		feedlist->prepare();
+		REQUIRE(has_line(form, 1));
+
+		SECTION("a feed that leaves the list makes it rebuild")
+		{
+			// let the rebuild above fall out of the interval in
+			// which rebuilds are postponed
+			std::this_thread::sleep_for(
+				std::chrono::milliseconds(150));
+
+			const auto oldfeed = feeds[1];
+			feeds[1] = make_feed(
+					&rsscache, "http://example.com/b", 0, 2);
+			feedlist->update_feed(feeds, 1, oldfeed);
+
+			REQUIRE(has_line(form, 0));
+			REQUIRE_FALSE(has_line(form, 1));
+			REQUIRE(has_line(form, 2));
+			REQUIRE(form->get("head") == "2 of 2 unread");
+		}
+
+		SECTION("a rebuild that had to wait happens on the next prepare()")
+		{
+			// right after the last rebuild, so this one waits
+			const auto oldfeed = feeds[1];
+			feeds[1] = make_feed(
+					&rsscache, "http://example.com/b", 0, 2);
+			feedlist->update_feed(feeds, 1, oldfeed);
+			REQUIRE(has_line(form, 1));
+
+			feedlist->prepare();
+			REQUIRE_FALSE(has_line(form, 1));
+			REQUIRE(form->get("head") == "2 of 2 unread");
+		}
+	}
+}
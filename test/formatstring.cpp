@@ -90,3 +90,72 @@ TEST_CASE("do_format replaces variables with values", "[FmtStrFormatter]")
 		}
 	}
 }
+
+TEST_CASE("FmtStrTemplate can format many sets of values",
+	"[FmtStrTemplate]")
+{
+	const FmtStrTemplate tmpl("%4i|%-6t|%?a?%a&-?|%>.%n");
+	REQUIRE(tmpl.source() == "%4i|%-6t|%?a?%a&-?|%>.%n");
+
+	FmtStrTemplate::Values values;
+	values['i'] = "1";
+	values['t'] = "first";
+	values['a'] = "ann";
+	values['n'] = "N";
+	REQUIRE(tmpl.format(values) == "   1|first |ann|.N");
+	REQUIRE(tmpl.format(values, 20) == "   1|first |ann|...N");
+
+	values['i'] = "12345";
+	values['t'] = "second title";
+	values['a'] = "";
+	REQUIRE(tmpl.format(values) == "1234|second|-|.N");
+	REQUIRE(tmpl.format(values, 20) == "1234|second|-|.....N");
+}
+
+TEST_CASE("FmtStrTemplate keeps FmtStrFormatter's handling of odd format "
+	"strings",
+	"[FmtStrTemplate]")
+{
+	FmtStrTemplate::Values values;
+	values['a'] = "AAA";
+
+	REQUIRE(FmtStrTemplate("%").format(values) == "");
+	REQUIRE(FmtStrTemplate("%>").format(values) == ">");
+	REQUIRE(FmtStrTemplate("%4").format(values) == "");
+	REQUIRE(FmtStrTemplate("%-a|%0a|").format(values) == "||");
+	REQUIRE(FmtStrTemplate("x%?a").format(values) == "x");
+	REQUIRE(FmtStrTemplate("x%?a?yes").format(values) == "x");
+	REQUIRE(FmtStrTemplate("%?a?&no?").format(values) == "no");
+	REQUIRE(FmtStrTemplate("%?b?yes?").format(values) == "");
+	REQUIRE(FmtStrTemplate("%?a?%a%>.|&x?").format(values, 6) ==
+		"AAA..|");
+}
+
+TEST_CASE("FmtStrTemplate aligns by characters, not bytes",
+	"[FmtStrTemplate]")
+{
+	FmtStrTemplate::Values values;
+	values['t'] = "Title \xc3\xa4\xc3\xb6\xc3\xbc";
+
+	REQUIRE(FmtStrTemplate("[%-11t]").format(values) ==
+		"[Title \xc3\xa4\xc3\xb6\xc3\xbc  ]");
+	REQUIRE(FmtStrTemplate("[%7t]").format(values) ==
+		"[Title \xc3\xa4]");
+	REQUIRE(FmtStrTemplate("%t%>-|").format(values, 12) ==
+		"Title \xc3\xa4\xc3\xb6\xc3\xbc--|");
+}
+
+TEST_CASE("FmtStrTemplate::uses() tells which characters the format string "
+	"refers to",
+	"[FmtStrTemplate]")
+{
+	const FmtStrTemplate tmpl("%4i %f %% %?T?|%-17T|  &%D?%t %>x");
+
+	for (const char c : {'i', 'f', 'T', 'D', 't'}) {
+		REQUIRE(tmpl.uses(c));
+	}
+	for (const char c : {'%', 'a', 'x', '?', '>', '\x80'}) {
+		REQUIRE_FALSE(tmpl.uses(c));
+	}
+	REQUIRE_FALSE(FmtStrTemplate().uses('a'));
+}
@@ -292,6 +292,24 @@ TEST_CASE("<u> is rendered as underlined text", "[HtmlRenderer]")
 	REQUIRE(lines[0] == p(LineType::wrappable, "<u>test</>"));
 }
 
+TEST_CASE("Tag names are case-insensitive", "[HtmlRenderer]")
+{
+	HtmlRenderer r;
+
+	const std::string input =
+		"<STRONG>bold</Strong><B>bold</b><U>under</U>lined<Br/>"
+		"<Blink>unknown tags are skipped</BLINK>";
+	std::vector<std::pair<LineType, std::string>> lines;
+	std::vector<LinkPair> links;
+
+	REQUIRE_NOTHROW(r.render(input, lines, links, url));
+	REQUIRE(lines.size() == 2);
+	REQUIRE(lines[0] ==
+		p(LineType::wrappable, "<b>bold</><b>bold</><u>under</>lined"));
+	REQUIRE(lines[1] ==
+		p(LineType::wrappable, "unknown tags are skipped"));
+}
+
 TEST_CASE("<q> is rendered as text in quotes", "[HtmlRenderer]")
 {
 	HtmlRenderer r;
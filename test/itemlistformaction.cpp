@@ -792,3 +792,148 @@ TEST_CASE("OP_PIPE_TO pipes an article's content to an external command",
 		test_url,
 		test_description);
 }
+
+TEST_CASE("peek_item() returns the item the article view would move to",
+	"[ItemListFormAction]")
+{
+	Controller c;
+	newsboat::View v(&c);
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	FilterContainer filters;
+
+	v.set_config_container(&cfg);
+	c.set_view(&v);
+
+	std::shared_ptr<RssFeed> feed = std::make_shared<RssFeed>(&rsscache);
+	std::vector<std::shared_ptr<RssItem>> items;
+	for (const bool unread : {true, false, true, false}) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid("item" + std::to_string(items.size()));
+		item->set_unread_nowrite(unread);
+		feed->add_item(item);
+		items.push_back(item);
+	}
+
+	ItemListFormAction itemlist(&v, itemlist_str, &rsscache, &filters, &cfg);
+	itemlist.set_feed(feed);
+
+	// the first item is selected, and doesn't count as unread
+	REQUIRE(itemlist.peek_item(OP_NEXT) == items[1]);
+	REQUIRE(itemlist.peek_item(OP_PREV) == nullptr);
+	REQUIRE(itemlist.peek_item(OP_NEXTUNREAD) == items[2]);
+	REQUIRE(itemlist.peek_item(OP_PREVUNREAD) == items[2]);
+	REQUIRE(itemlist.peek_item(OP_RANDOMUNREAD) == nullptr);
+
+	items[2]->set_unread_nowrite(false);
+	REQUIRE(itemlist.peek_item(OP_NEXTUNREAD) == nullptr);
+	REQUIRE(itemlist.peek_item(OP_PREVUNREAD) == nullptr);
+}
+
+TEST_CASE("prepare() formats only the lines near the cursor",
+	"[ItemListFormAction]")
+{
+	Controller c;
+	newsboat::View v(&c);
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	FilterContainer filters;
+
+	v.set_config_container(&cfg);
+	c.set_view(&v);
+
+	std::shared_ptr<RssFeed> feed = std::make_shared<RssFeed>(&rsscache);
+	for (int i = 0; i < 500; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid("item" + std::to_string(i));
+		item->set_title("Article " + std::to_string(i));
+		// newest first, so that articles are shown in this order
+		item->set_pubDate(1000 - i);
+		feed->add_item(item);
+	}
+
+	ItemListFormAction itemlist(&v, itemlist_str, &rsscache, &filters, &cfg);
+	itemlist.set_feed(feed);
+
+	const auto form = itemlist.get_form();
+	const auto row = [&](int pos) {
+		return form->dump(std::to_string(pos), "", 0);
+	};
+	const auto is_placeholder = [&](int pos) {
+		return row(pos).find("text:\"\"") != std::string::npos;
+	};
+
+	// The list hasn't been drawn, so it's taken to be 100 lines high;
+	// lines up to twice that far from the cursor are formatted.
+	itemlist.prepare();
+	REQUIRE(row(0).find("Article 0") != std::string::npos);
+	REQUIRE(row(200).find("Article 200") != std::string::npos);
+	REQUIRE(is_placeholder(201));
+	REQUIRE(is_placeholder(499));
+
+	SECTION("lines are formatted in place when the cursor gets near them")
+	{
+		form->set("itempos", "499");
+		itemlist.prepare();
+
+		REQUIRE(row(499).find("Article 499") != std::string::npos);
+		REQUIRE(row(299).find("Article 299") != std::string::npos);
+		REQUIRE(is_placeholder(298));
+		REQUIRE(is_placeholder(201));
+		// lines that were formatted before are kept
+		REQUIRE(row(0).find("Article 0") != std::string::npos);
+	}
+}
+
+TEST_CASE("prepare() re-formats only the line of an article marked read on "
+	"hover",
+	"[ItemListFormAction]")
+{
+	Controller c;
+	newsboat::View v(&c);
+	ConfigContainer cfg;
+	cfg.set_configvalue("mark-as-read-on-hover", "yes");
+	Cache rsscache(":memory:", &cfg);
+	FilterContainer filters;
+
+	v.set_config_container(&cfg);
+	c.set_view(&v);
+
+	std::shared_ptr<RssFeed> feed = std::make_shared<RssFeed>(&rsscache);
+	std::vector<std::shared_ptr<RssItem>> items;
+	for (int i = 0; i < 5; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid("item" + std::to_string(i));
+		item->set_title("Article " + std::to_string(i));
+		// newest first, so that articles are shown in this order
+		item->set_pubDate(1000 - i);
+		item->set_unread_nowrite(true);
+		feed->add_item(item);
+		items.push_back(item);
+	}
+
+	ItemListFormAction itemlist(&v, itemlist_str, &rsscache, &filters, &cfg);
+	itemlist.set_feed(feed);
+
+	const auto form = itemlist.get_form();
+	const auto row = [&](int pos) {
+		return form->dump(std::to_string(pos), "", 0);
+	};
+
+	itemlist.prepare();
+	REQUIRE_FALSE(items[0]->unread());
+	REQUIRE(row(1).find("<unread>") != std::string::npos);
+
+	// not something the list is told about, so it only shows up in lines
+	// that are formatted again
+	items[2]->set_title("Renamed");
+
+	form->set("itempos", "1");
+	itemlist.prepare();
+
+	REQUIRE_FALSE(items[1]->unread());
+	REQUIRE(row(1).find("<unread>") == std::string::npos);
+	REQUIRE(row(1).find("Article 1") != std::string::npos);
+	REQUIRE(row(2).find("Article 2") != std::string::npos);
+	REQUIRE(row(2).find("Renamed") == std::string::npos);
+}
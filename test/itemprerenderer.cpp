@@ -0,0 +1,103 @@
+#include "itemprerenderer.h"
+
+#include <unistd.h>
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "itemrenderer.h"
+#include "regexmanager.h"
+#include "rss.h"
+
+using namespace newsboat;
+
+namespace {
+
+std::shared_ptr<RssItem> make_item(Cache* c, const std::string& guid)
+{
+	auto item = std::make_shared<RssItem>(c);
+	item->set_guid(guid);
+	item->set_title("Title of " + guid);
+	item->set_description("<p>Hello, <a href=\"https://example.com/\">"
+		"world</a>!</p>");
+	return item;
+}
+
+ItemRenderCache::Key make_key(const std::shared_ptr<RssItem>& item,
+	const RegexManager& rxman)
+{
+	ItemRenderCache::Key key;
+	key.guid = item->guid();
+	key.revision = item->revision();
+	key.text_width = 70;
+	key.window_width = 80;
+	key.renderer = "internal";
+	key.highlight_revision = rxman.revision();
+	return key;
+}
+
+} // anonymous namespace
+
+TEST_CASE("ItemPrerenderer renders articles the same way the article view "
+	"does",
+	"[ItemPrerenderer]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RegexManager rxman;
+	rxman.handle_action("highlight", {"article", "world", "red"});
+	ItemRenderCache cache(1024 * 1024);
+	ItemPrerenderer prerenderer(&cfg, &rxman);
+
+	const auto item = make_item(&rsscache, "guid");
+	const auto key = make_key(item, rxman);
+	prerenderer.prerender(item, key);
+
+	// collecting for some other article doesn't wait for the render
+	const ItemRenderCache::Entry* entry = nullptr;
+	for (int i = 0; i < 500 && entry == nullptr; ++i) {
+		::usleep(10 * 1000);
+		prerenderer.collect(cache, "other", rxman.revision());
+		entry = cache.get(key);
+	}
+	REQUIRE(entry != nullptr);
+
+	std::vector<LinkPair> links;
+	const auto expected = item_renderer::to_stfl_list(
+			cfg, item, 70, 80, &rxman, "article", links);
+	REQUIRE(entry->text == expected.first);
+	REQUIRE(entry->num_lines == expected.second);
+	REQUIRE(entry->links == links);
+	REQUIRE(entry->links.size() == 1);
+}
+
+TEST_CASE("ItemPrerenderer throws away unwanted renders",
+	"[ItemPrerenderer]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RegexManager rxman;
+	ItemRenderCache cache(1024 * 1024);
+	ItemPrerenderer prerenderer(&cfg, &rxman);
+
+	const auto item = make_item(&rsscache, "guid");
+	const auto key = make_key(item, rxman);
+	prerenderer.prerender(item, key);
+
+	SECTION("cancelled renders")
+	{
+		prerenderer.cancel();
+		prerenderer.collect(cache, key.guid, rxman.revision());
+		REQUIRE(cache.get(key) == nullptr);
+	}
+
+	SECTION("renders made with old highlight rules")
+	{
+		rxman.handle_action("highlight", {"article", "Hello", "red"});
+		auto new_key = key;
+		new_key.highlight_revision = rxman.revision();
+
+		prerenderer.collect(cache, key.guid, rxman.revision());
+		REQUIRE(cache.get(new_key) == nullptr);
+	}
+}
@@ -0,0 +1,193 @@
+#include "itemrendercache.h"
+
+#include "3rd-party/catch.hpp"
+
+using namespace newsboat;
+
+namespace {
+
+ItemRenderCache::Key make_key(const std::string& guid)
+{
+	ItemRenderCache::Key key;
+	key.guid = guid;
+	key.revision = 1;
+	key.text_width = 80;
+	key.window_width = 85;
+	key.renderer = "internal";
+	return key;
+}
+
+ItemRenderCache::Entry make_entry(const std::string& text)
+{
+	ItemRenderCache::Entry entry;
+	entry.text = text;
+	entry.num_lines = 1;
+	entry.links.push_back(LinkPair("http://example.com/", LinkType::HREF));
+	return entry;
+}
+
+} // anonymous namespace
+
+TEST_CASE("ItemRenderCache returns what was put into it",
+	"[ItemRenderCache]")
+{
+	ItemRenderCache cache(1024 * 1024);
+	const auto key = make_key("guid");
+
+	REQUIRE(cache.get(key) == nullptr);
+
+	cache.put(key, make_entry("{list{listitem text:\"hello\"}}"));
+
+	const auto entry = cache.get(key);
+	REQUIRE(entry != nullptr);
+	REQUIRE(entry->text == "{list{listitem text:\"hello\"}}");
+	REQUIRE(entry->num_lines == 1);
+	REQUIRE(entry->links.size() == 1);
+	REQUIRE(entry->links[0].first == "http://example.com/");
+
+	SECTION("rendered and source views are kept apart")
+	{
+		auto source = key;
+		source.source = true;
+		REQUIRE(cache.get(source) == nullptr);
+
+		cache.put(source, make_entry("source"));
+		REQUIRE(cache.get(source)->text == "source");
+		REQUIRE(cache.get(key) != nullptr);
+	}
+
+	SECTION("putting an entry for the same article replaces the old one")
+	{
+		auto wider = key;
+		wider.text_width = 100;
+		cache.put(wider, make_entry("wider"));
+
+		REQUIRE(cache.get(wider)->text == "wider");
+		REQUIRE(cache.get(key) == nullptr);
+	}
+
+	SECTION("clear() removes all entries")
+	{
+		cache.clear();
+		REQUIRE(cache.get(key) == nullptr);
+		REQUIRE(cache.size() == 0);
+	}
+}
+
+TEST_CASE("ItemRenderCache only returns entries rendered the same way",
+	"[ItemRenderCache]")
+{
+	ItemRenderCache cache(1024 * 1024);
+	const auto key = make_key("guid");
+	cache.put(key, make_entry("text"));
+
+	auto other = key;
+
+	SECTION("item revision")
+	{
+		other.revision = 2;
+	}
+
+	SECTION("text width")
+	{
+		other.text_width = 60;
+	}
+
+	SECTION("window width")
+	{
+		other.window_width = 120;
+	}
+
+	SECTION("html-renderer")
+	{
+		other.renderer = "w3m -dump -T text/html";
+	}
+
+	SECTION("feed title")
+	{
+		other.feed_title = "Renamed feed";
+	}
+
+	REQUIRE(cache.get(other) == nullptr);
+	REQUIRE(cache.get(key) != nullptr);
+}
+
+TEST_CASE("ItemRenderCache drops everything when highlight rules change",
+	"[ItemRenderCache]")
+{
+	ItemRenderCache cache(1024 * 1024);
+	const auto first = make_key("first");
+	const auto second = make_key("second");
+	cache.put(first, make_entry("first"));
+	cache.put(second, make_entry("second"));
+
+	auto highlighted = first;
+	highlighted.highlight_revision = 1;
+	REQUIRE(cache.get(highlighted) == nullptr);
+	REQUIRE(cache.size() == 0);
+
+	auto second_highlighted = second;
+	second_highlighted.highlight_revision = 1;
+	REQUIRE(cache.get(second_highlighted) == nullptr);
+}
+
+TEST_CASE("update_revision() makes entries usable for the item's new revision",
+	"[ItemRenderCache]")
+{
+	ItemRenderCache cache(1024 * 1024);
+	const auto key = make_key("guid");
+	auto source = key;
+	source.source = true;
+	cache.put(key, make_entry("text"));
+	cache.put(source, make_entry("source"));
+
+	auto updated = key;
+	updated.revision = 2;
+	auto updated_source = source;
+	updated_source.revision = 2;
+
+	SECTION("entries of the old revision are moved")
+	{
+		cache.update_revision("guid", 1, 2);
+
+		REQUIRE(cache.get(updated) != nullptr);
+		REQUIRE(cache.get(updated_source) != nullptr);
+		REQUIRE(cache.get(key) == nullptr);
+	}
+
+	SECTION("entries of other revisions are left alone")
+	{
+		cache.update_revision("guid", 3, 4);
+
+		REQUIRE(cache.get(key) != nullptr);
+		REQUIRE(cache.get(updated) == nullptr);
+	}
+}
+
+TEST_CASE("ItemRenderCache stays within its budget by dropping least "
+	"recently used entries",
+	"[ItemRenderCache]")
+{
+	const std::string text(10000, 'x');
+	ItemRenderCache cache(35000);
+
+	cache.put(make_key("1"), make_entry(text));
+	cache.put(make_key("2"), make_entry(text));
+	cache.put(make_key("3"), make_entry(text));
+	REQUIRE(cache.get(make_key("1")) != nullptr);
+
+	cache.put(make_key("4"), make_entry(text));
+
+	REQUIRE(cache.size() <= 35000);
+	REQUIRE(cache.get(make_key("1")) != nullptr);
+	REQUIRE(cache.get(make_key("2")) == nullptr);
+	REQUIRE(cache.get(make_key("4")) != nullptr);
+
+	SECTION("entries larger than the budget aren't kept at all")
+	{
+		cache.put(make_key("5"), make_entry(std::string(40000, 'x')));
+
+		REQUIRE(cache.get(make_key("5")) == nullptr);
+		REQUIRE(cache.get(make_key("1")) != nullptr);
+	}
+}
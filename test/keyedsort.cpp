@@ -0,0 +1,91 @@
+#include "keyedsort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "3rd-party/catch.hpp"
+
+using namespace newsboat;
+
+namespace {
+
+/* (key, original position) pairs with lots of equal keys, so that stability
+ * shows */
+std::vector<std::pair<std::string, unsigned int>> make_elements(size_t count)
+{
+	std::vector<std::pair<std::string, unsigned int>> elements;
+	unsigned int state = 12345;
+	for (size_t i = 0; i < count; ++i) {
+		state = state * 1103515245 + 12345;
+		elements.emplace_back(std::to_string((state >> 16) % 100), i);
+	}
+	return elements;
+}
+
+} // anonymous namespace
+
+TEST_CASE("keyed_stable_sort() sorts the same way std::stable_sort() does",
+	"[keyed_stable_sort]")
+{
+	typedef std::pair<std::string, unsigned int> Element;
+
+	size_t count = 0;
+
+	SECTION("empty vector")
+	{
+		count = 0;
+	}
+
+	SECTION("a few elements")
+	{
+		count = 100;
+	}
+
+	SECTION("enough elements to sort on several threads")
+	{
+		count = parallel_sort_threshold * 3 + 7;
+	}
+
+	auto elements = make_elements(count);
+	auto expected = elements;
+	std::stable_sort(expected.begin(),
+		expected.end(),
+		[](const Element& a, const Element& b) {
+			return a.first < b.first;
+		});
+
+	keyed_stable_sort(elements,
+		[](const Element& e) {
+			return e.first;
+		},
+		[](const std::string& a, const std::string& b) {
+			return a < b;
+		});
+
+	REQUIRE(elements == expected);
+}
+
+TEST_CASE("keyed_stable_sort() computes each key only once",
+	"[keyed_stable_sort]")
+{
+	std::vector<unsigned int> numbers;
+	for (unsigned int i = 0; i < 1000; ++i) {
+		numbers.push_back((i * 7919) % 1000);
+	}
+
+	std::atomic<unsigned int> keys_computed(0);
+	keyed_stable_sort(numbers,
+		[&](unsigned int n) {
+			++keys_computed;
+			return n;
+		},
+		[](unsigned int a, unsigned int b) {
+			return a < b;
+		});
+
+	REQUIRE(keys_computed == 1000);
+	REQUIRE(std::is_sorted(numbers.begin(), numbers.end()));
+}
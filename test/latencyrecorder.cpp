@@ -0,0 +1,44 @@
+#include "latencyrecorder.h"
+
+#include "3rd-party/catch.hpp"
+
+using namespace newsboat;
+
+using std::chrono::microseconds;
+
+TEST_CASE("LatencyRecorder computes nearest-rank percentiles",
+	"[LatencyRecorder]")
+{
+	LatencyRecorder recorder;
+
+	REQUIRE(recorder.percentile(50) == microseconds(0));
+
+	for (int i = 100; i >= 1; --i) {
+		recorder.add(microseconds(i * 1000));
+	}
+
+	REQUIRE(recorder.count() == 100);
+	REQUIRE(recorder.percentile(0) == microseconds(1000));
+	REQUIRE(recorder.percentile(50) == microseconds(50000));
+	REQUIRE(recorder.percentile(90) == microseconds(90000));
+	REQUIRE(recorder.percentile(99) == microseconds(99000));
+	REQUIRE(recorder.percentile(100) == microseconds(100000));
+	REQUIRE(recorder.summary() ==
+		"p50 50.0 ms, p90 90.0 ms, p99 99.0 ms, max 100.0 ms "
+		"(100 samples)");
+}
+
+TEST_CASE("LatencyRecorder only keeps the most recent samples",
+	"[LatencyRecorder]")
+{
+	LatencyRecorder recorder(3);
+
+	recorder.add(microseconds(1000000));
+	recorder.add(microseconds(1));
+	recorder.add(microseconds(2));
+	recorder.add(microseconds(3));
+
+	REQUIRE(recorder.count() == 4);
+	REQUIRE(recorder.percentile(100) == microseconds(3));
+	REQUIRE(recorder.percentile(0) == microseconds(1));
+}
@@ -125,3 +125,62 @@ TEST_CASE("format_list() uses regex manager if one is passed",
 
 	REQUIRE(fmt.format_list(&rxmgr, "article") == expected);
 }
+
+TEST_CASE("format_line() returns a single item of format_list()",
+	"[ListFormatter]")
+{
+	ListFormatter fmt;
+
+	fmt.add_line("", 7);
+	fmt.add_line("Highlight me please!", 8);
+	fmt.add_line("no id");
+
+	RegexManager rxmgr;
+	rxmgr.handle_action(
+		"highlight", {"article", "please", "green", "default"});
+
+	REQUIRE(fmt.format_line(0, &rxmgr, "article") ==
+		"{listitem[7] text:\"\"}");
+	REQUIRE(fmt.format_line(1, &rxmgr, "article") ==
+		"{listitem[8] text:\"Highlight me <0>please</>!\"}");
+	REQUIRE(fmt.format_line(2) == "{listitem text:\"no id\"}");
+
+	REQUIRE(fmt.format_list(&rxmgr, "article") ==
+		"{list" + fmt.format_line(0, &rxmgr, "article") +
+		fmt.format_line(1, &rxmgr, "article") +
+		fmt.format_line(2, &rxmgr, "article") + "}");
+}
+
+TEST_CASE("add_line() splits a 100 KB line into lines of the given width",
+	"[ListFormatter]")
+{
+	std::string text;
+	for (unsigned int i = 0; text.length() < 100 * 1024; ++i) {
+		text += "0123456789"[i % 10];
+	}
+
+	ListFormatter fmt;
+	fmt.add_line(text, 1, 80);
+
+	std::string expected = "{list";
+	for (size_t i = 0; i < text.length(); i += 80) {
+		expected += "{listitem[1] text:\"" + text.substr(i, 80) + "\"}";
+	}
+	expected += "}";
+	REQUIRE(fmt.get_lines_count() == (text.length() + 79) / 80);
+	REQUIRE(fmt.format_list() == expected);
+}
+
+TEST_CASE("add_line() doesn't count STFL tags towards the width",
+	"[ListFormatter]")
+{
+	ListFormatter fmt;
+	fmt.add_line("<unread>abc<>def</>", UINT_MAX, 4);
+
+	const std::string expected =
+		"{list"
+		"{listitem text:\"<unread>abc<>\"}"
+		"{listitem text:\"def</>\"}"
+		"}";
+	REQUIRE(fmt.format_list() == expected);
+}
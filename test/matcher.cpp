@@ -1,8 +1,15 @@
 #include "matcher.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "3rd-party/catch.hpp"
 
+#include "cache.h"
+#include "configcontainer.h"
 #include "exceptions.h"
+#include "rss.h"
 
 using namespace newsboat;
 
@@ -235,3 +242,413 @@ TEST_CASE("get_expression() returns previously parsed expression", "[Matcher]")
 	Matcher m2("AAAA between 1:30000");
 	REQUIRE(m2.get_expression() == "AAAA between 1:30000");
 }
+
+TEST_CASE("Numeric literals are parsed like stream extraction would",
+	"[Matcher]")
+{
+	testMatchable mock;
+	Matcher m;
+
+	// a literal that isn't a number is zero
+	m.parse("AAAA > \"abc\"");
+	REQUIRE(m.matches(&mock));
+
+	// parsing stops at the first non-digit
+	m.parse("AAAA < \"12346abc\"");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("AAAA > \"-5\"");
+	REQUIRE(m.matches(&mock));
+
+	// out-of-range values are clamped
+	m.parse("AAAA < \"99999999999999999999\"");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("AAAA between \"-99999999999999999999\":\"12345\"");
+	REQUIRE(m.matches(&mock));
+}
+
+struct NumericMatchable : public testMatchable {
+	bool has_attribute(const std::string& attribname) override
+	{
+		return attribname == "age" ||
+			testMatchable::has_attribute(attribname);
+	}
+
+	std::string get_attribute(const std::string& attribname) override
+	{
+		if (attribname == "age")
+			return "not a number";
+		return testMatchable::get_attribute(attribname);
+	}
+
+	bool get_numeric_attribute_id(AttributeId id, long& value) override
+	{
+		if (id == AttributeId::AGE) {
+			value = 42;
+			return true;
+		}
+		return false;
+	}
+};
+
+TEST_CASE("Numeric comparisons use get_numeric_attribute_id() if available",
+	"[Matcher]")
+{
+	NumericMatchable mock;
+	Matcher m;
+
+	m.parse("age = \"not a number\"");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("age > 41 and age < 43");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("age between 40:50");
+	REQUIRE(m.matches(&mock));
+
+	// attributes the matchable doesn't provide numerically are still
+	// parsed from their string value
+	m.parse("AAAA between 12345:12345");
+	REQUIRE(m.matches(&mock));
+}
+
+TEST_CASE("`and` and `or` evaluate their right operand only if needed",
+	"[Matcher]")
+{
+	testMatchable mock;
+	Matcher m;
+
+	// BBBB doesn't exist, so evaluating it would throw
+	m.parse("abcd = \"uiop\" and BBBB = \"x\"");
+	REQUIRE_FALSE(m.matches(&mock));
+
+	m.parse("abcd = \"xyz\" or BBBB = \"x\"");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("(abcd = \"uiop\" and BBBB = \"x\") or AAAA = \"12345\"");
+	REQUIRE(m.matches(&mock));
+
+	m.parse("abcd = \"xyz\" and (AAAA = \"0\" or BBBB = \"x\")");
+	REQUIRE_THROWS_AS(m.matches(&mock), MatcherException);
+}
+
+struct IndexedMatchable : public Matchable {
+	explicit IndexedMatchable(int i)
+		: index(i)
+	{
+	}
+
+	bool has_attribute(const std::string& attribname) override
+	{
+		// a few items lack one of the attributes
+		return (attribname == "index" && index % 6000 != 5999) ||
+			(attribname == "broken" && index % 6000 != 2999);
+	}
+
+	std::string get_attribute(const std::string& attribname) override
+	{
+		return attribname == "index" ? std::to_string(index) : "";
+	}
+
+	int index;
+};
+
+TEST_CASE("matches_all() returns the same results as matches() in a loop",
+	"[Matcher]")
+{
+	std::vector<IndexedMatchable> storage;
+	for (int i = 0; i < 20000; ++i) {
+		storage.emplace_back(i);
+	}
+	std::vector<Matchable*> items;
+	for (auto& item : storage) {
+		items.push_back(&item);
+	}
+
+	SECTION("results are in the order of the items")
+	{
+		// items ending in 9 might lack "index"
+		items.erase(std::remove_if(items.begin(),
+				    items.end(),
+				    [](Matchable* item) {
+					    return item->get_attribute("index")
+							   .back() == '9';
+				    }),
+			items.end());
+		Matcher m("index =~ \"7$\" or index between 12000:12010");
+		const std::vector<bool> results = m.matches_all(items);
+		REQUIRE(results.size() == items.size());
+		for (size_t i = 0; i < items.size(); ++i) {
+			INFO(i);
+			REQUIRE(results[i] == m.matches(items[i]));
+		}
+	}
+
+	SECTION("the exception for the first failing item is rethrown")
+	{
+		// items ending in 3 skip the "broken" test
+		Matcher m("index =~ \"3$\" or broken = \"\"");
+		const auto error_for = [&](const std::vector<Matchable*>& v) {
+			try {
+				m.matches_all(v);
+			} catch (const MatcherException& e) {
+				return std::string(e.what());
+			}
+			return std::string();
+		};
+		const std::string broken_error = error_for({items[2999]});
+		const std::string index_error = error_for({items[5999]});
+		REQUIRE_FALSE(broken_error.empty());
+		REQUIRE_FALSE(index_error.empty());
+		REQUIRE(broken_error != index_error);
+
+		// items 5999, 8999, 11999 and 17999 fail
+		std::vector<Matchable*> tail(items.begin() + 3000, items.end());
+		REQUIRE(error_for(tail) == index_error);
+		tail.erase(tail.begin() + 2999);
+		REQUIRE(error_for(tail) == broken_error);
+
+		// only the items ending in 3 can be checked
+		std::vector<Matchable*> checkable;
+		for (size_t i = 3; i < items.size(); i += 10) {
+			checkable.push_back(items[i]);
+		}
+		const std::vector<bool> results = m.matches_all(checkable);
+		REQUIRE(std::count(results.begin(), results.end(), true) ==
+			static_cast<long>(checkable.size()));
+	}
+
+	SECTION("an empty list of items yields an empty result")
+	{
+		Matcher m("index = \"1\"");
+		REQUIRE(m.matches_all({}).empty());
+	}
+}
+
+struct RevisionedMatchable : public Matchable {
+	bool has_attribute(const std::string& attribname) override
+	{
+		return attribname == "title" || attribname == "age";
+	}
+
+	std::string get_attribute(const std::string& attribname) override
+	{
+		++lookups;
+		return attribname == "title" ? title : "1";
+	}
+
+	bool get_revision(unsigned long& r) override
+	{
+		r = revision;
+		return true;
+	}
+
+	std::string title = "foo";
+	unsigned long revision = 1;
+	unsigned int lookups = 0;
+};
+
+TEST_CASE("Matcher remembers results until the item's revision changes",
+	"[Matcher]")
+{
+	RevisionedMatchable item;
+	std::vector<Matchable*> items = {&item};
+
+	SECTION("results are reused while the revision stays the same")
+	{
+		Matcher m("title = \"foo\"");
+		REQUIRE(m.matches(&item));
+		REQUIRE(m.matches(&item));
+		REQUIRE(m.matches_all(items) == std::vector<bool>({true}));
+		REQUIRE(item.lookups == 1);
+
+		item.title = "bar";
+		REQUIRE(m.matches(&item));
+
+		item.revision = 2;
+		REQUIRE_FALSE(m.matches(&item));
+		REQUIRE(m.matches_all(items) == std::vector<bool>({false}));
+		REQUIRE(item.lookups == 2);
+	}
+
+	SECTION("parsing another expression forgets the results")
+	{
+		Matcher m("title = \"foo\"");
+		REQUIRE(m.matches(&item));
+		m.parse("title = \"bar\"");
+		REQUIRE_FALSE(m.matches(&item));
+		REQUIRE(item.lookups == 2);
+	}
+
+	SECTION("expressions using time-dependent attributes aren't cached")
+	{
+		Matcher m("title = \"foo\" and age = \"1\"");
+		REQUIRE(m.matches(&item));
+		REQUIRE(m.matches(&item));
+		REQUIRE(item.lookups == 4);
+	}
+
+	SECTION("items without a revision aren't cached")
+	{
+		testMatchable mock;
+		Matcher m("abcd = \"xyz\"");
+		REQUIRE(m.matches(&mock));
+		REQUIRE(m.matches_all({&mock}) == std::vector<bool>({true}));
+	}
+}
+
+TEST_CASE("RssItem's revision changes with each of its attributes",
+	"[Matcher]")
+{
+	RssItem item(nullptr);
+	unsigned long last = item.revision();
+	const auto changed = [&]() {
+		const bool result = item.revision() != last;
+		last = item.revision();
+		return result;
+	};
+
+	item.set_title("title");
+	REQUIRE(changed());
+	item.set_link("http://example.com/");
+	REQUIRE(changed());
+	item.set_author("author");
+	REQUIRE(changed());
+	item.set_description("content");
+	REQUIRE(changed());
+	item.set_pubDate(42);
+	REQUIRE(changed());
+	item.set_guid("guid");
+	REQUIRE(changed());
+	item.set_unread_nowrite(false);
+	REQUIRE(changed());
+	item.set_enclosure_url("http://example.com/a.mp3");
+	REQUIRE(changed());
+	item.set_enclosure_type("audio/mpeg");
+	REQUIRE(changed());
+	item.set_flags("a");
+	REQUIRE(changed());
+	item.set_deleted(true);
+	REQUIRE(changed());
+	item.unload();
+	REQUIRE(changed());
+
+	item.set_index(3);
+	REQUIRE_FALSE(changed());
+}
+
+TEST_CASE("to_sql() only translates expressions it can express in SQL",
+	"[Matcher]")
+{
+	Matcher m;
+	std::string condition;
+
+	SECTION("supported expressions")
+	{
+		const std::vector<std::string> supported = {
+			"unread = \"yes\"",
+			"link != \"http://example.com/\"",
+			"guid = \"it's quoted\"",
+			"flags # \"s\"",
+			"enclosure_type !# \"audio/mpeg\"",
+			"age < 3",
+			"age between 1:7",
+			"unread = \"no\" and (age >= 3 or flags = \"\")",
+		};
+		for (const auto& expr : supported) {
+			INFO(expr);
+			REQUIRE(m.parse(expr));
+			REQUIRE(m.to_sql(condition));
+		}
+	}
+
+	SECTION("unsupported expressions")
+	{
+		const std::vector<std::string> unsupported = {
+			"link =~ \"example\"",
+			"content = \"\"",
+			"date = \"Mon, 01 Jan 2018\"",
+			"guid < 3",
+			"articleindex = \"1\"",
+			"feedtitle = \"Example\"",
+			"abcd = \"xyz\"",
+			"unread = \"yes\" and tags # \"news\"",
+		};
+		for (const auto& expr : unsupported) {
+			INFO(expr);
+			REQUIRE(m.parse(expr));
+			REQUIRE_FALSE(m.to_sql(condition));
+		}
+	}
+
+	SECTION("literals are quoted")
+	{
+		REQUIRE(m.parse("guid = \"it's\""));
+		REQUIRE(m.to_sql(condition));
+		REQUIRE(condition == "(guid = 'it''s')");
+	}
+}
+
+TEST_CASE("Filtering 100k items", "[.][benchmark][Matcher]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_title("Example feed");
+	feed->set_rssurl("https://example.com/feed.xml");
+	feed->set_tags({"news", "tech"});
+
+	const time_t now = time(nullptr);
+	std::vector<std::shared_ptr<RssItem>> items;
+	for (int i = 0; i < 100000; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_title("Item number " + std::to_string(i));
+		item->set_author(i % 3 == 0 ? "John Doe" : "Jane Roe");
+		item->set_link("https://example.com/" + std::to_string(i));
+		item->set_pubDate(now - (i % 100) * 86400);
+		item->set_unread_nowrite(i % 2 == 0);
+		item->set_feedptr(feed);
+		items.push_back(item);
+	}
+
+	Matcher m(
+		"unread = \"yes\" and age between 0:30 and "
+		"(title =~ \"number 1\" or author = \"John Doe\") and "
+		"tags # \"tech\" and feedtitle != \"Other feed\"");
+
+	unsigned int count = 0;
+	BENCHMARK("Matcher::matches() on RssItems")
+	{
+		for (const auto& item : items) {
+			if (m.matches(item.get())) {
+				++count;
+			}
+		}
+	}
+	REQUIRE(count > 0);
+
+	std::vector<Matchable*> matchables;
+	for (const auto& item : items) {
+		matchables.push_back(item.get());
+	}
+	unsigned int parallel_count = 0;
+	BENCHMARK("Matcher::matches_all() on RssItems")
+	{
+		const auto results = m.matches_all(matchables);
+		parallel_count +=
+			std::count(results.begin(), results.end(), true);
+	}
+	REQUIRE(parallel_count == count);
+
+	Matcher item_only("unread = \"yes\" and "
+		"(title =~ \"number 1\" or author = \"John Doe\")");
+	const auto expected = item_only.matches_all(matchables);
+	std::vector<bool> remembered;
+	BENCHMARK("Matcher::matches_all() on unchanged RssItems")
+	{
+		remembered = item_only.matches_all(matchables);
+	}
+	REQUIRE(remembered == expected);
+}
@@ -0,0 +1,135 @@
+#include "processpool.h"
+
+#include <chrono>
+#include <sys/stat.h>
+#include <thread>
+
+#include "3rd-party/catch.hpp"
+#include "test-helpers.h"
+
+using namespace newsboat;
+
+TEST_CASE("run() collects output and exit status", "[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(0);
+
+	auto result = pool.run({"echo", "hello", "world"});
+	REQUIRE(result.output == "hello world\n");
+	REQUIRE(result.exit_status == 0);
+	REQUIRE_FALSE(result.timed_out);
+
+	result = pool.run_shell("exit 3");
+	REQUIRE(result.output == "");
+	REQUIRE(result.exit_status == 3);
+}
+
+TEST_CASE("run_shell() passes input to the command", "[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(0);
+
+	SECTION("small input")
+	{
+		REQUIRE(pool.run_shell("tr a-z A-Z", "hello").output == "HELLO");
+	}
+
+	SECTION("input larger than the pipe buffer")
+	{
+		const std::string input(1024 * 1024, 'x');
+		REQUIRE(pool.run_shell("cat", input).output == input);
+	}
+}
+
+TEST_CASE("run() returns empty result if command can't be started",
+	"[ProcessPool]")
+{
+	const auto result = ProcessPool::getInstance().run(
+		{"a-program-that-is-guaranteed-to-not-exists"});
+	REQUIRE(result.output == "");
+	REQUIRE(result.exit_status != 0);
+}
+
+TEST_CASE("run_in_background() doesn't wait for the command to finish",
+	"[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(0);
+	TestHelpers::TempFile marker;
+
+	const auto start = std::chrono::steady_clock::now();
+	pool.run_in_background(
+		{"/bin/sh", "-c", "sleep 1; touch \"$0\"", marker.getPath()});
+	REQUIRE(std::chrono::steady_clock::now() - start <
+		std::chrono::seconds(1));
+
+	struct stat sb;
+	const auto deadline = start + std::chrono::seconds(10);
+	while (::stat(marker.getPath().c_str(), &sb) != 0 &&
+		std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	REQUIRE(::stat(marker.getPath().c_str(), &sb) == 0);
+}
+
+TEST_CASE("shutdown() kills running commands and waits for the workers",
+	"[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(0);
+
+	pool.run_in_background({"/bin/sh", "-c", "sleep 30 & wait"});
+	// give the worker a moment to start it
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	const auto start = std::chrono::steady_clock::now();
+	pool.shutdown();
+	REQUIRE(std::chrono::steady_clock::now() - start <
+		std::chrono::seconds(10));
+
+	// the pool can be used again afterwards
+	REQUIRE(pool.run({"echo", "again"}).output == "again\n");
+}
+
+TEST_CASE("Commands that run for too long are killed", "[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(1);
+
+	const auto start = std::chrono::steady_clock::now();
+	// the background job keeps stdout open, so killing just the shell
+	// wouldn't be enough
+	const auto result = pool.run_shell("echo started; sleep 30 & wait");
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	REQUIRE(result.timed_out);
+	REQUIRE(result.output == "started\n");
+	REQUIRE(elapsed < std::chrono::seconds(10));
+
+	pool.set_timeout(0);
+}
+
+TEST_CASE("run_shell() picks up the result of prefetch_shell()",
+	"[ProcessPool]")
+{
+	auto& pool = ProcessPool::getInstance();
+	pool.set_timeout(0);
+	pool.set_max_processes(4);
+
+	const std::string cmd = "echo $$";
+	pool.prefetch_shell(cmd);
+	const auto prefetched = pool.run_shell(cmd).output;
+	REQUIRE(prefetched != "");
+
+	// the prefetched result is only used once
+	REQUIRE(pool.run_shell(cmd).output != prefetched);
+
+	SECTION("discarded results aren't used")
+	{
+		pool.prefetch_shell(cmd);
+		pool.discard_prefetched();
+		REQUIRE(pool.run_shell(cmd).output != "");
+	}
+
+	pool.set_max_processes(1);
+}
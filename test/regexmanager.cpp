@@ -144,3 +144,93 @@ TEST_CASE("RegexManager does not hang on regexes that match empty strings", "[Re
 		REQUIRE(input == compare);
 	}
 }
+
+TEST_CASE("RegexManager numbers highlights by rule among many rules",
+	"[RegexManager]")
+{
+	RegexManager rxman;
+	for (int i = 0; i < 20; ++i) {
+		rxman.handle_action("highlight",
+			{"articlelist", "word" + std::to_string(i) + "x", "red"});
+	}
+
+	std::string input = "a word14x and a word3x";
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "a <14>word14x</> and a <3>word3x</>");
+
+	input = "a word14x";
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "a <14>word14x</>");
+
+	input = "no words";
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "no words");
+}
+
+TEST_CASE("RegexManager applies later rules to text highlighted by earlier ones",
+	"[RegexManager]")
+{
+	RegexManager rxman;
+	rxman.handle_action("highlight", {"feedlist", "foo", "red"});
+	for (int i = 1; i < 12; ++i) {
+		rxman.handle_action("highlight",
+			{"feedlist", "unused" + std::to_string(i), "red"});
+	}
+	// doesn't match the input, only the markers inserted for "foo"
+	rxman.handle_action("highlight", {"feedlist", "0", "red"});
+
+	std::string input = "<1>foo";
+	rxman.quote_and_highlight(input, "feedlist");
+	REQUIRE(input == "<1><<12>0</><1>>foo</><1>");
+
+	input = "foo";
+	rxman.quote_and_highlight(input, "feedlist");
+	REQUIRE(input == "<<12>0</><0>>foo</>");
+}
+
+TEST_CASE("RegexManager doesn't count `highlight-article` rules when numbering "
+	"highlights",
+	"[RegexManager]")
+{
+	RegexManager rxman;
+	rxman.handle_action("highlight", {"articlelist", "foo", "red"});
+	rxman.handle_action(
+		"highlight-article", {"title = \"x\"", "blue", "default"});
+	rxman.handle_action("highlight", {"articlelist", "ba(r)\\1", "red"});
+	rxman.handle_action("highlight", {"articlelist", "baz", "red"});
+
+	std::string input = "barr baz";
+	rxman.quote_and_highlight(input, "articlelist");
+	REQUIRE(input == "<1>barr</> <2>baz</><1>");
+}
+
+TEST_CASE("Highlighting 10k article list lines with 60 rules",
+	"[.][benchmark][RegexManager]")
+{
+	RegexManager rxman;
+	for (int i = 0; i < 60; ++i) {
+		rxman.handle_action("highlight",
+			{"articlelist",
+				"(keyword" + std::to_string(i) + "|tag" +
+				std::to_string(i) + ")",
+				"red"});
+	}
+
+	std::vector<std::string> lines;
+	for (int i = 0; i < 10000; ++i) {
+		std::string line = "   " + std::to_string(i) +
+			" N  Jan 01   Example feed   Article number " +
+			std::to_string(i);
+		if (i % 10 == 0) {
+			line += " about keyword" + std::to_string(i % 60);
+		}
+		lines.push_back(line);
+	}
+
+	BENCHMARK("RegexManager::quote_and_highlight()")
+	{
+		for (auto line : lines) {
+			rxman.quote_and_highlight(line, "articlelist");
+		}
+	}
+}
@@ -1,6 +1,9 @@
 #include "rss.h"
 #include "rsspp.h"
 
+#include <algorithm>
+#include <clocale>
+
 #include "3rd-party/catch.hpp"
 #include "cache.h"
 #include "configcontainer.h"
@@ -674,6 +677,71 @@ TEST_CASE(
 	REQUIRE_FALSE(ignores.matches_resetunread("www.smth.com"));
 }
 
+TEST_CASE(
+	"RssIgnores::rules_for() returns wildcard and feed-specific rules "
+	"in the order they were defined",
+	"[rss]")
+{
+	RssIgnores ignores;
+	ignores.handle_action("ignore-article", {"*", "title = \"a\""});
+	ignores.handle_action(
+		"ignore-article", {"http://example.com/", "title = \"b\""});
+	ignores.handle_action("ignore-article", {"*", "content = \"c\""});
+	ignores.handle_action(
+		"ignore-article", {"http://example.org/", "title = \"d\""});
+
+	const auto expressions = [&](const std::string& url) {
+		std::vector<std::string> result;
+		for (const auto& rule : ignores.rules_for(url)) {
+			result.push_back(rule->get_expression());
+		}
+		return result;
+	};
+
+	REQUIRE(expressions("http://example.com/") ==
+		std::vector<std::string>({"title = \"a\"",
+			"title = \"b\"",
+			"content = \"c\""}));
+	REQUIRE(expressions("http://example.org/") ==
+		std::vector<std::string>({"title = \"a\"",
+			"content = \"c\"",
+			"title = \"d\""}));
+	REQUIRE(expressions("http://example.net/") ==
+		std::vector<std::string>({"title = \"a\"", "content = \"c\""}));
+
+	const std::string url = "http://example.net/";
+	REQUIRE(ignores.uses_attribute(url, AttributeId::CONTENT));
+	REQUIRE_FALSE(ignores.uses_attribute(url, AttributeId::LINK));
+}
+
+TEST_CASE("RssParser drops items that match ignore rules", "[rss::RssParser]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssIgnores ign;
+
+	SECTION("rules that don't look at the content")
+	{
+		ign.handle_action("ignore-article",
+			{"file://data/rss.xml", "title =~ \"^(Kurios|Teh)\""});
+	}
+
+	SECTION("rules that look at the content")
+	{
+		ign.handle_action("ignore-article",
+			{"*", "content =~ \"Maroni|image-upload-15-\""});
+	}
+
+	RssParser p("file://data/rss.xml", &rsscache, &cfg, &ign, nullptr);
+	const auto feed = p.parse();
+	REQUIRE(feed->total_item_count() == 6);
+	for (const auto& item : feed->items()) {
+		REQUIRE(item->title() != "Teh Saxxi");
+		REQUIRE(item->title() != "Kurios");
+		REQUIRE_FALSE(item->description_raw().empty());
+	}
+}
+
 TEST_CASE("If item's <title> is empty, try to deduce it from the URL",
 	"[rss::RssParser]")
 {
@@ -694,6 +762,60 @@ TEST_CASE("If item's <title> is empty, try to deduce it from the URL",
 	REQUIRE(feed->items()[4]->title() == "Alternate link isn't first");
 }
 
+TEST_CASE("Items get a GUID even if the feed doesn't provide one",
+	"[rss::RssParser]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	RssParser p("file://data/rss20_without_guids.xml",
+		&rsscache,
+		&cfg,
+		nullptr,
+		nullptr);
+	auto feed = p.parse();
+	REQUIRE(feed->items().size() == 2);
+
+	const auto first = feed->items()[0];
+	REQUIRE(first->guid() == "Only a title");
+	REQUIRE(first->title() == "Only a title");
+	REQUIRE(first->description() == "First description");
+
+	const auto second = feed->items()[1];
+	REQUIRE(second->guid() == "http://example.com/second");
+	REQUIRE(second->title() == "Title and link");
+	REQUIRE(second->link() == "http://example.com/second");
+	REQUIRE(second->description() == "Second description");
+	REQUIRE(second->enclosure_url() == "http://example.com/second.mp3");
+	REQUIRE(second->enclosure_type() == "audio/mpeg");
+}
+
+TEST_CASE("exec: feeds aren't parsed again if script output didn't change",
+	"[rss::RssParser]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+	const std::string url = "exec:cat data/rss.xml";
+
+	RssParser p1(url, &rsscache, &cfg, nullptr, nullptr);
+	auto feed = p1.parse();
+	REQUIRE(feed->total_item_count() == 8);
+	rsscache.externalize_rssfeed(feed, false);
+	// the fingerprint is only stored once the feed is in the cache
+	RssParser p2(url, &rsscache, &cfg, nullptr, nullptr);
+	REQUIRE(p2.parse()->total_item_count() == 8);
+
+	RssParser p3(url, &rsscache, &cfg, nullptr, nullptr);
+	REQUIRE(p3.parse()->total_item_count() == 0);
+
+	SECTION("always-download rules bypass the check")
+	{
+		RssIgnores ign;
+		ign.handle_action("always-download", {url});
+		RssParser p4(url, &rsscache, &cfg, &ign, nullptr);
+		REQUIRE(p4.parse()->total_item_count() == 8);
+	}
+}
+
 TEST_CASE(
 	"RssFeed::is_query_feed() return true if feed is a query feed, i.e. "
 	"its \"rssurl\" starts with \"query:\" string",
@@ -714,4 +836,413 @@ TEST_CASE(
 	REQUIRE(f.is_query_feed());
 }
 
+TEST_CASE("RssFeed::search_items() returns every match of a query feed, in "
+	"the feed's order",
+	"[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_rssurl("http://example.com/feed.xml");
+	for (int i = 0; i < 300; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid("guid-" + std::to_string(i));
+		item->set_title(i % 2 == 0 ? "needle" : "haystack");
+		item->set_feedurl(feed->rssurl());
+		feed->add_item(item);
+	}
+	rsscache.externalize_rssfeed(feed, false);
+
+	// more matches than the first page of search results holds
+	RssFeed query_feed(&rsscache);
+	query_feed.set_rssurl("query:Everything:unread = \"yes\"");
+	const auto& items = feed->items();
+	for (auto it = items.rbegin(); it != items.rend(); ++it) {
+		query_feed.add_item(*it);
+	}
+	query_feed.items()[1]->set_deleted(true);
+
+	const auto found = query_feed.search_items("needle");
+	REQUIRE(found.size() == 149);
+	REQUIRE(found.front()->guid() == "guid-296");
+	REQUIRE(found.back()->guid() == "guid-0");
+	for (unsigned int i = 1; i < found.size(); ++i) {
+		REQUIRE(found[i - 1]->guid() ==
+			"guid-" + std::to_string(298 - 2 * i));
+	}
+}
+
+TEST_CASE("RssItem provides its own attributes and those of its feed",
+	"[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_title("Feed title");
+	feed->set_tags({"foo", "bar"});
+
+	auto item = std::make_shared<RssItem>(&rsscache);
+	item->set_title("Item title");
+	item->set_index(7);
+	item->set_pubDate(time(nullptr) - 3 * 86400 - 60);
+	feed->add_item(item);
+
+	REQUIRE(item->has_attribute("title"));
+	REQUIRE(item->get_attribute("title") == "Item title");
+	REQUIRE(item->get_attribute("age") == "3");
+	REQUIRE(item->get_attribute("articleindex") == "7");
+
+	long value = 0;
+	REQUIRE(item->get_numeric_attribute_id(AttributeId::AGE, value));
+	REQUIRE(value == 3);
+	REQUIRE_FALSE(
+		item->get_numeric_attribute_id(AttributeId::TITLE, value));
+
+	REQUIRE_FALSE(item->has_attribute("feedtitle"));
+	REQUIRE_FALSE(item->has_attribute("no-such-attribute"));
+	REQUIRE(item->get_attribute("feedtitle") == "");
+
+	item->set_feedptr(feed);
+	REQUIRE(item->has_attribute("feedtitle"));
+	REQUIRE(item->get_attribute("feedtitle") == "Feed title");
+	REQUIRE(item->get_attribute("tags") == "foo bar ");
+	REQUIRE(item->get_numeric_attribute_id(
+		AttributeId::TOTAL_COUNT, value));
+	REQUIRE(value == 1);
+	REQUIRE_FALSE(item->has_attribute("no-such-attribute"));
+	REQUIRE(item->get_attribute("no-such-attribute") == "");
+}
+
+namespace {
+
+/* Only provides attributes as strings, like Matchables that don't implement
+ * attribute_contains(). */
+struct StringMatchable : public Matchable {
+	explicit StringMatchable(Matchable* m)
+		: m(m)
+	{
+	}
+	bool has_attribute(const std::string& attribname) override
+	{
+		return m->has_attribute(attribname);
+	}
+	std::string get_attribute(const std::string& attribname) override
+	{
+		return m->get_attribute(attribname);
+	}
+	Matchable* m;
+};
+
+} // anonymous namespace
+
+TEST_CASE("`#` finds the same words in tags and flags as in their "
+	"string representation",
+	"[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_tags({"foo bar", "~Renamed", "!hidden", "baz"});
+	auto item = std::make_shared<RssItem>(&rsscache);
+	item->set_flags("ba");
+	feed->add_item(item);
+	StringMatchable feed_string(feed.get());
+	StringMatchable item_string(item.get());
+
+	const std::vector<std::string> tokens = {"foo",
+			"bar",
+			"baz",
+			"foo bar",
+			"Renamed",
+			"~Renamed",
+			"hidden",
+			"!hidden",
+			"ba",
+			"ab",
+			"a",
+			""
+		};
+
+	for (const auto& token : tokens) {
+		INFO("token: \"" << token << "\"");
+		bool contains = false;
+
+		REQUIRE(feed->attribute_contains(
+				AttributeId::TAGS, token, contains));
+		Matcher tags_matcher("tags # \"" + token + "\"");
+		REQUIRE(tags_matcher.matches(&feed_string) == contains);
+		REQUIRE(tags_matcher.matches(feed.get()) == contains);
+
+		REQUIRE(item->attribute_contains(
+				AttributeId::FLAGS, token, contains));
+		Matcher flags_matcher("flags # \"" + token + "\"");
+		REQUIRE(flags_matcher.matches(&item_string) == contains);
+		REQUIRE(flags_matcher.matches(item.get()) == contains);
+
+		// without a feed, items fall back to the string comparison
+		REQUIRE_FALSE(item->attribute_contains(
+				AttributeId::TAGS, token, contains));
+	}
+
+	bool contains = false;
+	REQUIRE(feed->attribute_contains(AttributeId::TAGS, "foo", contains));
+	REQUIRE(contains);
+	REQUIRE(feed->attribute_contains(
+			AttributeId::TAGS, "Renamed", contains));
+	REQUIRE_FALSE(contains);
+	REQUIRE_FALSE(
+		feed->attribute_contains(AttributeId::TITLE, "foo", contains));
+
+	REQUIRE(item->attribute_contains(AttributeId::FLAGS, "ab", contains));
+	REQUIRE(contains);
+	REQUIRE(item->attribute_contains(AttributeId::FLAGS, "a", contains));
+	REQUIRE_FALSE(contains);
+
+	item->set_feedptr(feed);
+	REQUIRE(item->attribute_contains(AttributeId::TAGS, "bar", contains));
+	REQUIRE(contains);
+	Matcher m("tags # \"bar\" and flags # \"ab\"");
+	REQUIRE(m.matches(item.get()));
+
+	feed->set_tags({"qux"});
+	REQUIRE_FALSE(m.matches(item.get()));
+}
+
+namespace {
+
+std::shared_ptr<RssFeed> make_feed(Cache* rsscache,
+	const std::string& url,
+	const std::vector<std::string>& titles)
+{
+	auto feed = std::make_shared<RssFeed>(rsscache);
+	feed->set_rssurl(url);
+	for (const auto& title : titles) {
+		auto item = std::make_shared<RssItem>(rsscache);
+		item->set_title(title);
+		item->set_guid(url + "/" + title);
+		item->set_feedptr(feed);
+		feed->add_item(item);
+	}
+	return feed;
+}
+
+std::vector<std::string> titles_of(std::shared_ptr<RssFeed> feed)
+{
+	std::vector<std::string> titles;
+	for (const auto& item : feed->items()) {
+		titles.push_back(item->title());
+	}
+	return titles;
+}
+
+} // anonymous namespace
+
+TEST_CASE("update_items() keeps query feeds up to date incrementally",
+	"[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto first = make_feed(&rsscache, "http://first", {"a", "b", "c"});
+	auto second = make_feed(&rsscache, "http://second", {"d", "e"});
+
+	auto query = std::make_shared<RssFeed>(&rsscache);
+	query->set_rssurl("query:Unread:unread = \"yes\"");
+	std::vector<std::shared_ptr<RssFeed>> feeds{first, second, query};
+
+	const ArticleSortStrategy by_title{
+		ArtSortMethod::TITLE, SortDirection::ASC};
+	query->update_items(feeds);
+	query->sort(by_title);
+	REQUIRE(titles_of(query) ==
+		std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+	SECTION("items whose unread status changed are matched again")
+	{
+		first->items()[1]->set_unread_nowrite(false);
+		second->items()[0]->set_unread_nowrite(false);
+		query->update_items(feeds);
+		REQUIRE(titles_of(query) ==
+			std::vector<std::string>{"a", "c", "e"});
+
+		first->items()[1]->set_unread_nowrite(true);
+		query->update_items(feeds);
+		REQUIRE(titles_of(query) ==
+			std::vector<std::string>{"a", "b", "c", "e"});
+	}
+
+	SECTION("items of replaced feeds are matched again")
+	{
+		feeds[1] = make_feed(&rsscache, "http://second", {"f", "bb"});
+		query->update_items(feeds);
+		REQUIRE(titles_of(query) ==
+			std::vector<std::string>{"a", "b", "bb", "c", "f"});
+	}
+
+	SECTION("items of removed feeds disappear")
+	{
+		feeds.erase(feeds.begin());
+		query->update_items(feeds);
+		REQUIRE(titles_of(query) == std::vector<std::string>{"d", "e"});
+	}
+
+	SECTION("items added to a feed are matched")
+	{
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_title("ab");
+		item->set_guid("http://first/ab");
+		item->set_feedptr(first);
+		first->add_item(item);
+		query->update_items(feeds);
+		REQUIRE(titles_of(query) ==
+			std::vector<std::string>{"a", "ab", "b", "c", "d", "e"});
+	}
+
+	SECTION("changing the query starts from scratch")
+	{
+		query->set_rssurl("query:Unread:title =~ \"^[bd]\"");
+		query->update_items(feeds);
+		query->sort(by_title);
+		REQUIRE(titles_of(query) == std::vector<std::string>{"b", "d"});
+	}
+}
+
+TEST_CASE("update_items() notices changes to flags", "[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = make_feed(&rsscache, "http://feed", {"a", "b", "c"});
+	auto query = std::make_shared<RssFeed>(&rsscache);
+	query->set_rssurl("query:Starred:flags =~ \"s\"");
+	std::vector<std::shared_ptr<RssFeed>> feeds{feed, query};
+
+	query->update_items(feeds);
+	REQUIRE(query->total_item_count() == 0);
+
+	feed->items()[2]->set_flags("s");
+	query->update_items(feeds);
+	REQUIRE(titles_of(query) == std::vector<std::string>{"c"});
+
+	feed->items()[2]->set_flags("");
+	query->update_items(feeds);
+	REQUIRE(query->total_item_count() == 0);
+}
+
+TEST_CASE("update_items() re-evaluates time-dependent queries every time",
+	"[rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = make_feed(&rsscache, "http://feed", {"old", "new"});
+	feed->items()[0]->set_pubDate(time(nullptr) - 10 * 86400);
+	feed->items()[1]->set_pubDate(time(nullptr) - 3600);
+	auto query = std::make_shared<RssFeed>(&rsscache);
+	query->set_rssurl("query:Recent:age < 2");
+	std::vector<std::shared_ptr<RssFeed>> feeds{feed, query};
+
+	query->update_items(feeds);
+	REQUIRE(titles_of(query) == std::vector<std::string>{"new"});
+
+	// nothing about the item changes except its age
+	feed->items()[1]->set_pubDate(time(nullptr) - 5 * 86400);
+	query->update_items(feeds);
+	REQUIRE(query->total_item_count() == 0);
+}
+
+TEST_CASE("Updating 20 query feeds over 150k items", "[.][benchmark][rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	std::vector<std::shared_ptr<RssFeed>> feeds;
+	for (int f = 0; f < 150; ++f) {
+		std::vector<std::string> titles;
+		for (int i = 0; i < 1000; ++i) {
+			titles.push_back("Item " + std::to_string(i));
+		}
+		auto feed = make_feed(
+			&rsscache, "http://feed/" + std::to_string(f), titles);
+		feed->set_tags({"tag" + std::to_string(f % 10)});
+		feeds.push_back(feed);
+	}
+	for (int q = 0; q < 20; ++q) {
+		auto query = std::make_shared<RssFeed>(&rsscache);
+		query->set_rssurl("query:Q" + std::to_string(q) +
+			":unread = \"yes\" and tags # \"tag" +
+			std::to_string(q % 10) + "\"");
+		feeds.push_back(query);
+	}
+
+	const auto update_all = [&]() {
+		for (const auto& feed : feeds) {
+			if (feed->is_query_feed()) {
+				feed->update_items(feeds);
+			}
+		}
+	};
+
+	BENCHMARK("from scratch")
+	{
+		update_all();
+	}
+
+	BENCHMARK("after one item changed")
+	{
+		feeds[3]->items()[10]->set_unread_nowrite(
+			!feeds[3]->items()[10]->unread());
+		update_all();
+	}
+
+	BENCHMARK("after one feed was replaced")
+	{
+		std::vector<std::string> titles;
+		for (int i = 0; i < 1000; ++i) {
+			titles.push_back("New item " + std::to_string(i));
+		}
+		feeds[7] = make_feed(&rsscache, "http://feed/7", titles);
+		feeds[7]->set_tags({"tag7"});
+		update_all();
+	}
+}
+
+TEST_CASE("Sorting 50k items by title", "[.][benchmark][rss]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	std::vector<std::shared_ptr<RssItem>> items;
+	for (int i = 0; i < 50000; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		std::string title =
+			"Item number " + std::to_string((i * 7919) % 50000);
+		if (i % 10 == 0) {
+			title += " \xe2\x80\x94 caf\xc3\xa9";
+		}
+		item->set_title(title);
+		items.push_back(item);
+	}
+
+	// make title() convert from UTF-8 to a non-UTF-8 locale charset
+	const std::string old_locale = setlocale(LC_CTYPE, nullptr);
+	setlocale(LC_CTYPE, "C");
+
+	BENCHMARK("std::sort() comparing title()")
+	{
+		auto sorted = items;
+		std::sort(sorted.begin(),
+			sorted.end(),
+			[](const std::shared_ptr<RssItem>& a,
+				const std::shared_ptr<RssItem>& b) {
+				return a->title() < b->title();
+			});
+	}
+
+	setlocale(LC_CTYPE, old_locale.c_str());
+}
+
 } // namespace newsboat
@@ -0,0 +1,267 @@
+#include "searchresultloader.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "3rd-party/catch.hpp"
+#include "cache.h"
+#include "configcontainer.h"
+#include "rss.h"
+
+using namespace newsboat;
+
+namespace {
+
+typedef std::vector<std::shared_ptr<RssItem>> Items;
+
+/* a search over `count` results, numbered from zero */
+Items fake_search(SearchPosition& position, unsigned int limit, int count)
+{
+	Items items;
+	int next = position.started ? position.id + 1 : 0;
+	for (; next < count && (limit == 0 || items.size() < limit); ++next) {
+		auto item = std::make_shared<RssItem>(nullptr);
+		item->set_guid(std::to_string(next));
+		items.push_back(item);
+		position.started = true;
+		position.id = next;
+	}
+	position.done = next >= count;
+	return items;
+}
+
+/* takes results until the loader is done */
+Items take_all(SearchResultLoader& loader, Items items)
+{
+	while (loader.running()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	loader.take(items);
+	return items;
+}
+
+} // anonymous namespace
+
+TEST_CASE("SearchResultLoader returns the first page right away and the rest "
+	"later",
+	"[SearchResultLoader]")
+{
+	SearchResultLoader loader(
+		[](SearchPosition& position, unsigned int limit) {
+			return fake_search(position, limit, 1234);
+		},
+		0,
+		10,
+		100);
+
+	const Items first = loader.start();
+	REQUIRE(first.size() == 10);
+	REQUIRE(first.front()->guid() == "0");
+
+	const Items all = take_all(loader, first);
+	REQUIRE(all.size() == 1234);
+	for (unsigned int i = 0; i < all.size(); ++i) {
+		REQUIRE(all[i]->guid() == std::to_string(i));
+	}
+	REQUIRE(loader.count() == 1234);
+	REQUIRE_FALSE(loader.truncated());
+	REQUIRE_FALSE(loader.cancelled());
+	REQUIRE(loader.error().empty());
+}
+
+TEST_CASE("SearchResultLoader doesn't start a thread if the first page has all "
+	"results",
+	"[SearchResultLoader]")
+{
+	SearchResultLoader loader(
+		[](SearchPosition& position, unsigned int limit) {
+			return fake_search(position, limit, 5);
+		},
+		0,
+		10,
+		100);
+
+	REQUIRE(loader.start().size() == 5);
+	REQUIRE_FALSE(loader.running());
+}
+
+TEST_CASE("SearchResultLoader keeps a first page that has more results than "
+	"asked for if it's the last one",
+	"[SearchResultLoader]")
+{
+	// like a query feed, which is searched in memory all at once
+	SearchResultLoader loader(
+		[](SearchPosition& position, unsigned int) {
+			return fake_search(position, 0, 150);
+		},
+		0,
+		100,
+		500);
+
+	const Items all = loader.start();
+	REQUIRE(all.size() == 150);
+	REQUIRE(all.back()->guid() == "149");
+	REQUIRE_FALSE(loader.running());
+	REQUIRE_FALSE(loader.truncated());
+	REQUIRE(loader.count() == 150);
+}
+
+TEST_CASE("SearchResultLoader stops at the maximum number of results",
+	"[SearchResultLoader]")
+{
+	SECTION("within the first page")
+	{
+		SearchResultLoader loader(
+			[](SearchPosition& position, unsigned int limit) {
+				return fake_search(position, limit, 1000);
+			},
+			7,
+			10,
+			100);
+
+		REQUIRE(loader.start().size() == 7);
+		REQUIRE_FALSE(loader.running());
+		REQUIRE(loader.truncated());
+	}
+
+	SECTION("within a later page")
+	{
+		SearchResultLoader loader(
+			[](SearchPosition& position, unsigned int limit) {
+				return fake_search(position, limit, 1000);
+			},
+			250,
+			10,
+			100);
+
+		const Items all = take_all(loader, loader.start());
+		REQUIRE(all.size() == 250);
+		REQUIRE(all.back()->guid() == "249");
+		REQUIRE(loader.truncated());
+	}
+
+	SECTION("exactly at the last result")
+	{
+		SearchResultLoader loader(
+			[](SearchPosition& position, unsigned int limit) {
+				return fake_search(position, limit, 10);
+			},
+			10,
+			10,
+			100);
+
+		REQUIRE(loader.start().size() == 10);
+		REQUIRE_FALSE(loader.running());
+		REQUIRE_FALSE(loader.truncated());
+	}
+}
+
+TEST_CASE("SearchResultLoader stops after the current page when cancelled",
+	"[SearchResultLoader]")
+{
+	std::mutex mtx;
+	std::condition_variable cv;
+	unsigned int pages = 0;
+	bool proceed = false;
+
+	SearchResultLoader loader(
+		[&](SearchPosition& position, unsigned int limit) {
+			std::unique_lock<std::mutex> lock(mtx);
+			if (++pages == 2) {
+				// hold the first background page until the
+				// test has cancelled
+				cv.notify_all();
+				cv.wait(lock, [&]() {
+					return proceed;
+				});
+			}
+			return fake_search(position, limit, 1000);
+		},
+		0,
+		10,
+		10);
+
+	REQUIRE(loader.start().size() == 10);
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cv.wait(lock, [&]() {
+			return pages == 2;
+		});
+		REQUIRE(loader.running());
+		loader.cancel();
+		proceed = true;
+	}
+	cv.notify_all();
+
+	const Items rest = take_all(loader, Items());
+	REQUIRE(rest.empty());
+	REQUIRE(loader.cancelled());
+	REQUIRE(loader.count() == 10);
+	REQUIRE(pages == 2);
+}
+
+TEST_CASE("SearchResultLoader ends the search if a later page fails",
+	"[SearchResultLoader]")
+{
+	SearchResultLoader loader(
+		[](SearchPosition& position, unsigned int limit) {
+			if (position.started) {
+				throw std::runtime_error("disk on fire");
+			}
+			return fake_search(position, limit, 1000);
+		},
+		0,
+		10,
+		100);
+
+	REQUIRE(loader.start().size() == 10);
+	take_all(loader, Items());
+	REQUIRE(loader.error() == "disk on fire");
+	REQUIRE(loader.count() == 10);
+}
+
+TEST_CASE("SearchResultLoader pages through a search of the cache in order",
+	"[SearchResultLoader]")
+{
+	ConfigContainer cfg;
+	Cache rsscache(":memory:", &cfg);
+
+	auto feed = std::make_shared<RssFeed>(&rsscache);
+	feed->set_rssurl("http://example.com/feed.xml");
+	for (int i = 0; i < 300; ++i) {
+		auto item = std::make_shared<RssItem>(&rsscache);
+		item->set_guid("guid-" + std::to_string(i));
+		item->set_title(i % 3 == 0 ? "needle" : "haystack");
+		item->set_feedurl(feed->rssurl());
+		// several articles share each date, so that pages have to
+		// break ties by id
+		item->set_pubDate(1000 + i / 7);
+		feed->add_item(item);
+	}
+	rsscache.externalize_rssfeed(feed, false);
+
+	const Items expected = rsscache.search_for_items("needle", "");
+	REQUIRE(expected.size() == 100);
+
+	SearchResultLoader loader(
+		[&](SearchPosition& position, unsigned int limit) {
+			return rsscache.search_for_items(
+				"needle", "", position, limit);
+		},
+		0,
+		3,
+		7);
+
+	const Items all = take_all(loader, loader.start());
+	REQUIRE(all.size() == expected.size());
+	for (unsigned int i = 0; i < all.size(); ++i) {
+		REQUIRE(all[i]->guid() == expected[i]->guid());
+	}
+	for (unsigned int i = 1; i < all.size(); ++i) {
+		REQUIRE(all[i - 1]->pubDate_timestamp() >=
+			all[i]->pubDate_timestamp());
+	}
+}
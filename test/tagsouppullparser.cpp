@@ -106,3 +106,26 @@ TEST_CASE("<br>, <br/> and <br /> behave the same way", "[TagSoupPullParser]")
 		}
 	}
 }
+
+TEST_CASE("Parsing a string gives the same events as parsing a stream",
+	"[TagSoupPullParser]")
+{
+	const std::string input =
+		"<p class=\"x\">a &amp; b &bogus; c & d</p>"
+		"<img src='foo.png' alt=bar>"
+		"<unterminated";
+
+	std::istringstream input_stream(input);
+	TagSoupPullParser from_stream;
+	from_stream.set_input(input_stream);
+
+	TagSoupPullParser from_string;
+	from_string.set_input(input);
+
+	TagSoupPullParser::Event e;
+	do {
+		e = from_string.next();
+		REQUIRE(from_stream.next() == e);
+		REQUIRE(from_string.get_text() == from_stream.get_text());
+	} while (e != TagSoupPullParser::Event::END_DOCUMENT);
+}
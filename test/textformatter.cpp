@@ -257,3 +257,45 @@ TEST_CASE(
 		REQUIRE(result.second == expected_count);
 	}
 }
+
+TEST_CASE("A 100 KB line is wrapped into lines of the given width",
+	"[TextFormatter]")
+{
+	std::string word;
+	for (unsigned int i = 0; word.length() < 100 * 1024; ++i) {
+		word += "0123456789"[i % 10];
+	}
+
+	SECTION("One long word")
+	{
+		TextFormatter fmt;
+		fmt.add_line(LineType::wrappable, word);
+		fmt.add_line(LineType::softwrappable, word);
+
+		std::string expected;
+		for (size_t i = 0; i < word.length(); i += 80) {
+			expected += word.substr(i, 80) + "\n";
+		}
+		for (size_t i = 0; i < word.length(); i += 100) {
+			expected += word.substr(i, 100) + "\n";
+		}
+		REQUIRE(fmt.format_text_plain(80, 100) == expected);
+	}
+
+	SECTION("Words of double-width characters")
+	{
+		std::string line;
+		std::string expected;
+		for (unsigned int i = 0; line.length() < 100 * 1024; ++i) {
+			// three words of 9 characters, 18 columns each
+			const std::string w = "あいうえお"
+					      "かきくけ";
+			line += w + " " + w + " " + w + " ";
+			expected += w + " " + w + " " + w + " \n";
+		}
+
+		TextFormatter fmt;
+		fmt.add_line(LineType::wrappable, line);
+		REQUIRE(fmt.format_text_plain(60) == expected);
+	}
+}
@@ -0,0 +1,77 @@
+#include "uiupdatequeue.h"
+
+#include "3rd-party/catch.hpp"
+
+using namespace newsboat;
+
+namespace {
+
+const std::chrono::milliseconds frame(50);
+
+} // anonymous namespace
+
+TEST_CASE("UiUpdateQueue coalesces posts into a single set of updates",
+	"[UiUpdateQueue]")
+{
+	UiUpdateQueue queue(frame);
+	UiUpdateQueue::Updates updates;
+
+	REQUIRE_FALSE(queue.take(updates));
+
+	queue.post_status("Loading 1...");
+	queue.post_redraw();
+	queue.post_status("Loading 2...");
+
+	REQUIRE(queue.take(updates));
+	REQUIRE(updates.has_status);
+	REQUIRE(updates.status == "Loading 2...");
+	REQUIRE(updates.posts == 3);
+
+	REQUIRE_FALSE(queue.take(updates));
+
+	SECTION("a redraw alone doesn't change the status")
+	{
+		queue.post_redraw();
+
+		REQUIRE(queue.take(updates));
+		REQUIRE_FALSE(updates.has_status);
+		REQUIRE(updates.posts == 1);
+	}
+}
+
+TEST_CASE("UiUpdateQueue lets a frame be drawn at most once a frame interval",
+	"[UiUpdateQueue]")
+{
+	UiUpdateQueue queue(frame);
+	const auto start = UiUpdateQueue::Clock::now();
+
+	REQUIRE_FALSE(queue.frame_due(start));
+
+	queue.post_status("hello");
+	REQUIRE(queue.frame_due(start));
+
+	queue.frame_drawn(start);
+	REQUIRE_FALSE(queue.frame_due(start + frame / 2));
+	REQUIRE(queue.frame_due(start + frame));
+
+	UiUpdateQueue::Updates updates;
+	queue.take(updates);
+	REQUIRE_FALSE(queue.frame_due(start + frame * 2));
+}
+
+TEST_CASE("UiUpdateQueue is busy for a while after something was posted",
+	"[UiUpdateQueue]")
+{
+	UiUpdateQueue queue(frame);
+
+	REQUIRE_FALSE(queue.busy(UiUpdateQueue::Clock::now()));
+
+	queue.post_redraw();
+	REQUIRE(queue.busy(UiUpdateQueue::Clock::now()));
+
+	UiUpdateQueue::Updates updates;
+	queue.take(updates);
+	REQUIRE(queue.busy(UiUpdateQueue::Clock::now()));
+	REQUIRE_FALSE(queue.busy(
+		UiUpdateQueue::Clock::now() + std::chrono::seconds(2)));
+}
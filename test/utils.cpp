@@ -616,6 +616,45 @@ TEST_CASE(
 	}
 }
 
+TEST_CASE("fit_width() measures like substr_with_width() from any position",
+	"[utils]")
+{
+	const std::vector<std::string> inputs = {"abc",
+		"A\u3042B\u3044C\u3046",
+		"ＡＢＣ<b>ＤＥ</b>Ｆ",
+		"a<<xyz>>bcd",
+		"a</>b</>c</>",
+		"a<>b<>c",
+		"\x01\x02"
+		"abc"};
+	for (const auto& input : inputs) {
+		// substr_with_width() always returns "" for a width of zero,
+		// even if there are zero-width characters to take
+		for (size_t max_width = 1; max_width < 12; ++max_width) {
+			size_t width = 0;
+			const size_t length =
+				utils::fit_width(input, 0, max_width, width);
+			REQUIRE(input.substr(0, length) ==
+				utils::substr_with_width(input, max_width));
+			REQUIRE(width <= max_width);
+		}
+	}
+
+	SECTION("starts at the given position and adds to the width")
+	{
+		size_t width = 5;
+		REQUIRE(utils::fit_width("abc\u3042\u3044", 2, 9, width) == 4);
+		REQUIRE(width == 8);
+	}
+
+	SECTION("keeps an unterminated tag")
+	{
+		size_t width = 0;
+		REQUIRE(utils::fit_width("ab<cd", 0, 2, width) == 5);
+		REQUIRE(width == 2);
+	}
+}
+
 TEST_CASE("getcwd() returns current directory of the process", "[utils]")
 {
 	SECTION("Returns non-empty string")
@@ -802,3 +841,75 @@ TEST_CASE(
 				== "");
 	}
 }
+
+TEST_CASE("content_digest() is stable and differs for different inputs",
+	"[utils]")
+{
+	REQUIRE(utils::content_digest("") == "0-cbf29ce484222325");
+	REQUIRE(utils::content_digest("a") == "1-af63dc4c8601ec8c");
+	REQUIRE(utils::content_digest("<rss/>") ==
+		utils::content_digest("<rss/>"));
+	REQUIRE(utils::content_digest("<rss/>") !=
+		utils::content_digest("<rss />"));
+}
+
+TEST_CASE("convert_text() converts text between charsets", "[utils]")
+{
+	const std::string utf8 = "Gr\xc3\xbc\xc3\x9f Gott";
+	const std::string latin1 = "Gr\xfc\xdf Gott";
+
+	REQUIRE(utils::convert_text(utf8, "ISO-8859-1", "utf-8") == latin1);
+	REQUIRE(utils::convert_text(latin1, "utf-8", "ISO-8859-1") == utf8);
+
+	SECTION("output longer than the internal buffer")
+	{
+		std::string input;
+		for (int i = 0; i < 10000; ++i) {
+			input.append("\xe9");
+		}
+		const auto output =
+			utils::convert_text(input, "utf-8", "ISO-8859-1");
+		REQUIRE(output.length() == 20000);
+		REQUIRE(utils::convert_text(output, "ISO-8859-1", "utf-8") == input);
+	}
+}
+
+TEST_CASE("convert_text() returns ASCII and valid UTF-8 text unchanged",
+	"[utils]")
+{
+	const std::string ascii = "Hello, world! 0123456789 ~";
+	REQUIRE(utils::convert_text(ascii, "ISO-8859-1", "utf-8") == ascii);
+	REQUIRE(utils::convert_text(ascii, "ANSI_X3.4-1968", "utf-8") == ascii);
+	REQUIRE(utils::convert_text(ascii, "utf-8", "KOI8-R") == ascii);
+
+	const std::string utf8 = "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 "
+		"\xe2\x82\xac \xf0\x9f\x98\x80";
+	REQUIRE(utils::convert_text(utf8, "UTF-8", "utf8") == utf8);
+}
+
+TEST_CASE("convert_text() replaces invalid input with question marks",
+	"[utils]")
+{
+	REQUIRE(utils::convert_text("a\xff" "b", "UTF-8", "utf8") == "a?b");
+	REQUIRE(utils::convert_text("a\xed\xa0\x80" "b", "UTF-8", "utf8") ==
+		"a???b");
+	REQUIRE(utils::convert_text("\xc3", "ISO-8859-1", "utf-8") == "?");
+
+	// the descriptor is reused, so leftovers of the previous conversion
+	// mustn't leak into the next one
+	REQUIRE(utils::convert_text("\xc3\xa9", "ISO-8859-1", "utf-8") ==
+		"\xe9");
+}
+
+TEST_CASE("convert_text() stops at the first NUL byte", "[utils]")
+{
+	const std::string input("ab\0cd", 5);
+	REQUIRE(utils::convert_text(input, "ISO-8859-1", "utf-8") == "ab");
+}
+
+TEST_CASE("convert_text() returns empty string for unknown charsets",
+	"[utils]")
+{
+	REQUIRE(utils::convert_text("\xc3\xa9", "no-such-charset", "utf-8") ==
+		"");
+}